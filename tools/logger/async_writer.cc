@@ -0,0 +1,404 @@
+/**
+ *  @file
+ *  \brief     AsyncWriter class implementation
+ *  \details   Holds implementation of the background log writer
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "async_writer.h"
+#include "call_site.h"
+#include "record_codec.h"
+// third-party
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+
+/// number of records ring can hold, must be a power of two
+const size_t RingCapacity = 4096;
+
+/// period writer thread wakes up at if no record is pushed
+const int WriterPeriodMs = 20;
+
+/// size of output buffer which triggers writing even if ring is not empty yet
+const size_t MaxBatchSize = 64 * 1024;
+
+/// default log file size limit
+const size_t DefaultMaxFileSize = 16 * 1024 * 1024; // 16Mb
+
+/// default number of rotated log files to keep
+const int DefaultMaxBackupFiles = 3;
+
+/**
+ * Helper function to build name of the rotated log file
+ * @param fileName - log file name
+ * @param index - index of the backup, starting from 1
+ * @returns - backup file name
+ */
+std::string GetBackupFileName(const std::string& fileName, const int index)
+{
+   return fileName + "." + boost::lexical_cast<std::string>(index);
+}
+
+/**
+ * Helper function to detect format of the existing log file by its first entry
+ * @param fileName - log file name
+ * @param format - out parameter, format of the file
+ * @returns - false if file doesn't exist or is empty
+ */
+bool GetFileFormat(const std::string& fileName, logger::OutputFormat& format)
+{
+   using namespace logger::codec;
+
+   std::ifstream file(fileName.c_str(), std::ios_base::binary);
+   char head[1 + sizeof(FileMagic)];
+   file.read(head, sizeof(head));
+   if (file.gcount() <= 0)
+      return false;
+
+   bool binary = file.gcount() == sizeof(head) && head[0] == EntryHeader &&
+         std::equal(FileMagic, FileMagic + sizeof(FileMagic), head + 1);
+   format = binary ? logger::BinaryFormat : logger::TextFormat;
+   return true;
+}
+
+/// flag to create the process-wide writer once
+boost::once_flag InstanceFlag = BOOST_ONCE_INIT;
+
+} // unnamed namespace
+
+namespace logger
+{
+
+AsyncWriter* AsyncWriter::m_instance = 0;
+
+AsyncWriter& AsyncWriter::GetInstance()
+{
+   boost::call_once(InstanceFlag, &AsyncWriter::CreateInstance);
+   return *m_instance;
+}
+
+void AsyncWriter::CreateInstance()
+{
+   m_instance = new AsyncWriter();
+   std::atexit(&AsyncWriter::Shutdown);
+}
+
+void AsyncWriter::Shutdown()
+{
+   {
+      LOCK lock(m_instance->m_guard);
+      m_instance->m_stopRequested = true;
+      m_instance->m_wakeUpCondition.notify_one();
+   }
+   m_instance->m_writerThread->join();
+}
+
+AsyncWriter::AsyncWriter()
+   : m_ring(RingCapacity)
+   , m_droppedRecords(0)
+   , m_writerIdle(false)
+   , m_writtenSiteTableSize(0)
+   , m_timeBase(codec::GetTimeBase())
+   , m_activeFormat(TextFormat)
+   , m_activeConsoleOutput(true)
+   , m_writtenPosition(0)
+   , m_stopRequested(false)
+   , m_fileName("application.log")
+   , m_maxFileSize(DefaultMaxFileSize)
+   , m_maxBackupFiles(DefaultMaxBackupFiles)
+   , m_consoleOutput(true)
+   , m_outputFormat(TextFormat)
+   , m_openedFormat(TextFormat)
+   , m_fileSize(0)
+{
+   m_outputBuffer.reserve(MaxBatchSize * 2);
+   m_writerThread.reset( new boost::thread(boost::bind(&AsyncWriter::WriteRecords, this)) );
+}
+
+void AsyncWriter::Push(const char* data, const size_t length)
+{
+   if (!m_ring.TryPush(data, length))
+   {
+      m_droppedRecords.fetch_add(1, boost::memory_order_relaxed);
+      return;
+   }
+
+   // pairs with the fence in WriteRecords: either the writer sees the record before
+   // it waits, or the record sees the writer idle
+   boost::atomic_thread_fence(boost::memory_order_seq_cst);
+   if (m_writerIdle.load(boost::memory_order_relaxed) &&
+       m_writerIdle.exchange(false, boost::memory_order_relaxed))
+   {
+      LOCK lock(m_guard);
+      m_wakeUpCondition.notify_one();
+   }
+}
+
+void AsyncWriter::Flush()
+{
+   size_t targetPosition = m_ring.GetEnqueuePosition();
+
+   boost::unique_lock<boost::mutex> lock(m_guard);
+   m_wakeUpCondition.notify_one();
+   while (m_writtenPosition < targetPosition && !m_stopRequested)
+      m_flushCondition.wait(lock);
+}
+
+void AsyncWriter::SetFileName(const std::string& fileName)
+{
+   LOCK lock(m_guard);
+   m_fileName = fileName;
+}
+
+void AsyncWriter::SetRotation(const size_t maxFileSize, const int maxBackupFiles)
+{
+   LOCK lock(m_guard);
+   m_maxFileSize = maxFileSize;
+   m_maxBackupFiles = maxBackupFiles;
+}
+
+void AsyncWriter::SetConsoleOutput(const bool enabled)
+{
+   LOCK lock(m_guard);
+   m_consoleOutput = enabled;
+}
+
+void AsyncWriter::SetOutputFormat(const OutputFormat format)
+{
+   LOCK lock(m_guard);
+   m_outputFormat = format;
+}
+
+void AsyncWriter::WriteRecords()
+{
+   bool stopRequested = false;
+   while (true)
+   {
+      const char* data;
+      int length;
+      if (!m_ring.Front(data, length))
+      {
+         boost::unique_lock<boost::mutex> lock(m_guard);
+         if (stopRequested)
+            break;
+         if (!m_stopRequested)
+         {
+            // producer takes m_guard to notify, so wake-up can't come before the wait
+            m_writerIdle.store(true, boost::memory_order_relaxed);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (!m_ring.Front(data, length))
+               m_wakeUpCondition.timed_wait(lock, boost::posix_time::milliseconds(WriterPeriodMs));
+            m_writerIdle.store(false, boost::memory_order_relaxed);
+         }
+         // make one more pass over the ring once stop is requested
+         stopRequested = m_stopRequested;
+      }
+
+      CollectRecords();
+      WriteBatch();
+
+      LOCK lock(m_guard);
+      m_writtenPosition = m_ring.GetDequeuePosition();
+      m_flushCondition.notify_all();
+   }
+
+   if (m_file.is_open())
+      m_file.close();
+}
+
+void AsyncWriter::CollectRecords()
+{
+   {
+      LOCK lock(m_guard);
+      m_activeFormat = m_outputFormat;
+      m_activeConsoleOutput = m_consoleOutput;
+   }
+
+   size_t droppedRecords = m_droppedRecords.exchange(0, boost::memory_order_relaxed);
+   if (droppedRecords)
+   {
+      // report as record without call site, so it fits any output format
+      std::string message = "logger: " + boost::lexical_cast<std::string>(droppedRecords)
+         + " records dropped";
+      codec::RecordHeader header;
+      header.siteId = 0;
+      header.threadId = 0;
+      header.timestamp = codec::GetTimestamp();
+
+      std::string record;
+      codec::AppendBinary(record, header);
+      record += (char)codec::ArgString;
+      codec::AppendBinaryString(record, message.c_str());
+      ProcessRecord(record.data(), record.size());
+   }
+
+   const char* data;
+   int length;
+   while (m_ring.Front(data, length))
+   {
+      ProcessRecord(data, length);
+      m_ring.Pop();
+
+      if (m_outputBuffer.size() >= MaxBatchSize || m_consoleBuffer.size() >= MaxBatchSize)
+         WriteBatch();
+   }
+}
+
+void AsyncWriter::ProcessRecord(const char* record, const size_t length)
+{
+   codec::RecordHeader header;
+   if (length < sizeof(header))
+      return;
+   ::memcpy(&header, record, sizeof(header));
+
+   const CallSite* site = header.siteId ? CallSite::Find(header.siteId) : 0;
+   LevelId level = site ? site->level : Empty;
+   const char* function = site ? site->function : 0;
+
+   if (m_activeFormat == BinaryFormat)
+   {
+      if (site)
+         WriteCallSite(site->id);
+
+      m_outputBuffer += (char)codec::EntryRecord;
+      codec::AppendBinary(m_outputBuffer, (boost::uint16_t)length);
+      m_outputBuffer.append(record, length);
+
+      if (m_activeConsoleOutput)
+      {
+         codec::FormatRecord(record, length, level, function, m_timeBase, m_consoleBuffer);
+         m_consoleBuffer += '\n';
+      }
+   }
+   else
+   {
+      codec::FormatRecord(record, length, level, function, m_timeBase, m_outputBuffer);
+      m_outputBuffer += '\n';
+   }
+}
+
+void AsyncWriter::WriteCallSite(const boost::uint32_t siteId)
+{
+   if (siteId < m_writtenSites.size() && m_writtenSites[siteId])
+      return;
+
+   const CallSite* site = CallSite::Find(siteId);
+   if (!site)
+      return;
+
+   if (siteId >= m_writtenSites.size())
+      m_writtenSites.resize(siteId + 1, false);
+   m_writtenSites[siteId] = true;
+
+   std::string entry;
+   entry += (char)codec::EntryCallSite;
+   codec::AppendBinary(entry, site->id);
+   codec::AppendBinary(entry, (boost::uint8_t)site->level);
+   codec::AppendBinary(entry, (boost::int32_t)site->line);
+   codec::AppendBinaryString(entry, site->file);
+   codec::AppendBinaryString(entry, site->function);
+
+   m_siteTable += entry;
+   m_outputBuffer += entry;
+}
+
+void AsyncWriter::WriteBatch()
+{
+   if (m_outputBuffer.empty() && m_consoleBuffer.empty())
+      return;
+
+   std::string fileName;
+   size_t maxFileSize;
+   int maxBackupFiles;
+   {
+      LOCK lock(m_guard);
+      fileName = m_fileName;
+      maxFileSize = m_maxFileSize;
+      maxBackupFiles = m_maxBackupFiles;
+   }
+
+   if (m_activeConsoleOutput)
+   {
+      const std::string& consoleOutput =
+            (m_activeFormat == BinaryFormat) ? m_consoleBuffer : m_outputBuffer;
+      std::cout.write(consoleOutput.data(), consoleOutput.size());
+      std::cout.flush();
+   }
+   m_consoleBuffer.clear();
+
+   if (m_file.is_open() && (fileName != m_openedFileName || m_activeFormat != m_openedFormat))
+      m_file.close();
+
+   bool newFile = false;
+   if (!m_file.is_open())
+   {
+      // decoder can't skip text entries, so a file is never continued in another format
+      OutputFormat fileFormat;
+      if (GetFileFormat(fileName, fileFormat) && fileFormat != m_activeFormat)
+         RotateFiles(fileName, maxBackupFiles);
+
+      m_file.clear();
+      m_file.open(fileName.c_str(), std::fstream::app | std::fstream::binary);
+      m_file.seekp(0, std::ios_base::end);
+      m_fileSize = m_file.good() ? (size_t)m_file.tellp() : 0;
+      m_openedFileName = fileName;
+      m_openedFormat = m_activeFormat;
+      newFile = true;
+   }
+
+   if (maxFileSize && m_fileSize && m_fileSize + m_outputBuffer.size() > maxFileSize)
+   {
+      m_file.close();
+      RotateFiles(fileName, maxBackupFiles);
+      m_file.clear();
+      m_file.open(fileName.c_str(), std::fstream::trunc | std::fstream::binary);
+      m_fileSize = 0;
+      newFile = true;
+   }
+
+   if (newFile && m_activeFormat == BinaryFormat)
+   {
+      // every binary file (or appended part of it) is self-contained: it starts with
+      // header and all call sites known before this batch, the batch carries the rest
+      std::string header(codec::FileMagic, sizeof(codec::FileMagic));
+      header.insert(header.begin(), (char)codec::EntryHeader);
+      codec::AppendBinary(header, m_timeBase);
+      header.append(m_siteTable, 0, m_writtenSiteTableSize);
+      m_outputBuffer.insert(0, header);
+   }
+   m_writtenSiteTableSize = m_siteTable.size();
+
+   if (m_file.good())
+   {
+      m_file.write(m_outputBuffer.data(), m_outputBuffer.size());
+      m_file.flush();
+      m_fileSize += m_outputBuffer.size();
+   }
+   m_outputBuffer.clear();
+}
+
+void AsyncWriter::RotateFiles(const std::string& fileName, const int maxBackupFiles)
+{
+   if (maxBackupFiles <= 0)
+   {
+      std::remove(fileName.c_str());
+      return;
+   }
+
+   std::remove(GetBackupFileName(fileName, maxBackupFiles).c_str());
+   for (int i = maxBackupFiles - 1; i > 0; --i)
+   {
+      std::rename(GetBackupFileName(fileName, i).c_str(),
+            GetBackupFileName(fileName, i + 1).c_str());
+   }
+   std::rename(fileName.c_str(), GetBackupFileName(fileName, 1).c_str());
+}
+
+} // namespace logger
@@ -0,0 +1,189 @@
+/**
+ *  @file
+ *  \brief     AsyncWriter class declaration
+ *  \details   Background writer which moves log records from the lock-free ring to the
+ *             console and log file in batches, formatting them into text or binary
+ *             log entries on the way
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef LOGGER_ASYNC_WRITER_H
+#define LOGGER_ASYNC_WRITER_H
+
+#include "record_ring.h"
+#include "log_level.h"
+#include "record_codec.h"
+// third-party
+#include <string>
+#include <vector>
+#include <fstream>
+#include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
+
+namespace logger
+{
+
+/**
+ * AsyncWriter class. Producers only copy formatted records into the ring, the single
+ * background thread drains it, writes records with buffered output and rotates the
+ * log file once it grows over the size limit.
+ */
+class AsyncWriter : public boost::noncopyable
+{
+public:
+
+   /**
+    * Accessor to the process-wide writer instance. Writer is created and its thread is
+    * started on first call. Instance is never destroyed, so it is safe to log from static
+    * destructors: pending records are written out and the thread is stopped at exit,
+    * records logged after that are dropped
+    * @returns - reference to the writer
+    */
+   static AsyncWriter& GetInstance();
+
+   /**
+    * Copies record into the ring, never waits for I/O. If the ring is full the record is
+    * dropped and counted, number of dropped records is reported in the log later on.
+    * The first record pushed after the writer has drained the ring wakes it up
+    * @param data - formatted record, without line end
+    * @param length - record length
+    */
+   void Push(const char* data, size_t length);
+
+   /**
+    * Blocks the call until every record pushed before this call is written out
+    */
+   void Flush();
+
+   /**
+    * Settings, can be changed at any point at runtime. Take effect with the next batch
+    */
+   void SetFileName(const std::string& fileName);
+   void SetRotation(size_t maxFileSize, int maxBackupFiles);
+   void SetConsoleOutput(bool enabled);
+   void SetOutputFormat(OutputFormat format);
+
+private:
+   typedef boost::lock_guard<boost::mutex> LOCK;
+
+   /**
+    * Constructor. Starts writer thread
+    */
+   AsyncWriter();
+
+   /**
+    * Creates the process-wide instance and registers Shutdown to be called at exit
+    */
+   static void CreateInstance();
+
+   /**
+    * Writes out all pending records and stops writer thread of the process-wide instance
+    */
+   static void Shutdown();
+
+   /**
+    * Writer thread main routine
+    */
+   void WriteRecords();
+
+   /**
+    * Moves all published records from the ring to the output buffers
+    */
+   void CollectRecords();
+
+   /**
+    * Converts single record to file and console output according to current format
+    * @param record - binary record, starting with codec::RecordHeader
+    * @param length - record length
+    */
+   void ProcessRecord(const char* record, size_t length);
+
+   /**
+    * Appends call site entry to the site table and to the output buffer, unless
+    * this call site has already been written
+    * @param siteId - id of the call site
+    */
+   void WriteCallSite(boost::uint32_t siteId);
+
+   /**
+    * Writes output buffer to console and file, rotates file if needed. Existing log
+    * file of another format is rotated before it is opened
+    */
+   void WriteBatch();
+
+   /**
+    * Renames current log file to backup and shifts older backups. Must be called
+    * with closed file
+    * @param fileName - name of the log file
+    * @param maxBackupFiles - number of rotated files to keep
+    */
+   static void RotateFiles(const std::string& fileName, int maxBackupFiles);
+
+   /// ring with records pushed by producers
+   RecordRing                       m_ring;
+   /// number of records dropped because the ring was full
+   boost::atomic<size_t>            m_droppedRecords;
+   /// flag that writer thread found the ring empty and is going to wait, cleared by
+   /// the producer which wakes it up
+   boost::atomic<bool>              m_writerIdle;
+   /// records collected from the ring and waiting to be written to the file
+   std::string                      m_outputBuffer;
+   /// records collected from the ring and waiting to be written to the console.
+   /// Used in binary format only, text format shares m_outputBuffer
+   std::string                      m_consoleBuffer;
+   /// binary entries of all call sites written so far, repeated at the start of every
+   /// binary file
+   std::string                      m_siteTable;
+   /// size of m_siteTable written out by previous batches. Entries above it are in
+   /// m_outputBuffer already, so they are not repeated in the header of a new file
+   size_t                           m_writtenSiteTableSize;
+   /// flags of call sites written to m_siteTable, indexed by call site id
+   std::vector<bool>                m_writtenSites;
+   /// parameters of timestamp conversion, used to format timestamps
+   const codec::TimeBase            m_timeBase;
+   /// format used in current pass over the ring. Touched by writer thread only
+   OutputFormat                     m_activeFormat;
+   /// console output flag used in current pass over the ring. Touched by writer thread only
+   bool                             m_activeConsoleOutput;
+
+   /// mutex to grant exclusive access to settings and writer state below
+   boost::mutex                     m_guard;
+   /// condition to wake up writer thread earlier than its period
+   boost::condition_variable        m_wakeUpCondition;
+   /// condition to notify Flush callers about progress of writer thread
+   boost::condition_variable        m_flushCondition;
+   /// ring position written out by the writer thread so far
+   size_t                           m_writtenPosition;
+   /// flag that writer thread stop has been requested
+   bool                             m_stopRequested;
+   /// log file name
+   std::string                      m_fileName;
+   /// size of the log file after which it is rotated, zero disables rotation
+   size_t                           m_maxFileSize;
+   /// number of rotated files to keep
+   int                              m_maxBackupFiles;
+   /// flag indicates if records are duplicated to stdout
+   bool                             m_consoleOutput;
+   /// log file format
+   OutputFormat                     m_outputFormat;
+
+   /// log file, kept open between batches. Touched by writer thread only
+   std::ofstream                    m_file;
+   /// name of the opened log file
+   std::string                      m_openedFileName;
+   /// format of the opened log file
+   OutputFormat                     m_openedFormat;
+   /// current log file size
+   size_t                           m_fileSize;
+
+   /// writer thread
+   boost::scoped_ptr<boost::thread> m_writerThread;
+
+   /// process-wide instance, see GetInstance
+   static AsyncWriter*              m_instance;
+};
+
+} // namespace logger
+
+#endif // LOGGER_ASYNC_WRITER_H
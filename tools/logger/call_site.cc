@@ -0,0 +1,129 @@
+/**
+ *  @file
+ *  \brief     CallSite class implementation
+ *  \details   Holds implementation of the CallSite class and process-wide call site registry
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "call_site.h"
+#include "record_codec.h"
+// third-party
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/once.hpp>
+
+namespace
+{
+
+typedef std::vector<const logger::CallSite*> CallSites;
+
+/// registry of call sites, index in the container equals call site id. Slot 0 is
+/// reserved
+struct Registry
+{
+   /// mutex to grant exclusive access to the registry
+   boost::mutex   guard;
+   /// registered call sites
+   CallSites      callSites;
+};
+
+/// process-wide registry. Never destroyed, as the writer thread looks call sites up
+/// until the very exit
+Registry* TheRegistry = 0;
+
+/// flag to create the registry once
+boost::once_flag RegistryFlag = BOOST_ONCE_INIT;
+
+/**
+ * Helper function to create the registry
+ */
+void CreateRegistry()
+{
+   TheRegistry = new Registry();
+   TheRegistry->callSites.push_back(0);
+}
+
+/**
+ * Helper function to access the registry of call sites
+ * @returns - reference to the registry
+ */
+Registry& GetRegistry()
+{
+   boost::call_once(RegistryFlag, &CreateRegistry);
+   return *TheRegistry;
+}
+
+/**
+ * Helper function to add call site to the registry
+ * @param site - call site to add
+ * @returns - id assigned to the call site
+ */
+boost::uint32_t Register(const logger::CallSite* site)
+{
+   Registry& registry = GetRegistry();
+   boost::lock_guard<boost::mutex> lock(registry.guard);
+   registry.callSites.push_back(site);
+   return (boost::uint32_t)(registry.callSites.size() - 1);
+}
+
+} // unnamed namespace
+
+namespace logger
+{
+
+CallSite::CallSite(const LevelId level, const char* file, const int line, const char* function)
+   : id(Register(this))
+   , level(level)
+   , file(file)
+   , line(line)
+   , function(function)
+   , m_sampleCount(0)
+   , m_windowStart(0)
+   , m_windowCount(0)
+   , m_suppressedCount(0)
+{}
+
+const CallSite* CallSite::Find(const boost::uint32_t id)
+{
+   Registry& registry = GetRegistry();
+   boost::lock_guard<boost::mutex> lock(registry.guard);
+   return id < registry.callSites.size() ? registry.callSites[id] : 0;
+}
+
+bool CallSite::Sample(const unsigned int rate) const
+{
+   unsigned int count = m_sampleCount.fetch_add(1, boost::memory_order_relaxed);
+   return rate <= 1 || count % rate == 0;
+}
+
+bool CallSite::AdmitRate(const unsigned int maxPerSecond) const
+{
+   const boost::int64_t windowLength =
+         (boost::int64_t)(codec::GetTimeBase().ticksPerMicrosecond * 1000000.0);
+
+   // window reset races with concurrent admissions, which makes the limit approximate
+   // but keeps the check lock-free
+   boost::int64_t now = codec::GetTimestamp();
+   boost::int64_t windowStart = m_windowStart.load(boost::memory_order_relaxed);
+   if (now - windowStart >= windowLength &&
+       m_windowStart.compare_exchange_strong(windowStart, now, boost::memory_order_relaxed))
+      m_windowCount.store(0, boost::memory_order_relaxed);
+
+   if (m_windowCount.fetch_add(1, boost::memory_order_relaxed) < maxPerSecond)
+      return true;
+
+   m_suppressedCount.fetch_add(1, boost::memory_order_relaxed);
+   return false;
+}
+
+unsigned int CallSite::TakeSuppressedCount() const
+{
+   // plain load first: the most of call sites never suppress anything
+   if (!m_suppressedCount.load(boost::memory_order_relaxed))
+      return 0;
+   return m_suppressedCount.exchange(0, boost::memory_order_relaxed);
+}
+
+} // namespace logger
@@ -0,0 +1,94 @@
+/**
+ *  @file
+ *  \brief     CallSite class declaration
+ *  \details   Static descriptor of a single LOG statement. Registered once per process,
+ *             log records refer to it by id instead of carrying function name and level
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef LOGGER_CALL_SITE_H
+#define LOGGER_CALL_SITE_H
+
+#include "log_level.h"
+// third-party
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace logger
+{
+
+/**
+ * CallSite class. Instances are created as block-scope statics by LOG macro,
+ * constructor assigns a unique id and adds descriptor to the process-wide registry.
+ * Id 0 is reserved for records without call site (Empty level).
+ * Call site also keeps counters for sampling and rate limiting of its records (see
+ * LOG_EVERY_N and LOG_RATE_LIMITED macros).
+ */
+class CallSite : public boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. Registers call site
+    * @param level - log level of the statement
+    * @param file - source file name
+    * @param line - line in the source file
+    * @param function - name of the function statement belongs to
+    */
+   CallSite(LevelId level, const char* file, int line, const char* function);
+
+   /**
+    * Static function, looks up registered call site by id
+    * @param id - call site id
+    * @returns - pointer to the call site or zero if id is unknown
+    */
+   static const CallSite* Find(boost::uint32_t id);
+
+   /**
+    * Sampling admission check, lock-free
+    * @param rate - every rate-th record of this call site is admitted, starting from the first
+    * @returns - true if record should be logged
+    */
+   bool Sample(unsigned int rate) const;
+
+   /**
+    * Rate limiting admission check, lock-free. Rejected records are counted and
+    * reported with the next admitted record
+    * @param maxPerSecond - maximum number of records of this call site admitted per second
+    * @returns - true if record should be logged
+    */
+   bool AdmitRate(unsigned int maxPerSecond) const;
+
+   /**
+    * Accessor to get and reset number of records rejected by rate limiting
+    * @returns - number of rejected records since the previous call
+    */
+   unsigned int TakeSuppressedCount() const;
+
+   /// unique id of the call site, never zero
+   const boost::uint32_t   id;
+   /// log level of the statement
+   const LevelId           level;
+   /// source file name
+   const char* const       file;
+   /// line in the source file
+   const int               line;
+   /// name of the function statement belongs to
+   const char* const       function;
+
+private:
+   /// number of admission checks performed by Sample
+   mutable boost::atomic<unsigned int>    m_sampleCount;
+   /// timestamp of the current rate limiting window start
+   mutable boost::atomic<boost::int64_t>  m_windowStart;
+   /// number of admission checks performed by AdmitRate in current window
+   mutable boost::atomic<unsigned int>    m_windowCount;
+   /// number of records rejected by AdmitRate and not reported yet
+   mutable boost::atomic<unsigned int>    m_suppressedCount;
+};
+
+} // namespace logger
+
+#endif // LOGGER_CALL_SITE_H
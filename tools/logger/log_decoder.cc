@@ -0,0 +1,48 @@
+/**
+ *  @file
+ *  \brief     Offline decoder of binary log files
+ *  \details   Converts log file written in logger::BinaryFormat into text, which is the same
+ *             as logger would produce in logger::TextFormat.
+ *             Usage: log_decoder <binary log file> [<text output file>]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "record_codec.h"
+// third-party
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+   if (argc < 2)
+   {
+      std::cerr << "Usage: " << argv[0] << " <binary log file> [<text output file>]" << std::endl;
+      return 1;
+   }
+
+   std::ifstream input(argv[1], std::ios_base::binary);
+   if (!input.good())
+   {
+      std::cerr << "Unable to open " << argv[1] << std::endl;
+      return 1;
+   }
+
+   std::ofstream outputFile;
+   if (argc > 2)
+   {
+      outputFile.open(argv[2]);
+      if (!outputFile.good())
+      {
+         std::cerr << "Unable to open " << argv[2] << std::endl;
+         return 1;
+      }
+   }
+
+   if (!logger::codec::DecodeLog(input, argc > 2 ? outputFile : std::cout))
+   {
+      std::cerr << "Log is truncated or malformed" << std::endl;
+      return 2;
+   }
+   return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ *  @file
+ *  \brief     Log levels and output formats
+ *  \details   Declares enums shared by Log class, call site descriptors and record formatting
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef LOGGER_LOG_LEVEL_H
+#define LOGGER_LOG_LEVEL_H
+
+// third-party
+#include <string>
+
+namespace logger
+{
+
+/// Log levels to be used with this class
+enum LevelId
+{
+   /// for debug information. Most detailed level, can impact the application performance
+   Debug,
+   /// warning information for minor non-fatal issues
+   Warning,
+   /// for serious errors that are abnormal but basically do not lead to application
+   /// malfunctioning. If present in a log should be investigated by designer
+   Error,
+   /// for fatal failures that most likely lead to application crash
+   Fatal,
+   /// helper type of log level, which doesn't produce additional logging information
+   /// like date stamp/loglevel/thread id. Produce log always and doesn't depend 
+   /// on the current log level
+   Empty
+};
+
+/// delimiter to be used in logging line between sections
+const std::string Delimiter = "\t";
+
+/// Output formats of the log file
+enum OutputFormat
+{
+   /// human readable text, one record per line (default)
+   TextFormat,
+   /// binary records with deferred formatting, to be converted to text by log_decoder tool.
+   /// Stdout output stays in text format
+   BinaryFormat
+};
+
+} // namespace logger
+
+#endif // LOGGER_LOG_LEVEL_H
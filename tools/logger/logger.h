@@ -1,33 +1,58 @@
-/**
- *  @file
- *  \brief     Main include file to use logger
- *  \details   Defines helper macros to be used for easy logging
- *  \author    Dmitry Sinelnikov
- *  \date      2012
- */
-
-#ifndef LOGGER_H
-#define LOGGER_H
-
-#include "logger_impl.h"
-// third-party
-#include <boost/current_function.hpp>
-
-#define LOG(level) \
-   if (level < logger::Log::GetLogLevel())\
-      ;\
-   else\
-      (logger::Log(level)) << logger::Delimiter << BOOST_CURRENT_FUNCTION << logger::Delimiter
-
-/// log message with Debug level
-#define LOGDBG		LOG(logger::Debug)
-/// log message with Warning log
-#define LOGWRN		LOG(logger::Warning)
-/// log message with Error level
-#define LOGERR		LOG(logger::Error)
-/// log message with Fatal level
-#define LOGFTL		LOG(logger::Fatal)
-/// log Empty message (log always, no matter what log level is)
-#define LOGEMPTY	(logger::Log(logger::Empty)) //
-
-#endif // LOGGER_H
+/**
+ *  @file
+ *  \brief     Main include file to use logger
+ *  \details   Defines helper macros to be used for easy logging
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "logger_impl.h"
+#include "call_site.h"
+// third-party
+#include <boost/current_function.hpp>
+
+/// minimum log level compiled in: statements of lower levels are removed at compile time
+/// regardless of the runtime log level. Can be redefined by the build (see LOG_MIN_LEVEL
+/// CMake option)
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL logger::Debug
+#endif
+
+/// log statement with additional per call site admission check. logSite is the static
+/// descriptor of the statement, registered on first use: outer loop runs the inner one
+/// once, as the static can only be declared in the inner loop header. Admission expression
+/// can refer to logSite and is evaluated only if level is enabled. level must be a
+/// constant expression
+#define LOG_ADMITTED(level, admission) \
+   if (level < LOG_MIN_LEVEL || level < logger::Log::GetLogLevel())\
+      ;\
+   else\
+      for (bool logOnce = true; logOnce; logOnce = false)\
+         for (static const logger::CallSite logSite(level, __FILE__, __LINE__, BOOST_CURRENT_FUNCTION);\
+              logOnce && (admission);\
+              logOnce = false)\
+            logger::Log(logSite)
+
+#define LOG(level)                              LOG_ADMITTED(level, true)
+
+/// log every rate-th message passing through this statement (sampling)
+#define LOG_EVERY_N(level, rate)                LOG_ADMITTED(level, logSite.Sample(rate))
+/// log at most maxPerSecond messages per second from this statement, number of
+/// dropped messages is reported with the next logged one
+#define LOG_RATE_LIMITED(level, maxPerSecond)   LOG_ADMITTED(level, logSite.AdmitRate(maxPerSecond))
+
+/// log message with Debug level
+#define LOGDBG		LOG(logger::Debug)
+/// log message with Warning log
+#define LOGWRN		LOG(logger::Warning)
+/// log message with Error level
+#define LOGERR		LOG(logger::Error)
+/// log message with Fatal level
+#define LOGFTL		LOG(logger::Fatal)
+/// log Empty message (log always, no matter what log level is)
+#define LOGEMPTY	(logger::Log()) //
+
+#endif // LOGGER_H
@@ -1,95 +1,95 @@
 /**
  *  @file
  *  \brief     Log class implementation
- *  \details   Holds Log class implementation together with several helper functions
+ *  \details   Holds Log class implementation
  *  \author    Dmitry Sinelnikov
  *  \date      2012
  */
 
 #include "logger.h"
+#include "async_writer.h"
 // third-party
-#include <fstream>
-#include <boost/format.hpp>
-#include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/thread.hpp>
+#include <algorithm>
 
-namespace
+namespace logger
 {
 
-/**
- * Helper function to convert level id to appropriate name that can
- * be logged in a message
- *
- * @param level - level id we are interested in
- * @returns - log level name
- */
-std::string GetLogLevelName(const logger::LevelId level)
+boost::atomic<int> Log::m_allowedLevel(logger::Warning);
+
+Log::Log()
+   : m_suppressedRecords(0)
 {
-   using namespace logger;
-   switch(level)
-   {
-      case Debug: return "DBG";
-      case Warning: return "WRN";
-      case Error: return "ERR";
-      case Fatal: return "FTL";
-      default: return "";
-   }
+   StartRecord(0);
 }
 
-/**
- * Helper function to get date-time stamp for log string
- *
- * @returns - get string with date-time stamp
- */
-std::string GetDateTimeStamp()
+Log::Log(const CallSite& site)
+   : m_suppressedRecords(site.TakeSuppressedCount())
 {
-   boost::posix_time::ptime now = boost::posix_time::second_clock::local_time();
-   return boost::posix_time::to_simple_string(now).c_str();
+   StartRecord(site.id);
 }
 
-} // unnamed namespace
+Log::~Log()
+{
+   if (m_suppressedRecords)
+      *this << " [" << m_suppressedRecords << " similar records suppressed]";
 
+   AsyncWriter::GetInstance().Push(m_record, m_length);
+}
 
-namespace logger
+void Log::StartRecord(const boost::uint32_t siteId)
 {
+   codec::RecordHeader header;
+   header.siteId = siteId;
+   header.threadId = codec::GetThreadId();
+   header.timestamp = codec::GetTimestamp();
+   ::memcpy(m_record, &header, sizeof(header));
+   m_length = sizeof(header);
+}
 
-LevelId Log::m_allowedLevel = logger::Warning;
-boost::mutex Log::m_levelAccessGuard;
-std::string Log::m_logFileName = "application.log";
+Log& Log::AppendString(const char* value, size_t length)
+{
+   const size_t overhead = 1 + sizeof(boost::uint16_t);
+   if (m_length + overhead > sizeof(m_record))
+      return *this;
 
-Log::Log(const LevelId level)
+   length = std::min(length, sizeof(m_record) - m_length - overhead);
+   boost::uint16_t stringLength = (boost::uint16_t)length;
+   m_record[m_length++] = (char)codec::ArgString;
+   ::memcpy(m_record + m_length, &stringLength, sizeof(stringLength));
+   m_length += sizeof(stringLength);
+   ::memcpy(m_record + m_length, value, length);
+   m_length += length;
+   return *this;
+}
+
+void Log::SetLogLevel(const LevelId level)
 {
-   m_requestedLevel = level;
-   if (m_requestedLevel != Empty)
-   {
-      m_stream << GetDateTimeStamp() << Delimiter
-         << "tid:" << boost::this_thread::get_id() << Delimiter
-         << GetLogLevelName(m_requestedLevel) << Delimiter;
-   }
+   m_allowedLevel.store(level, boost::memory_order_relaxed);
 }
 
-Log::~Log()
+void Log::Flush()
 {
-   std::cout << m_stream.str() << std::endl;
-
-   std::ofstream outFile(m_logFileName.c_str(), std::fstream::app);
-   if (outFile.good())
-   {
-      outFile << m_stream.str() << std::endl;
-   }
-   outFile.close();
+   AsyncWriter::GetInstance().Flush();
 }
 
-void Log::SetLogLevel(const LevelId level)
+void Log::SetLogFileName(const std::string& fileName)
+{
+   AsyncWriter::GetInstance().SetFileName(fileName);
+}
+
+void Log::SetFileRotation(const size_t maxFileSize, const int maxBackupFiles)
+{
+   AsyncWriter::GetInstance().SetRotation(maxFileSize, maxBackupFiles);
+}
+
+void Log::SetConsoleOutput(const bool enabled)
 {
-   LOCK lock(m_levelAccessGuard);
-   m_allowedLevel = level;
+   AsyncWriter::GetInstance().SetConsoleOutput(enabled);
 }
 
-LevelId Log::GetLogLevel()
+void Log::SetOutputFormat(const OutputFormat format)
 {
-   LOCK lock(m_levelAccessGuard);
-   return m_allowedLevel;
+   AsyncWriter::GetInstance().SetOutputFormat(format);
 }
 
 } // namespace logger
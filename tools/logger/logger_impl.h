@@ -1,105 +1,189 @@
-/**
- *  @file
- *  \brief     Log class declaration
- *  \details   Declare Log class and additional enum with acceptable log levels
- *  \author    Dmitry Sinelnikov
- *  \date      2012
- */
-
-#ifndef LOGGER_LOG_H
-#define LOGGER_LOG_H
-
-// third-party
-#include <sstream>
-#include <iostream>
-#include <boost/noncopyable.hpp>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/locks.hpp>
-
-namespace logger
-{
-
-/// Log levels to be used with this class
-enum LevelId
-{
-   /// for debug information. Most detailed level, can impact the application performance
-   Debug,
-   /// warning information for minor non-fatal issues
-   Warning,
-   /// for serious errors that are abnormal but basically do not lead to application
-   /// malfunctioning. If present in a log should be investigated by designer
-   Error,
-   /// for fatal failures that most likely lead to application crash
-   Fatal,
-   /// helper type of log level, which doesn't produce additional logging information
-   /// like date stamp/loglevel/thread id. Produce log always and doesn't depend 
-   /// on the current log level
-   Empty
-};
-
-/// delimiter to be used in logging line between sections
-const std::string Delimiter = "\t";
-
-/**
- * Log level class implementation. Class is non-copyable and should be used
- * as a temporary object on a stack, as logging is produced in class destructor
- */
-class Log : public boost::noncopyable
-{
-public:
-
-   /**
-    * Constructor
-    * @param level - log level to be used in this instance of object
-    */
-   Log(LevelId level);
-
-   /**
-    * Destructor
-    * Print accumulated log level to the stdout / err streams and to the log file
-    * with hardcoded name
-    */
-   ~Log();
-
-   /**
-    * Static function, can be used to set log level at any point at runtime
-    * @param level - log level to be set
-    */
-   static void SetLogLevel(LevelId level);
-
-   /**
-    * Static function, can be used to retrieve current log level at any point at runtime
-    * @returns level - current log level
-    */
-   static LevelId GetLogLevel();
-
-   /**
-    * Overloaded operator, can be used to pass new log sections and concatenate them
-    * @param obj - new section to be concatenated with previous ones
-    * @returns reference to the Log class instance
-    */
-   template <typename T>
-   Log& operator<< (const T& obj)
-   {
-      m_stream << obj;
-      return *this;
-   }
-
-private:
-   typedef boost::lock_guard<boost::mutex> LOCK;
-
-   /// minimum log level that is allowed for all instances of Log class in current application
-   static LevelId       m_allowedLevel;
-   /// mutex to provide exclusive access to log level changing methods
-   static boost::mutex  m_levelAccessGuard;
-   /// log file name
-   static std::string   m_logFileName;
-   /// log level that was requested in this instance
-   LevelId              m_requestedLevel;
-   /// internal stream that summarizes all log sections and represents them in string format
-   std::ostringstream   m_stream;
-};
-
-} // namespace logger
-
-#endif // LOGGER_LOG_H
+/**
+ *  @file
+ *  \brief     Log class declaration
+ *  \details   Declare Log class which encodes log record on the caller thread
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef LOGGER_LOG_H
+#define LOGGER_LOG_H
+
+#include "log_level.h"
+#include "record_codec.h"
+#include "record_ring.h"
+// third-party
+#include <string.h>
+#include <sstream>
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace logger
+{
+
+class CallSite;
+
+/**
+ * Log level class implementation. Class is non-copyable and should be used
+ * as a temporary object on a stack, as logging is produced in class destructor.
+ * Arguments are not formatted on the caller thread: they are stored as raw values
+ * in the binary record and formatted later by the writer thread or by the offline
+ * decoder (see record_codec.h)
+ */
+class Log : public boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. Record created this way has no call site and is printed without
+    * date stamp/loglevel/thread id regardless of the log level, used by LOGEMPTY
+    */
+   Log();
+
+   /**
+    * Constructor. Normally used by LOG macro
+    * @param site - static descriptor of the LOG statement
+    */
+   Log(const CallSite& site);
+
+   /**
+    * Destructor
+    * Passes accumulated log record to the background writer which prints it to the
+    * stdout stream and to the log file. Never blocks on I/O
+    */
+   ~Log();
+
+   /**
+    * Static function, can be used to set log level at any point at runtime
+    * @param level - log level to be set
+    */
+   static void SetLogLevel(LevelId level);
+
+   /**
+    * Static function, can be used to retrieve current log level at any point at runtime.
+    * Lock-free, called by every LOG statement
+    * @returns level - current log level
+    */
+   static LevelId GetLogLevel()
+   {
+      return (LevelId)m_allowedLevel.load(boost::memory_order_relaxed);
+   }
+
+   /**
+    * Static function, blocks the call until all records logged so far are written out
+    */
+   static void Flush();
+
+   /**
+    * Static function, can be used to change log file name at any point at runtime
+    * @param fileName - new log file name, "application.log" is used by default
+    */
+   static void SetLogFileName(const std::string& fileName);
+
+   /**
+    * Static function, can be used to set up log file rotation. Once log file grows over
+    * the limit it is renamed to <name>.1, older backups are shifted to <name>.2 etc.
+    * @param maxFileSize - log file size limit in bytes, zero disables rotation
+    * @param maxBackupFiles - number of rotated files to keep
+    */
+   static void SetFileRotation(size_t maxFileSize, int maxBackupFiles);
+
+   /**
+    * Static function, enables/disables duplication of log records to stdout
+    * @param enabled - true to print records to stdout (default), false otherwise
+    */
+   static void SetConsoleOutput(bool enabled);
+
+   /**
+    * Static function, selects log file format. File is reopened once format is changed,
+    * if it already holds records of another format it is rotated first (see
+    * SetFileRotation), so every file can be read back as a whole
+    * @param format - TextFormat (default) or BinaryFormat
+    */
+   static void SetOutputFormat(OutputFormat format);
+
+   /**
+    * Overloaded operator, can be used to pass new log sections and concatenate them.
+    * Generic version formats the object into string right away, overloads below store
+    * built-in types and strings as raw values
+    * @param obj - new section to be concatenated with previous ones
+    * @returns reference to the Log class instance
+    */
+   template <typename T>
+   Log& operator<< (const T& obj)
+   {
+      std::ostringstream stream;
+      stream << obj;
+      const std::string& value = stream.str();
+      return AppendString(value.data(), value.size());
+   }
+
+   template <size_t N>
+   Log& operator<< (const char (&value)[N]) { return AppendString(value, ::strlen(value)); }
+   Log& operator<< (const char* value) { return AppendString(value, ::strlen(value)); }
+   Log& operator<< (char* value) { return AppendString(value, ::strlen(value)); }
+   Log& operator<< (const std::string& value) { return AppendString(value.data(), value.size()); }
+   Log& operator<< (bool value) { return AppendValue(codec::ArgBool, value); }
+   Log& operator<< (char value) { return AppendValue(codec::ArgChar, value); }
+   Log& operator<< (signed char value) { return AppendValue(codec::ArgInt32, (boost::int32_t)value); }
+   Log& operator<< (unsigned char value) { return AppendValue(codec::ArgUInt32, (boost::uint32_t)value); }
+   Log& operator<< (short value) { return AppendValue(codec::ArgInt32, (boost::int32_t)value); }
+   Log& operator<< (unsigned short value) { return AppendValue(codec::ArgUInt32, (boost::uint32_t)value); }
+   Log& operator<< (int value) { return AppendValue(codec::ArgInt32, (boost::int32_t)value); }
+   Log& operator<< (unsigned int value) { return AppendValue(codec::ArgUInt32, (boost::uint32_t)value); }
+   Log& operator<< (long value) { return AppendValue(codec::ArgInt64, (boost::int64_t)value); }
+   Log& operator<< (unsigned long value) { return AppendValue(codec::ArgUInt64, (boost::uint64_t)value); }
+   Log& operator<< (long long value) { return AppendValue(codec::ArgInt64, (boost::int64_t)value); }
+   Log& operator<< (unsigned long long value) { return AppendValue(codec::ArgUInt64, (boost::uint64_t)value); }
+   Log& operator<< (float value) { return AppendValue(codec::ArgDouble, (double)value); }
+   Log& operator<< (double value) { return AppendValue(codec::ArgDouble, value); }
+   Log& operator<< (const void* value) { return AppendValue(codec::ArgPointer, value); }
+
+private:
+   /**
+    * Stores type tag and raw value bytes in the record. Value is silently dropped if
+    * there is no space left in the record
+    * @param type - type tag of the value
+    * @param value - value to be stored
+    * @returns reference to the Log class instance
+    */
+   template <typename T>
+   Log& AppendValue(codec::ArgumentType type, const T& value)
+   {
+      if (m_length + 1 + sizeof(T) <= sizeof(m_record))
+      {
+         m_record[m_length++] = (char)type;
+         ::memcpy(m_record + m_length, &value, sizeof(T));
+         m_length += sizeof(T);
+      }
+      return *this;
+   }
+
+   /**
+    * Stores string in the record, truncating it if there is not enough space left
+    * @param value - string data
+    * @param length - string length
+    * @returns reference to the Log class instance
+    */
+   Log& AppendString(const char* value, size_t length);
+
+   /**
+    * Writes record header, common part of the constructors
+    * @param siteId - id of the call site, 0 if there is none
+    */
+   void StartRecord(boost::uint32_t siteId);
+
+   /// minimum log level that is allowed for all instances of Log class in current application
+   static boost::atomic<int>  m_allowedLevel;
+   /// binary record: header followed by encoded arguments
+   char                       m_record[RecordRing::MaxRecordSize];
+   /// number of bytes used in the record
+   size_t                     m_length;
+   /// number of records suppressed by rate limiting at this call site since the last one
+   /// that passed, reported at the end of this record
+   unsigned int               m_suppressedRecords;
+};
+
+} // namespace logger
+
+#endif // LOGGER_LOG_H
@@ -0,0 +1,381 @@
+/**
+ *  @file
+ *  \brief     Binary log record helpers implementation
+ *  \details   Holds implementation of record formatting, timestamp helpers and binary
+ *             log decoding
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "record_codec.h"
+// third-party
+#include <string.h>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <istream>
+#include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace
+{
+
+/**
+ * Helper function to read value of the given type from the record
+ * @param position - in/out parameter, current read position, moved past the value
+ * @param end - end of the record
+ * @param value - out parameter, value read
+ * @returns - false if record is too short
+ */
+template <typename T>
+bool ReadValue(const char*& position, const char* end, T& value)
+{
+   if (end - position < (long)sizeof(T))
+      return false;
+   ::memcpy(&value, position, sizeof(T));
+   position += sizeof(T);
+   return true;
+}
+
+/**
+ * Helper function to read value of the given type from the record and print it
+ * @param position - in/out parameter, current read position, moved past the value
+ * @param end - end of the record
+ * @param stream - stream to print value to
+ * @returns - false if record is too short
+ */
+template <typename T>
+bool PrintValue(const char*& position, const char* end, std::ostream& stream)
+{
+   T value;
+   if (!ReadValue(position, end, value))
+      return false;
+   stream << value;
+   return true;
+}
+
+/// call site descriptor restored from the binary log
+struct CallSiteInfo
+{
+   logger::LevelId   level;
+   int               line;
+   std::string       file;
+   std::string       function;
+};
+
+typedef std::map<boost::uint32_t, CallSiteInfo> CallSites;
+
+/**
+ * Helper function to read value of the given type from the input stream
+ * @param input - input stream
+ * @param value - out parameter, value read
+ * @returns - false if stream is exhausted
+ */
+template <typename T>
+bool ReadStreamValue(std::istream& input, T& value)
+{
+   return input.read(reinterpret_cast<char*>(&value), sizeof(T)).good();
+}
+
+/**
+ * Helper function to read string prefixed by 16-bit length from the input stream
+ * @param input - input stream
+ * @param value - out parameter, string read
+ * @returns - false if stream is exhausted
+ */
+bool ReadStreamString(std::istream& input, std::string& value)
+{
+   boost::uint16_t length;
+   if (!ReadStreamValue(input, length))
+      return false;
+
+   value.resize(length);
+   return !length || input.read(&value[0], length).good();
+}
+
+/// period the time stamp counter is calibrated over
+const int CalibrationPeriodMs = 10;
+
+/// time base of the current process, calibrated once, see GetTimeBase
+logger::codec::TimeBase TheTimeBase;
+
+/// flag to calibrate time base once
+boost::once_flag TimeBaseFlag = BOOST_ONCE_INIT;
+
+/// number of threads which have got their id so far
+boost::atomic<boost::uint32_t> ThreadCount(0);
+
+/// ids of the threads, see GetThreadId. Created once and never destroyed, so threads
+/// can log until the very exit
+boost::thread_specific_ptr<boost::uint32_t>* ThreadIds = 0;
+
+/// flag to create thread ids storage once
+boost::once_flag ThreadIdsFlag = BOOST_ONCE_INIT;
+
+/**
+ * Helper function to get monotonic system time
+ * @returns - monotonic time in nanoseconds
+ */
+boost::int64_t GetMonotonicTime()
+{
+   using namespace boost::chrono;
+   return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Helper function to get current wall-clock time
+ * @returns - microseconds since epoch (local time zone)
+ */
+boost::int64_t GetWallClockTime()
+{
+   using namespace boost::posix_time;
+   const ptime epoch(boost::gregorian::date(1970, 1, 1));
+   return (microsec_clock::local_time() - epoch).total_microseconds();
+}
+
+/**
+ * Helper function to measure timestamp tick rate and to bind ticks to wall-clock time
+ * @returns - time base of the current process
+ */
+logger::codec::TimeBase CalibrateTimeBase()
+{
+   using logger::codec::GetTimestamp;
+   logger::codec::TimeBase timeBase;
+   timeBase.ticksPerMicrosecond = 1000.0;
+
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+   boost::int64_t startTime = GetMonotonicTime();
+   boost::int64_t startTicks = GetTimestamp();
+   boost::this_thread::sleep(boost::posix_time::milliseconds(CalibrationPeriodMs));
+   boost::int64_t elapsedTime = GetMonotonicTime() - startTime;
+   boost::int64_t elapsedTicks = GetTimestamp() - startTicks;
+   timeBase.ticksPerMicrosecond = (double)elapsedTicks * 1000.0 / (double)elapsedTime;
+#endif
+
+   timeBase.wallClock = GetWallClockTime()
+         - (boost::int64_t)((double)GetTimestamp() / timeBase.ticksPerMicrosecond);
+   return timeBase;
+}
+
+/**
+ * Helper function to calibrate time base of the current process
+ */
+void InitTimeBase()
+{
+   TheTimeBase = CalibrateTimeBase();
+}
+
+/**
+ * Helper function to create storage of thread ids
+ */
+void CreateThreadIds()
+{
+   ThreadIds = new boost::thread_specific_ptr<boost::uint32_t>();
+}
+
+/**
+ * Helper function to get date-time stamp for log string
+ * @param timestamp - record timestamp in ticks
+ * @param timeBase - parameters of timestamp conversion
+ * @returns - string with date-time stamp
+ */
+std::string GetDateTimeStamp(const boost::int64_t timestamp, const logger::codec::TimeBase& timeBase)
+{
+   using namespace boost::posix_time;
+   const ptime epoch(boost::gregorian::date(1970, 1, 1));
+   boost::int64_t time = timeBase.wallClock
+         + (boost::int64_t)((double)timestamp / timeBase.ticksPerMicrosecond);
+   return to_simple_string(epoch + microseconds(time));
+}
+
+} // unnamed namespace
+
+namespace logger
+{
+namespace codec
+{
+
+void AppendBinaryString(std::string& buffer, const char* value)
+{
+   size_t length = ::strlen(value);
+   boost::uint16_t stringLength = (boost::uint16_t)(length < 0xFFFF ? length : 0xFFFF);
+   AppendBinary(buffer, stringLength);
+   buffer.append(value, stringLength);
+}
+
+boost::int64_t GetTimestamp()
+{
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+   return (boost::int64_t)__rdtsc();
+#else
+   return GetMonotonicTime();
+#endif
+}
+
+boost::uint32_t GetThreadId()
+{
+   boost::call_once(ThreadIdsFlag, &CreateThreadIds);
+   boost::uint32_t* threadId = ThreadIds->get();
+   if (!threadId)
+   {
+      threadId = new boost::uint32_t(++ThreadCount);
+      ThreadIds->reset(threadId);
+   }
+   return *threadId;
+}
+
+const TimeBase& GetTimeBase()
+{
+   boost::call_once(TimeBaseFlag, &InitTimeBase);
+   return TheTimeBase;
+}
+
+const char* GetLogLevelName(const LevelId level)
+{
+   switch(level)
+   {
+      case Debug: return "DBG";
+      case Warning: return "WRN";
+      case Error: return "ERR";
+      case Fatal: return "FTL";
+      default: return "";
+   }
+}
+
+void FormatRecord(const char* record,
+      const size_t length,
+      const LevelId level,
+      const char* function,
+      const TimeBase& timeBase,
+      std::string& output)
+{
+   const char* position = record;
+   const char* end = record + length;
+   RecordHeader header;
+   if (!ReadValue(position, end, header))
+      return;
+
+   std::ostringstream stream;
+   if (function)
+   {
+      stream << GetDateTimeStamp(header.timestamp, timeBase) << Delimiter
+         << "tid:" << header.threadId << Delimiter
+         << GetLogLevelName(level) << Delimiter
+         << Delimiter << function << Delimiter;
+   }
+
+   unsigned char type;
+   while (ReadValue(position, end, type))
+   {
+      bool valid = true;
+      switch (type)
+      {
+         case ArgBool: valid = PrintValue<bool>(position, end, stream); break;
+         case ArgChar: valid = PrintValue<char>(position, end, stream); break;
+         case ArgInt32: valid = PrintValue<boost::int32_t>(position, end, stream); break;
+         case ArgUInt32: valid = PrintValue<boost::uint32_t>(position, end, stream); break;
+         case ArgInt64: valid = PrintValue<boost::int64_t>(position, end, stream); break;
+         case ArgUInt64: valid = PrintValue<boost::uint64_t>(position, end, stream); break;
+         case ArgDouble: valid = PrintValue<double>(position, end, stream); break;
+         case ArgPointer: valid = PrintValue<const void*>(position, end, stream); break;
+         case ArgString:
+         {
+            boost::uint16_t stringLength;
+            valid = ReadValue(position, end, stringLength) && (end - position >= stringLength);
+            if (valid)
+            {
+               stream.write(position, stringLength);
+               position += stringLength;
+            }
+            break;
+         }
+         default: valid = false;
+      }
+
+      if (!valid)
+         break;
+   }
+   output += stream.str();
+}
+
+bool DecodeLog(std::istream& input, std::ostream& output)
+{
+   CallSites callSites;
+   TimeBase timeBase = { 0, 1000.0 };
+   std::vector<char> record;
+   std::string text;
+
+   char entryType;
+   while (input.get(entryType))
+   {
+      switch (entryType)
+      {
+         case EntryHeader:
+         {
+            char magic[sizeof(FileMagic)];
+            if (!input.read(magic, sizeof(magic)).good() ||
+                !std::equal(magic, magic + sizeof(magic), FileMagic) ||
+                !ReadStreamValue(input, timeBase))
+               return false;
+            callSites.clear();
+            break;
+         }
+
+         case EntryCallSite:
+         {
+            boost::uint32_t id;
+            boost::uint8_t level;
+            boost::int32_t line;
+            CallSiteInfo site;
+            if (!ReadStreamValue(input, id) || !ReadStreamValue(input, level) ||
+                !ReadStreamValue(input, line) || !ReadStreamString(input, site.file) ||
+                !ReadStreamString(input, site.function))
+               return false;
+            site.level = (LevelId)level;
+            site.line = line;
+            callSites[id] = site;
+            break;
+         }
+
+         case EntryRecord:
+         {
+            boost::uint16_t length;
+            if (!ReadStreamValue(input, length) || length < sizeof(RecordHeader))
+               return false;
+            record.resize(length);
+            if (!input.read(&record[0], length).good())
+               return false;
+
+            RecordHeader header;
+            ::memcpy(&header, &record[0], sizeof(header));
+            CallSites::const_iterator it = callSites.find(header.siteId);
+
+            text.clear();
+            if (it == callSites.end())
+               FormatRecord(&record[0], length, Empty, 0, timeBase, text);
+            else
+               FormatRecord(&record[0], length, it->second.level, it->second.function.c_str(),
+                     timeBase, text);
+            output << text << '\n';
+            break;
+         }
+
+         default:
+            return false;
+      }
+   }
+   return true;
+}
+
+} // namespace codec
+} // namespace logger
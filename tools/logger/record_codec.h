@@ -0,0 +1,158 @@
+/**
+ *  @file
+ *  \brief     Binary log record layout
+ *  \details   Declares layout of the binary log records and binary log file, together with
+ *             helper functions to encode records on the hot path and decode/format them later
+ *             (in the writer thread or in the offline decoder tool)
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef LOGGER_RECORD_CODEC_H
+#define LOGGER_RECORD_CODEC_H
+
+#include "log_level.h"
+// third-party
+#include <string>
+#include <iosfwd>
+#include <boost/cstdint.hpp>
+
+namespace logger
+{
+namespace codec
+{
+
+/**
+ * Record starts with the fixed header, which is followed by the sequence of arguments.
+ * Every argument is a one-byte ArgumentType tag followed by raw value bytes. String
+ * values are prefixed by 16-bit length.
+ */
+struct RecordHeader
+{
+   /// id of the call site (see CallSite), 0 for records without call site
+   boost::uint32_t   siteId;
+   /// sequential id of the thread which produced the record
+   boost::uint32_t   threadId;
+   /// monotonic time in ticks, see GetTimestamp
+   boost::int64_t    timestamp;
+};
+
+/// parameters to convert record timestamps to wall-clock time
+struct TimeBase
+{
+   /// wall-clock time which corresponds to timestamp zero (microseconds since epoch,
+   /// local time zone)
+   boost::int64_t    wallClock;
+   /// number of timestamp ticks per microsecond
+   double            ticksPerMicrosecond;
+};
+
+/// type tags of the record arguments
+enum ArgumentType
+{
+   ArgBool,
+   ArgChar,
+   ArgInt32,
+   ArgUInt32,
+   ArgInt64,
+   ArgUInt64,
+   ArgDouble,
+   ArgPointer,
+   ArgString
+};
+
+/**
+ * Binary log file consists of entries, every entry starts with one-byte EntryType tag.
+ *  - header: 8 bytes of FileMagic, TimeBase. Written at the start of every file and may
+ *    be repeated, call site table is reset after it;
+ *  - call site: uint32 id, uint8 level, int32 line, string file, string function. Written
+ *    before the first record which refers to the call site;
+ *  - record: uint16 length followed by the record bytes.
+ */
+enum EntryType
+{
+   EntryHeader = 'H',
+   EntryCallSite = 'S',
+   EntryRecord = 'R'
+};
+
+/// magic bytes of the binary log file header
+const char FileMagic[8] = { 'J', 'B', 'B', 'I', 'N', 'L', 'O', 'G' };
+
+/**
+ * Helper function to append raw bytes of the value to the binary buffer
+ * @param buffer - in/out parameter, buffer to append value to
+ * @param value - value to be appended
+ */
+template <typename T>
+void AppendBinary(std::string& buffer, const T& value)
+{
+   buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Helper function to append string prefixed by 16-bit length to the binary buffer
+ * @param buffer - in/out parameter, buffer to append string to
+ * @param value - zero-terminated string, truncated to 64Kb
+ */
+void AppendBinaryString(std::string& buffer, const char* value);
+
+/**
+ * Helper function to get monotonic time used in record headers. Time stamp counter is
+ * used on x86 as it is much cheaper than system calls, nanoseconds of monotonic system
+ * time elsewhere
+ * @returns - monotonic time in ticks
+ */
+boost::int64_t GetTimestamp();
+
+/**
+ * Helper function to get sequential id of the calling thread. Id is assigned on first call
+ * @returns - thread id
+ */
+boost::uint32_t GetThreadId();
+
+/**
+ * Helper function to get parameters of timestamp conversion. Calibrated on first call,
+ * which takes a few milliseconds
+ * @returns - time base of the current process
+ */
+const TimeBase& GetTimeBase();
+
+/**
+ * Helper function to convert log level id to the name that is printed in a log
+ * @param level - level id we are interested in
+ * @returns - log level name
+ */
+const char* GetLogLevelName(LevelId level);
+
+/**
+ * Formats binary record into text line (without line end)
+ *
+ * @param record - record bytes, starting with RecordHeader
+ * @param length - record length
+ * @param level - log level of the record call site
+ * @param function - function name of the record call site, zero for records without call site
+ * @param timeBase - parameters of timestamp conversion, see GetTimeBase
+ * @param output - in/out parameter, text is appended to it
+ */
+void FormatRecord(const char* record,
+      size_t length,
+      LevelId level,
+      const char* function,
+      const TimeBase& timeBase,
+      std::string& output);
+
+/**
+ * Decodes binary log entries and prints them as text, the same as logger writes in
+ * TextFormat. Used by log_decoder tool
+ *
+ * @param input - binary log stream
+ * @param output - text output stream
+ * @returns - false if log is malformed or truncated
+ */
+bool DecodeLog(std::istream& input, std::ostream& output);
+
+} // namespace codec
+} // namespace logger
+
+#endif // LOGGER_RECORD_CODEC_H
@@ -0,0 +1,145 @@
+/**
+ *  @file
+ *  \brief     RecordRing class declaration and implementation
+ *  \details   Bounded lock-free multi-producer/single-consumer ring of fixed-size log records
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef LOGGER_RECORD_RING_H
+#define LOGGER_RECORD_RING_H
+
+// third-party
+#include <string.h>
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+
+namespace logger
+{
+
+/**
+ * RecordRing class. Any number of producer threads can push records concurrently
+ * without locks, single consumer (writer thread) pops them in the order of slot
+ * reservation. Every slot carries a sequence number which tells whether it is free
+ * for producer or ready for consumer (see D. Vyukov bounded MPMC queue).
+ */
+class RecordRing : public boost::noncopyable
+{
+public:
+   /// maximum size of the single record, longer records are truncated
+   static const size_t MaxRecordSize = 512 - sizeof(size_t) - sizeof(int);
+
+   /**
+    * Constructor
+    * @param capacity - number of slots in the ring, must be a power of two
+    */
+   explicit RecordRing(size_t capacity)
+      : m_mask(capacity - 1)
+      , m_slots(new Slot[capacity])
+      , m_enqueuePosition(0)
+      , m_dequeuePosition(0)
+   {
+      for (size_t i = 0; i < capacity; ++i)
+         m_slots[i].sequence.store(i, boost::memory_order_relaxed);
+   }
+
+   /**
+    * Copies the record into the ring. Never blocks
+    * @param data - record data
+    * @param length - record length, truncated to MaxRecordSize
+    * @returns - false if the ring is full and record is dropped
+    */
+   bool TryPush(const char* data, size_t length)
+   {
+      size_t position = m_enqueuePosition.load(boost::memory_order_relaxed);
+      Slot* slot;
+      for (;;)
+      {
+         slot = &m_slots[position & m_mask];
+         size_t sequence = slot->sequence.load(boost::memory_order_acquire);
+         long difference = (long)sequence - (long)position;
+         if (difference == 0)
+         {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+                  boost::memory_order_relaxed))
+               break;
+         }
+         else if (difference < 0)
+            return false;
+         else
+            position = m_enqueuePosition.load(boost::memory_order_relaxed);
+      }
+
+      slot->length = (int)(length < MaxRecordSize ? length : MaxRecordSize);
+      ::memcpy(slot->data, data, slot->length);
+      slot->sequence.store(position + 1, boost::memory_order_release);
+      return true;
+   }
+
+   /**
+    * Consumer side. Gives access to the oldest published record without removing it
+    * @param data - out parameter, pointer to record data
+    * @param length - out parameter, record length
+    * @returns - false if there is no published record
+    */
+   bool Front(const char*& data, int& length) const
+   {
+      const Slot& slot = m_slots[m_dequeuePosition & m_mask];
+      if (slot.sequence.load(boost::memory_order_acquire) != m_dequeuePosition + 1)
+         return false;
+
+      data = slot.data;
+      length = slot.length;
+      return true;
+   }
+
+   /**
+    * Consumer side. Releases the record returned by Front back to producers
+    */
+   void Pop()
+   {
+      Slot& slot = m_slots[m_dequeuePosition & m_mask];
+      slot.sequence.store(m_dequeuePosition + m_mask + 1, boost::memory_order_release);
+      ++m_dequeuePosition;
+   }
+
+   /**
+    * Accessor to get total number of slots ever reserved by producers
+    * @returns - enqueue position
+    */
+   size_t GetEnqueuePosition() const
+   {
+      return m_enqueuePosition.load(boost::memory_order_acquire);
+   }
+
+   /**
+    * Consumer side. Accessor to get total number of records ever popped
+    * @returns - dequeue position
+    */
+   size_t GetDequeuePosition() const
+   {
+      return m_dequeuePosition;
+   }
+
+private:
+   struct Slot
+   {
+      boost::atomic<size_t>   sequence;
+      int                     length;
+      char                    data[MaxRecordSize];
+   };
+
+   /// capacity - 1, used to wrap positions
+   const size_t               m_mask;
+   /// ring storage
+   boost::scoped_array<Slot>  m_slots;
+   /// next position to be reserved by producer
+   boost::atomic<size_t>      m_enqueuePosition;
+   /// next position to be read by consumer, touched by consumer only
+   size_t                     m_dequeuePosition;
+};
+
+} // namespace logger
+
+#endif // LOGGER_RECORD_RING_H
@@ -0,0 +1,96 @@
+#include "fixture_logger.h"
+// third-party
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+
+/// number of backup files test log file can have
+const int MaxBackupFiles = 3;
+
+/// log file size limit used by default
+const size_t DefaultMaxFileSize = 16 * 1024 * 1024;
+
+} // unnamed namespace
+
+namespace logger
+{
+namespace test
+{
+
+FixtureLogger::FixtureLogger()
+{}
+
+void FixtureLogger::SetUp()
+{
+   // writer keeps the file open between batches, so every test gets a file of its own
+   m_fileName = std::string("logger_tests_") +
+         ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".log";
+
+   m_savedLogLevel = Log::GetLogLevel();
+   Log::SetLogLevel(Debug);
+   Log::SetConsoleOutput(false);
+   Log::SetOutputFormat(TextFormat);
+   Log::SetFileRotation(DefaultMaxFileSize, MaxBackupFiles);
+   Log::SetLogFileName(m_fileName);
+   Log::Flush();
+   RemoveFiles();
+}
+
+void FixtureLogger::TearDown()
+{
+   Log::Flush();
+   Log::SetLogLevel(m_savedLogLevel);
+   Log::SetOutputFormat(TextFormat);
+   Log::SetFileRotation(DefaultMaxFileSize, MaxBackupFiles);
+   Log::SetLogFileName("application.log");
+   Log::SetConsoleOutput(true);
+   Log::Flush();
+   RemoveFiles();
+}
+
+void FixtureLogger::RemoveFiles()
+{
+   std::remove(m_fileName.c_str());
+   for (int i = 1; i <= MaxBackupFiles + 1; ++i)
+      std::remove(GetBackupFileName(i).c_str());
+}
+
+const std::string& FixtureLogger::GetFileName() const
+{
+   return m_fileName;
+}
+
+std::string FixtureLogger::GetBackupFileName(const int index) const
+{
+   return m_fileName + "." + boost::lexical_cast<std::string>(index);
+}
+
+std::string FixtureLogger::ReadFile(const std::string& fileName)
+{
+   std::ifstream file(fileName.c_str(), std::ios_base::binary);
+   std::ostringstream contents;
+   contents << file.rdbuf();
+   return contents.str();
+}
+
+Lines FixtureLogger::ReadLines(const std::string& fileName)
+{
+   std::istringstream contents(ReadFile(fileName));
+   Lines lines;
+   std::string line;
+   while (std::getline(contents, line))
+      lines.push_back(line);
+   return lines;
+}
+
+bool FixtureLogger::FileExists(const std::string& fileName)
+{
+   return std::ifstream(fileName.c_str()).good();
+}
+
+} // namespace test
+} // namespace logger
@@ -0,0 +1,47 @@
+#ifndef LOGGER_TEST_FIXTURE_LOGGER_H
+#define LOGGER_TEST_FIXTURE_LOGGER_H
+
+#include <logger/logger.h>
+// third-party
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace logger
+{
+namespace test
+{
+
+typedef std::vector<std::string> Lines;
+
+/**
+ * Fixture which points the process-wide logger to a test log file without console
+ * output, and restores default settings afterwards
+ */
+class FixtureLogger : public ::testing::Test
+{
+public:
+   FixtureLogger();
+   void SetUp();
+   void TearDown();
+
+   const std::string& GetFileName() const;
+   std::string GetBackupFileName(int index) const;
+   static std::string ReadFile(const std::string& fileName);
+   static Lines ReadLines(const std::string& fileName);
+   static bool FileExists(const std::string& fileName);
+
+private:
+   void RemoveFiles();
+
+   /// name of the test log file, unique for every test
+   std::string       m_fileName;
+   /// Loglevel we need to save before test execution. Will be restored in a
+   /// TearDown procedure
+   logger::LevelId   m_savedLogLevel;
+};
+
+} // namespace test
+} // namespace logger
+
+#endif // LOGGER_TEST_FIXTURE_LOGGER_H
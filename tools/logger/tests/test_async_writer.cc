@@ -0,0 +1,222 @@
+#include "fixture_logger.h"
+#include <logger/record_ring.h>
+// third-party
+#include <string.h>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+
+/// number of records every producer thread pushes
+const int RecordsPerThread = 10000;
+
+/// number of producer threads
+const int ProducerThreads = 4;
+
+/// record pushed to the ring by producer threads
+struct TestRecord
+{
+   int   producer;
+   int   sequence;
+};
+
+/**
+ * Helper routine to be run in a separate thread: pushes numbered records to the ring,
+ * retrying while it is full
+ *
+ * @param ring - ring to push records to
+ * @param producer - number of the producer
+ */
+void PushRecords(logger::RecordRing* ring, const int producer)
+{
+   for (int i = 0; i < RecordsPerThread; ++i)
+   {
+      TestRecord record = { producer, i };
+      while (!ring->TryPush(reinterpret_cast<const char*>(&record), sizeof(record)))
+         boost::this_thread::yield();
+   }
+}
+
+/**
+ * Helper routine to be run in a separate thread: logs numbered messages
+ * @param thread - number of the thread
+ * @param count - number of messages to log
+ */
+void LogMessages(const int thread, const int count)
+{
+   for (int i = 0; i < count; ++i)
+      LOGDBG << "thread " << thread << " message " << i;
+}
+
+/**
+ * Helper function to cut the message out of the text log line
+ * @param line - log line
+ * @returns - message, which follows the last delimiter
+ */
+std::string GetMessage(const std::string& line)
+{
+   return line.substr(line.rfind(logger::Delimiter) + 1);
+}
+
+} // unnamed namespace
+
+namespace logger
+{
+namespace test
+{
+
+/*
+ @about Check ring returns records in push order, drops them once full and truncates
+ too long ones
+ */
+TEST(RecordRing, TryPush_DropsRecordsOnceFull)
+{
+   RecordRing ring(4);
+   const char* data;
+   int length;
+   ASSERT_FALSE(ring.Front(data, length));
+
+   for (int i = 0; i < 4; ++i)
+   {
+      std::string record = boost::lexical_cast<std::string>(i);
+      ASSERT_TRUE(ring.TryPush(record.data(), record.size()));
+   }
+   ASSERT_FALSE(ring.TryPush("4", 1));
+   ASSERT_EQ(4u, ring.GetEnqueuePosition());
+
+   ASSERT_TRUE(ring.Front(data, length));
+   ASSERT_EQ(std::string("0"), std::string(data, length));
+   ring.Pop();
+   ASSERT_TRUE(ring.TryPush("4", 1));
+
+   for (int i = 1; i <= 4; ++i)
+   {
+      ASSERT_TRUE(ring.Front(data, length));
+      ASSERT_EQ(boost::lexical_cast<std::string>(i), std::string(data, length));
+      ring.Pop();
+   }
+   ASSERT_FALSE(ring.Front(data, length));
+   ASSERT_EQ(5u, ring.GetDequeuePosition());
+
+   std::string longRecord(RecordRing::MaxRecordSize + 100, 'x');
+   ASSERT_TRUE(ring.TryPush(longRecord.data(), longRecord.size()));
+   ASSERT_TRUE(ring.Front(data, length));
+   ASSERT_EQ((int)RecordRing::MaxRecordSize, length);
+}
+
+/*
+ @about Check concurrent producers don't lose or reorder their records
+ */
+TEST(RecordRing, TryPush_ConcurrentProducers)
+{
+   RecordRing ring(256);
+   boost::thread_group producers;
+   for (int i = 0; i < ProducerThreads; ++i)
+      producers.create_thread(boost::bind(&PushRecords, &ring, i));
+
+   std::vector<int> nextSequence(ProducerThreads, 0);
+   for (int received = 0; received < ProducerThreads * RecordsPerThread; )
+   {
+      const char* data;
+      int length;
+      if (!ring.Front(data, length))
+      {
+         boost::this_thread::yield();
+         continue;
+      }
+
+      TestRecord record;
+      ASSERT_EQ((int)sizeof(record), length);
+      ::memcpy(&record, data, sizeof(record));
+      ring.Pop();
+      ASSERT_EQ(nextSequence[record.producer], record.sequence);
+      ++nextSequence[record.producer];
+      ++received;
+   }
+   producers.join_all();
+
+   const char* data;
+   int length;
+   ASSERT_FALSE(ring.Front(data, length));
+}
+
+/*
+ @about Check every record logged before Flush is in the file once Flush returns,
+ in the order it was logged by its thread
+ */
+TEST_F(FixtureLogger, Flush_WritesRecordsInOrder)
+{
+   const int threads = 3;
+   const int messages = 500;
+   boost::thread_group loggers;
+   for (int i = 0; i < threads; ++i)
+      loggers.create_thread(boost::bind(&LogMessages, i, messages));
+   loggers.join_all();
+   LOGWRN << "last message";
+   Log::Flush();
+
+   Lines lines = ReadLines(GetFileName());
+   ASSERT_EQ((size_t)(threads * messages + 1), lines.size());
+   ASSERT_EQ(std::string("last message"), GetMessage(lines.back()));
+   ASSERT_NE(std::string::npos, lines.back().find("WRN"));
+
+   std::vector<int> nextMessage(threads, 0);
+   for (size_t i = 0; i + 1 < lines.size(); ++i)
+   {
+      std::istringstream message(GetMessage(lines[i]));
+      std::string word;
+      int thread = -1;
+      int number = -1;
+      message >> word >> thread >> word >> number;
+      ASSERT_TRUE(thread >= 0 && thread < threads) << lines[i];
+      ASSERT_EQ(nextMessage[thread], number);
+      ++nextMessage[thread];
+   }
+}
+
+/*
+ @about Check log file is rotated once it grows over the limit, and only the given
+ number of backups is kept
+ */
+TEST_F(FixtureLogger, SetFileRotation_RotatesFiles)
+{
+   const size_t maxFileSize = 4096;
+   Log::SetFileRotation(maxFileSize, 2);
+   const int rounds = 20;
+   const int messagesPerRound = 20;
+   for (int i = 0; i < rounds; ++i)
+   {
+      for (int j = 0; j < messagesPerRound; ++j)
+         LOGDBG << "message " << i * messagesPerRound + j;
+      Log::Flush();
+   }
+
+   ASSERT_FALSE(FileExists(GetBackupFileName(3)));
+   Lines lines;
+   const std::string fileNames[] = { GetBackupFileName(2), GetBackupFileName(1), GetFileName() };
+   for (int i = 0; i < 3; ++i)
+   {
+      std::string contents = ReadFile(fileNames[i]);
+      ASSERT_FALSE(contents.empty()) << fileNames[i];
+      ASSERT_LE(contents.size(), maxFileSize) << fileNames[i];
+      Lines fileLines = ReadLines(fileNames[i]);
+      lines.insert(lines.end(), fileLines.begin(), fileLines.end());
+   }
+
+   // backups hold the latest records without gaps
+   ASSERT_LT(lines.size(), (size_t)(rounds * messagesPerRound));
+   int first = rounds * messagesPerRound - (int)lines.size();
+   for (size_t i = 0; i < lines.size(); ++i)
+   {
+      ASSERT_EQ("message " + boost::lexical_cast<std::string>(first + (int)i),
+            GetMessage(lines[i]));
+   }
+}
+
+} // namespace test
+} // namespace logger
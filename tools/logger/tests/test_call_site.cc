@@ -0,0 +1,98 @@
+#include "fixture_logger.h"
+#include <logger/call_site.h>
+// third-party
+#include <string>
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+
+/**
+ * Helper function to count evaluations of the log statement arguments
+ * @param count - in/out parameter, number of evaluations
+ * @returns - number of evaluations, including this one
+ */
+int CountEvaluation(int& count)
+{
+   return ++count;
+}
+
+} // unnamed namespace
+
+namespace logger
+{
+namespace test
+{
+
+/*
+ @about Check sampling admits every rate-th check starting from the first one
+ */
+TEST(CallSite, Sample_AdmitsEveryNth)
+{
+   static const CallSite site(Debug, __FILE__, __LINE__, "Sample");
+   ASSERT_NE(0u, site.id);
+   ASSERT_EQ(&site, CallSite::Find(site.id));
+
+   int admitted = 0;
+   for (int i = 0; i < 10; ++i)
+   {
+      if (site.Sample(3))
+      {
+         ASSERT_EQ(0, i % 3);
+         ++admitted;
+      }
+   }
+   ASSERT_EQ(4, admitted);
+   ASSERT_TRUE(site.Sample(1));
+   ASSERT_TRUE(site.Sample(0));
+}
+
+/*
+ @about Check rate limiting admits the given number of checks per second and counts
+ the rejected ones until they are taken
+ */
+TEST(CallSite, AdmitRate_LimitsAndCountsSuppressed)
+{
+   static const CallSite site(Warning, __FILE__, __LINE__, "AdmitRate");
+   int admitted = 0;
+   for (int i = 0; i < 100; ++i)
+      admitted += site.AdmitRate(5) ? 1 : 0;
+
+   ASSERT_EQ(5, admitted);
+   ASSERT_EQ(95u, site.TakeSuppressedCount());
+   ASSERT_EQ(0u, site.TakeSuppressedCount());
+}
+
+/*
+ @about Check admission macros evaluate arguments of admitted records only, and
+ disabled level skips both admission and arguments
+ */
+TEST_F(FixtureLogger, LogAdmitted_EvaluatesAdmittedOnly)
+{
+   int sampled = 0;
+   int limited = 0;
+   for (int i = 0; i < 10; ++i)
+   {
+      LOG_EVERY_N(Debug, 3) << "sampled " << CountEvaluation(sampled);
+      LOG_RATE_LIMITED(Debug, 2) << "limited " << CountEvaluation(limited);
+   }
+   ASSERT_EQ(4, sampled);
+   ASSERT_EQ(2, limited);
+
+   Log::SetLogLevel(Warning);
+   int disabled = 0;
+   LOGDBG << CountEvaluation(disabled);
+   LOG_EVERY_N(Debug, 1) << CountEvaluation(disabled);
+   ASSERT_EQ(0, disabled);
+
+   Log::Flush();
+   Lines lines = ReadLines(GetFileName());
+   ASSERT_EQ(6u, lines.size());
+   ASSERT_NE(std::string::npos, lines[0].find("sampled 1"));
+   ASSERT_NE(std::string::npos, lines[1].find("limited 1"));
+   ASSERT_NE(std::string::npos, lines[2].find("limited 2"));
+   ASSERT_NE(std::string::npos, lines[5].find("sampled 4"));
+}
+
+} // namespace test
+} // namespace logger
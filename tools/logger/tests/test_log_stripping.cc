@@ -0,0 +1,40 @@
+// statements below Error are removed at compile time in this file
+#undef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL logger::Error
+
+#include "fixture_logger.h"
+// third-party
+#include <string>
+
+namespace logger
+{
+namespace test
+{
+
+/**
+ * Declared only: test binary doesn't link if a stripped statement generates any code
+ * @returns - never returns
+ */
+int NotDefined();
+
+/*
+ @about Check statements below compile-time minimum level generate no code, whatever
+ runtime log level is
+ */
+TEST_F(FixtureLogger, LogMinLevel_StripsStatements)
+{
+   ASSERT_EQ(Debug, Log::GetLogLevel());
+   LOGDBG << NotDefined();
+   LOGWRN << NotDefined();
+   LOG_EVERY_N(Debug, 1) << NotDefined();
+   LOG_RATE_LIMITED(Warning, 100) << NotDefined();
+   LOGERR << "kept";
+   Log::Flush();
+
+   Lines lines = ReadLines(GetFileName());
+   ASSERT_EQ(1u, lines.size());
+   ASSERT_NE(std::string::npos, lines[0].find("\tERR\t"));
+}
+
+} // namespace test
+} // namespace logger
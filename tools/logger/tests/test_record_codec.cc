@@ -0,0 +1,105 @@
+#include "fixture_logger.h"
+#include <logger/record_codec.h>
+// third-party
+#include <string>
+#include <sstream>
+
+namespace
+{
+
+/**
+ * Helper function to count occurrences of the pattern
+ * @param data - data to search in
+ * @param pattern - pattern to search for
+ * @returns - number of occurrences
+ */
+size_t CountOccurrences(const std::string& data, const std::string& pattern)
+{
+   size_t count = 0;
+   for (size_t position = data.find(pattern); position != std::string::npos;
+        position = data.find(pattern, position + 1))
+      ++count;
+   return count;
+}
+
+/**
+ * Helper function to cut the message out of the text log line
+ * @param line - log line
+ * @returns - message, which follows the last delimiter
+ */
+std::string GetMessage(const std::string& line)
+{
+   return line.substr(line.rfind(logger::Delimiter) + 1);
+}
+
+/**
+ * Helper function to cut the fields between date-time stamp and message out of the
+ * text log line
+ * @param line - log line
+ * @returns - thread id, level and function
+ */
+std::string GetFields(const std::string& line)
+{
+   size_t start = line.find(logger::Delimiter);
+   return line.substr(start, line.rfind(logger::Delimiter) - start);
+}
+
+} // unnamed namespace
+
+namespace logger
+{
+namespace test
+{
+
+/*
+ @about Check binary log is decoded to the same text as TextFormat output, every call
+ site is written once, and text file is rotated when format is switched to binary
+ */
+TEST_F(FixtureLogger, BinaryFormat_DecodesToText)
+{
+   LOGWRN << "text message";
+   Log::Flush();
+   Log::SetOutputFormat(BinaryFormat);
+   LOGDBG << "binary " << 42 << ' ' << 2.5 << ' ' << true << ' ' << std::string("string");
+   LOGWRN << "second";
+   LOGEMPTY << "empty";
+   Log::Flush();
+   LOGDBG << "third";
+   Log::Flush();
+
+   Lines textLines = ReadLines(GetBackupFileName(1));
+   ASSERT_EQ(1u, textLines.size());
+   ASSERT_EQ(std::string("text message"), GetMessage(textLines[0]));
+
+   std::string binary = ReadFile(GetFileName());
+   ASSERT_EQ((char)codec::EntryHeader, binary[0]);
+   ASSERT_EQ(0, binary.compare(1, sizeof(codec::FileMagic), codec::FileMagic,
+         sizeof(codec::FileMagic)));
+   // three call sites of this test, each written once
+   ASSERT_EQ(3u, CountOccurrences(binary, "BinaryFormat_DecodesToText_Test"));
+
+   std::istringstream input(binary);
+   std::ostringstream output;
+   ASSERT_TRUE(codec::DecodeLog(input, output));
+   Lines lines;
+   std::istringstream text(output.str());
+   for (std::string line; std::getline(text, line); )
+      lines.push_back(line);
+   ASSERT_EQ(4u, lines.size());
+   ASSERT_EQ(std::string("binary 42 2.5 1 string"), GetMessage(lines[0]));
+   ASSERT_NE(std::string::npos, lines[0].find("\tDBG\t\t"));
+   ASSERT_NE(std::string::npos, lines[0].find("BinaryFormat_DecodesToText_Test::TestBody"));
+   ASSERT_EQ(std::string("second"), GetMessage(lines[1]));
+   ASSERT_EQ(GetFields(textLines[0]), GetFields(lines[1]));
+   ASSERT_EQ(std::string("empty"), lines[2]);
+   ASSERT_EQ(std::string("third"), GetMessage(lines[3]));
+
+   // decoder stops at anything which isn't a binary entry
+   std::istringstream mixed(ReadFile(GetBackupFileName(1)) + binary);
+   ASSERT_FALSE(codec::DecodeLog(mixed, output));
+   std::istringstream truncated(binary.substr(0, binary.size() - 1));
+   ASSERT_FALSE(codec::DecodeLog(truncated, output));
+}
+
+} // namespace test
+} // namespace logger
@@ -0,0 +1,177 @@
+/**
+ *  @file
+ *  \brief     Fragment decryption benchmark
+ *  \details   Measures the cost of encrypted fragment reassembly: decryption by the
+ *             network layer into a temporary buffer followed by fragment append to
+ *             FrameBuffer (the path of ReceivePacket without decryptor), against
+ *             decryption fused into the append (JitterBufferOptions::decryptor). Plain
+ *             append is shown as the baseline. Rate is shown as the line rate one core
+ *             can sustain and as the share of the per-fragment time budget at 10 Gbit/s.
+ *             Usage: benchmark_fragment_decryption [<fragment size> [<fragments>]]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/jitter_buffer/source/frame_buffer.h>
+#include <video_coding/interface/fragment_crypto.h>
+#include <logger/logger.h>
+// third-party
+#include <stdlib.h>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <boost/chrono.hpp>
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/// line rate the budget is computed for (bits per second)
+const double LineRate = 10e9;
+
+/// fragments per frame
+const int FragmentsPerFrame = 100;
+
+/// key of the benchmark stream
+const char Key[] = "0123456789abcdef";
+
+/**
+ * Stage which prepares the fragment before it is appended
+ */
+enum Variant
+{
+   /// fragments are plain
+   PlainAppend,
+   /// fragment is decrypted into a temporary buffer, which is appended
+   DecryptThenAppend,
+   /// FrameBuffer decrypts the fragment into the arena
+   FusedAppend
+};
+
+/**
+ * Prints results of a run
+ * @param name - variant name
+ * @param elapsed - total time
+ * @param fragmentCount - number of fragments processed
+ * @param fragmentSize - size of every fragment payload
+ */
+void Print(const char* name, const Clock::duration elapsed, const int fragmentCount, const int fragmentSize)
+{
+   const double perFragment =
+         boost::chrono::duration<double, boost::nano>(elapsed).count() / fragmentCount;
+   const double budget = fragmentSize * 8 / LineRate * 1e9;
+   std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+         << std::setprecision(1)
+         << std::setw(14) << perFragment
+         << std::setw(14) << fragmentSize * 8 / perFragment
+         << std::setw(14) << perFragment / budget * 100 << std::endl;
+}
+
+/**
+ * Assembles frames of the given fragments and prints results
+ * @param name - variant name
+ * @param variant - stage which prepares the fragment
+ * @param decryptor - key context, ignored for plain fragments
+ * @param fragments - fragments of frame #0, encrypted unless plain
+ * @param fragmentSize - size of every fragment payload
+ * @param fragmentCount - number of fragments to append
+ * @returns - false if a fragment is rejected
+ */
+bool Run(
+   const char* name,
+   const Variant variant,
+   video_coding::IFragmentDecryptor& decryptor,
+   const std::vector<std::vector<char> >& fragments,
+   const int fragmentSize,
+   const int fragmentCount)
+{
+   const video_coding::FrameInfo info;
+   video_coding::IFragmentDecryptor* fused = variant == FusedAppend ? &decryptor : 0;
+   // buffer of the network layer, allocated once
+   std::vector<char> plain(fragmentSize);
+   bool valid = true;
+   Clock::time_point start = Clock::now();
+   for (int frame = 0; frame * FragmentsPerFrame < fragmentCount; ++frame)
+   {
+      video_coding::FrameBufferPtr frameBuffer;
+      for (int i = 0; i < FragmentsPerFrame; ++i)
+      {
+         const char* buffer = &fragments[i][0];
+         int length = (int)fragments[i].size();
+         if (variant == DecryptThenAppend)
+         {
+            length = decryptor.DecryptFragment(buffer, length, 0, i, &plain[0]);
+            valid = length == fragmentSize && valid;
+            buffer = &plain[0];
+         }
+
+         if (!frameBuffer)
+         {
+            frameBuffer.reset( new video_coding::FrameBuffer(buffer, length, 0, i,
+                  FragmentsPerFrame, info, false, fused) );
+         }
+         else
+         {
+            valid = frameBuffer->AppendFragment(buffer, length, i) ==
+                  video_coding::FrameBuffer::FragmentAppended && valid;
+         }
+      }
+      valid = frameBuffer->IsFrameComplete() && valid;
+   }
+   Print(name, Clock::now() - start, fragmentCount / FragmentsPerFrame * FragmentsPerFrame,
+         fragmentSize);
+   return valid;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+   const int fragmentSize = argc > 1 ? ::atoi(argv[1]) : 1200;
+   const int fragmentCount = argc > 2 ? ::atoi(argv[2]) : 1000000;
+   if (fragmentSize <= 0 || fragmentCount < FragmentsPerFrame)
+   {
+      std::cerr << "Usage: " << argv[0] << " [<fragment size> [<fragments>]]" << std::endl;
+      return 1;
+   }
+
+   // debug records of every fragment would dominate the measurement
+   logger::Log::SetLogLevel(logger::Warning);
+
+   boost::shared_ptr<video_coding::IFragmentEncryptor> encryptor =
+         video_coding::CreateAesGcmEncryptor(Key, video_coding::AesGcmKeySize128);
+   boost::shared_ptr<video_coding::IFragmentDecryptor> decryptor =
+         video_coding::CreateAesGcmDecryptor(Key, video_coding::AesGcmKeySize128);
+
+   std::vector<std::vector<char> > plainFragments(FragmentsPerFrame);
+   std::vector<std::vector<char> > encryptedFragments(FragmentsPerFrame);
+   for (int i = 0; i < FragmentsPerFrame; ++i)
+   {
+      plainFragments[i].resize(fragmentSize);
+      for (int j = 0; j < fragmentSize; ++j)
+         plainFragments[i][j] = (char)(i + j * 13);
+      encryptedFragments[i].resize(fragmentSize + encryptor->GetOverhead());
+      encryptor->EncryptFragment(&plainFragments[i][0], fragmentSize, 0, i,
+            &encryptedFragments[i][0]);
+   }
+
+   std::cout << fragmentCount << " fragments of " << fragmentSize << " bytes (AES-128-GCM), "
+         << fragmentSize * 8 / LineRate * 1e9 << " ns per fragment at 10 Gbit/s" << std::endl;
+   std::cout << std::left << std::setw(20) << "variant" << std::right
+         << std::setw(14) << "ns/fragment" << std::setw(14) << "Gbit/s"
+         << std::setw(14) << "% budget" << std::endl;
+
+   bool valid = Run("append plain", PlainAppend, *decryptor, plainFragments, fragmentSize,
+         fragmentCount);
+   valid = Run("decrypt, append", DecryptThenAppend, *decryptor, encryptedFragments,
+         fragmentSize, fragmentCount) && valid;
+   valid = Run("fused decrypt", FusedAppend, *decryptor, encryptedFragments, fragmentSize,
+         fragmentCount) && valid;
+   if (!valid)
+   {
+      std::cerr << "Fragment is rejected" << std::endl;
+      return 1;
+   }
+   return 0;
+}
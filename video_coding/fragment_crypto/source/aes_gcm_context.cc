@@ -0,0 +1,124 @@
+/**
+ *  @file
+ *  \brief     AesGcmContext class implementation
+ *  \details   Holds implementation of the AesGcmContext class based on OpenSSL EVP
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "aes_gcm_context.h"
+#include <video_coding/interface/fragment_crypto.h>
+#include <common/exception_dispatcher.h>
+// third-party
+#include <openssl/evp.h>
+
+namespace
+{
+
+/**
+ * Helper routine to select the cipher by key size
+ * @param keySize - key size in bytes
+ * @returns - the cipher, zero if key size is not supported
+ */
+const EVP_CIPHER* GetCipher(const int keySize)
+{
+   switch (keySize)
+   {
+      case video_coding::AesGcmKeySize128:
+         return EVP_aes_128_gcm();
+      case video_coding::AesGcmKeySize192:
+         return EVP_aes_192_gcm();
+      case video_coding::AesGcmKeySize256:
+         return EVP_aes_256_gcm();
+      default:
+         return 0;
+   }
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+AesGcmContext::AesGcmContext(const char* key, const int keySize, const bool encrypt)
+   : m_context(0)
+{
+   CHECK_ARGUMENT(key != 0, "Key is zero!");
+   const EVP_CIPHER* cipher = GetCipher(keySize);
+   CHECK_ARGUMENT(cipher != 0, "Invalid key size " << keySize);
+
+   m_context = EVP_CIPHER_CTX_new();
+   if (!m_context)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to create cipher context";
+
+   const unsigned char* keyBytes = reinterpret_cast<const unsigned char*>(key);
+   // nonce length is the default one, so it is set per fragment without reinitialization
+   if (EVP_CipherInit_ex(m_context, cipher, 0, keyBytes, 0, encrypt ? 1 : 0) != 1)
+   {
+      EVP_CIPHER_CTX_free(m_context);
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to initialize cipher context";
+   }
+}
+
+AesGcmContext::~AesGcmContext()
+{
+   EVP_CIPHER_CTX_free(m_context);
+}
+
+bool AesGcmContext::Seal(
+   const char* nonce,
+   const char* aad,
+   const char* buffer,
+   const int length,
+   char* output,
+   char* tag)
+{
+   int written = 0;
+   int finalWritten = 0;
+   return EVP_EncryptInit_ex(m_context, 0, 0, 0,
+            reinterpret_cast<const unsigned char*>(nonce)) == 1 &&
+         EVP_EncryptUpdate(m_context, 0, &written,
+            reinterpret_cast<const unsigned char*>(aad), AesGcmAadSize) == 1 &&
+         EVP_EncryptUpdate(m_context, reinterpret_cast<unsigned char*>(output), &written,
+            reinterpret_cast<const unsigned char*>(buffer), length) == 1 &&
+         EVP_EncryptFinal_ex(m_context, reinterpret_cast<unsigned char*>(output) + written,
+            &finalWritten) == 1 &&
+         EVP_CIPHER_CTX_ctrl(m_context, EVP_CTRL_GCM_GET_TAG, AesGcmTagSize, tag) == 1;
+}
+
+bool AesGcmContext::Open(
+   const char* nonce,
+   const char* aad,
+   const char* buffer,
+   const int length,
+   const char* tag,
+   char* output)
+{
+   int written = 0;
+   int finalWritten = 0;
+   // tag is checked by the final call, output is discarded by the caller on mismatch
+   return EVP_DecryptInit_ex(m_context, 0, 0, 0,
+            reinterpret_cast<const unsigned char*>(nonce)) == 1 &&
+         EVP_DecryptUpdate(m_context, 0, &written,
+            reinterpret_cast<const unsigned char*>(aad), AesGcmAadSize) == 1 &&
+         EVP_DecryptUpdate(m_context, reinterpret_cast<unsigned char*>(output), &written,
+            reinterpret_cast<const unsigned char*>(buffer), length) == 1 &&
+         EVP_CIPHER_CTX_ctrl(m_context, EVP_CTRL_GCM_SET_TAG, AesGcmTagSize,
+            const_cast<char*>(tag)) == 1 &&
+         EVP_DecryptFinal_ex(m_context, reinterpret_cast<unsigned char*>(output) + written,
+            &finalWritten) == 1;
+}
+
+void WriteAesGcmAad(const int frameNumber, const int fragmentNumber, char* aad)
+{
+   aad[0] = (char)(frameNumber >> 24);
+   aad[1] = (char)(frameNumber >> 16);
+   aad[2] = (char)(frameNumber >> 8);
+   aad[3] = (char)frameNumber;
+   aad[4] = (char)(fragmentNumber >> 24);
+   aad[5] = (char)(fragmentNumber >> 16);
+   aad[6] = (char)(fragmentNumber >> 8);
+   aad[7] = (char)fragmentNumber;
+}
+
+} // namespace video_coding
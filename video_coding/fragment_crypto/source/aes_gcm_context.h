@@ -0,0 +1,91 @@
+/**
+ *  @file
+ *  \brief     AesGcmContext class declaration
+ *  \details   Holds declaration of the AesGcmContext class and the fragment wire format
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_AES_GCM_CONTEXT_H
+#define VIDEO_CODING_AES_GCM_CONTEXT_H
+
+// third-party
+#include <boost/noncopyable.hpp>
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+namespace video_coding
+{
+
+/// size of the nonce which precedes the ciphertext
+const int AesGcmNonceSize = 12;
+/// size of the authentication tag which follows the ciphertext
+const int AesGcmTagSize = 16;
+/// size of the additional authenticated data: frame number (32 bits) and fragment
+/// number (32 bits), both in network byte order
+const int AesGcmAadSize = 8;
+
+/**
+ * AesGcmContext class owns OpenSSL cipher context with the key schedule expanded once,
+ * so that every fragment only sets its nonce. OpenSSL picks AES-NI and carry-less
+ * multiplication (or the platform equivalent) at run time
+ */
+class AesGcmContext : boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. Throws std::exception on invalid key size or OpenSSL error
+    * @param key - key bytes
+    * @param keySize - one of AesGcmKeySize values
+    * @param encrypt - true for encryption context, false for decryption one
+    */
+   AesGcmContext(const char* key, int keySize, bool encrypt);
+
+   /**
+    * Destructor. Wipes the key schedule
+    */
+   ~AesGcmContext();
+
+   /**
+    * Encrypts the data. Does not throw
+    * @param nonce - AesGcmNonceSize bytes
+    * @param aad - AesGcmAadSize bytes
+    * @param buffer - plain data
+    * @param length - length of the plain data
+    * @param output - out parameter, length bytes of ciphertext
+    * @param tag - out parameter, AesGcmTagSize bytes
+    * @returns - false on OpenSSL error
+    */
+   bool Seal(const char* nonce, const char* aad, const char* buffer, int length,
+      char* output, char* tag);
+
+   /**
+    * Authenticates and decrypts the data. Does not throw
+    * @param nonce - AesGcmNonceSize bytes
+    * @param aad - AesGcmAadSize bytes
+    * @param buffer - ciphertext
+    * @param length - length of the ciphertext
+    * @param tag - AesGcmTagSize bytes
+    * @param output - out parameter, length bytes of plain data
+    * @returns - false if authentication fails
+    */
+   bool Open(const char* nonce, const char* aad, const char* buffer, int length,
+      const char* tag, char* output);
+
+private:
+   /// OpenSSL cipher context
+   EVP_CIPHER_CTX*   m_context;
+};
+
+/**
+ * Helper routine to fill in the additional authenticated data of a fragment
+ * @param frameNumber - frame number that fragment belongs to
+ * @param fragmentNumber - fragment number
+ * @param aad - out parameter, AesGcmAadSize bytes
+ */
+void WriteAesGcmAad(int frameNumber, int fragmentNumber, char* aad);
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_AES_GCM_CONTEXT_H
@@ -0,0 +1,42 @@
+/**
+ *  @file
+ *  \brief     AesGcmDecryptorImpl class implementation
+ *  \details   Holds implementation of the IFragmentDecryptor interface with AES-GCM
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "aes_gcm_decryptor_impl.h"
+
+namespace video_coding
+{
+
+AesGcmDecryptorImpl::AesGcmDecryptorImpl(const char* key, const int keySize)
+   : m_context(key, keySize, false)
+{}
+
+int AesGcmDecryptorImpl::GetOverhead() const
+{
+   return AesGcmNonceSize + AesGcmTagSize;
+}
+
+int AesGcmDecryptorImpl::DecryptFragment(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   char* output)
+{
+   const int plainLength = length - GetOverhead();
+   if (plainLength < 0)
+      return -1;
+
+   char aad[AesGcmAadSize];
+   WriteAesGcmAad(frameNumber, fragmentNumber, aad);
+   const char* ciphertext = buffer + AesGcmNonceSize;
+   if (!m_context.Open(buffer, aad, ciphertext, plainLength, ciphertext + plainLength, output))
+      return -1;
+   return plainLength;
+}
+
+} // namespace video_coding
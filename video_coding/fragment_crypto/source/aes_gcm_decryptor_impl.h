@@ -0,0 +1,56 @@
+/**
+ *  @file
+ *  \brief     AesGcmDecryptorImpl class declaration
+ *  \details   Holds declaration of the IFragmentDecryptor interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_AES_GCM_DECRYPTOR_IMPL_H
+#define VIDEO_CODING_AES_GCM_DECRYPTOR_IMPL_H
+
+#include <video_coding/interface/fragment_crypto.h>
+#include "aes_gcm_context.h"
+
+namespace video_coding
+{
+
+/**
+ * AesGcmDecryptorImpl class
+ * Implements interface IFragmentDecryptor with AES-GCM, see CreateAesGcmDecryptor
+ */
+class AesGcmDecryptorImpl : public IFragmentDecryptor
+{
+public:
+
+   /**
+    * Constructor. For more details see CreateAesGcmDecryptor
+    */
+   AesGcmDecryptorImpl(const char* key, int keySize);
+
+   /**
+    * IFragmentDecryptor interface method implementation. For more details see
+    * IFragmentDecryptor interface.
+    */
+   virtual int GetOverhead() const;
+
+   /**
+    * IFragmentDecryptor interface method implementation. Ciphertext is decrypted
+    * straight into the output, tag is checked afterwards. For more details see
+    * IFragmentDecryptor interface.
+    */
+   virtual int DecryptFragment(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      char* output);
+
+private:
+   /// decryption context holding the key
+   AesGcmContext     m_context;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_AES_GCM_DECRYPTOR_IMPL_H
@@ -0,0 +1,55 @@
+/**
+ *  @file
+ *  \brief     AesGcmEncryptorImpl class implementation
+ *  \details   Holds implementation of the IFragmentEncryptor interface with AES-GCM
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "aes_gcm_encryptor_impl.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#include <string.h>
+#include <openssl/rand.h>
+
+namespace video_coding
+{
+
+AesGcmEncryptorImpl::AesGcmEncryptorImpl(const char* key, const int keySize)
+   : m_context(key, keySize, true)
+   , m_counter(0)
+{
+   if (RAND_bytes(m_salt, sizeof(m_salt)) != 1)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to generate nonce salt";
+}
+
+int AesGcmEncryptorImpl::GetOverhead() const
+{
+   return AesGcmNonceSize + AesGcmTagSize;
+}
+
+int AesGcmEncryptorImpl::EncryptFragment(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   char* output)
+{
+   if (length < 0)
+      return -1;
+
+   // nonce must never repeat for the key, hence the counter rather than fragment position
+   ::memcpy(output, m_salt, sizeof(m_salt));
+   for (int i = 0; i < 8; ++i)
+      output[sizeof(m_salt) + i] = (char)(m_counter >> (56 - 8 * i));
+   ++m_counter;
+
+   char aad[AesGcmAadSize];
+   WriteAesGcmAad(frameNumber, fragmentNumber, aad);
+   char* ciphertext = output + AesGcmNonceSize;
+   if (!m_context.Seal(output, aad, buffer, length, ciphertext, ciphertext + length))
+      return -1;
+   return length + GetOverhead();
+}
+
+} // namespace video_coding
@@ -0,0 +1,62 @@
+/**
+ *  @file
+ *  \brief     AesGcmEncryptorImpl class declaration
+ *  \details   Holds declaration of the IFragmentEncryptor interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_AES_GCM_ENCRYPTOR_IMPL_H
+#define VIDEO_CODING_AES_GCM_ENCRYPTOR_IMPL_H
+
+#include <video_coding/interface/fragment_crypto.h>
+#include "aes_gcm_context.h"
+// third-party
+#include <boost/cstdint.hpp>
+
+namespace video_coding
+{
+
+/**
+ * AesGcmEncryptorImpl class
+ * Implements interface IFragmentEncryptor with AES-GCM, see CreateAesGcmEncryptor
+ */
+class AesGcmEncryptorImpl : public IFragmentEncryptor
+{
+public:
+
+   /**
+    * Constructor. Draws the nonce salt from OpenSSL random generator. For more details
+    * see CreateAesGcmEncryptor
+    */
+   AesGcmEncryptorImpl(const char* key, int keySize);
+
+   /**
+    * IFragmentEncryptor interface method implementation. For more details see
+    * IFragmentEncryptor interface.
+    */
+   virtual int GetOverhead() const;
+
+   /**
+    * IFragmentEncryptor interface method implementation. For more details see
+    * IFragmentEncryptor interface.
+    */
+   virtual int EncryptFragment(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      char* output);
+
+private:
+   /// encryption context holding the key
+   AesGcmContext     m_context;
+   /// random leading part of every nonce, distinguishes encryptors sharing the key
+   unsigned char     m_salt[AesGcmNonceSize - 8];
+   /// number of fragments encrypted, trailing part of the nonce
+   boost::uint64_t   m_counter;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_AES_GCM_ENCRYPTOR_IMPL_H
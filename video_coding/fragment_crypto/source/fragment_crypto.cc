@@ -0,0 +1,31 @@
+/**
+ *  @file
+ *  \brief     Fragment encryption factories implementation
+ *  \details   Holds implementation of factory methods that can be used to create AES-GCM
+ *             fragment decryptor and encryptor
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/interface/fragment_crypto.h>
+#include "aes_gcm_decryptor_impl.h"
+#include "aes_gcm_encryptor_impl.h"
+
+namespace video_coding
+{
+
+boost::shared_ptr<IFragmentDecryptor> CreateAesGcmDecryptor(const char* key, const int keySize)
+{
+   boost::shared_ptr<IFragmentDecryptor> decryptor;
+   decryptor.reset( new AesGcmDecryptorImpl(key, keySize) );
+   return decryptor;
+}
+
+boost::shared_ptr<IFragmentEncryptor> CreateAesGcmEncryptor(const char* key, const int keySize)
+{
+   boost::shared_ptr<IFragmentEncryptor> encryptor;
+   encryptor.reset( new AesGcmEncryptorImpl(key, keySize) );
+   return encryptor;
+}
+
+} // namespace video_coding
@@ -0,0 +1,149 @@
+#include <video_coding/interface/fragment_crypto.h>
+#include <video_coding/interface/jitter_buffer.h>
+#include <video_coding/jitter_buffer/tests/stubs/stub_decoder.h>
+#include <video_coding/jitter_buffer/tests/stubs/stub_renderer.h>
+#include <logger/logger.h>
+// third-party
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace
+{
+
+/// key shared by both sides in tests
+const char Key[] = "0123456789abcdef0123456789abcdef";
+
+/**
+ * Helper routine to encrypt the fragment
+ * @param encryptor - sending side key context
+ * @param payload - plain fragment
+ * @param frameNumber, fragmentNumber - fragment position
+ * @returns - encrypted fragment
+ */
+std::string Encrypt(
+   video_coding::IFragmentEncryptor& encryptor,
+   const std::string& payload,
+   const int frameNumber,
+   const int fragmentNumber)
+{
+   std::vector<char> output(payload.length() + encryptor.GetOverhead());
+   int length = encryptor.EncryptFragment(payload.c_str(), (int)payload.length(),
+         frameNumber, fragmentNumber, &output[0]);
+   return std::string(&output[0], length > 0 ? length : 0);
+}
+
+/**
+ * Helper routine to decrypt the fragment
+ * @param decryptor - receiving side key context
+ * @param fragment - encrypted fragment
+ * @param frameNumber, fragmentNumber - fragment position
+ * @param payload - out parameter, plain fragment
+ * @returns - true if fragment is authenticated
+ */
+bool Decrypt(
+   video_coding::IFragmentDecryptor& decryptor,
+   const std::string& fragment,
+   const int frameNumber,
+   const int fragmentNumber,
+   std::string& payload)
+{
+   std::vector<char> output(fragment.length() + 1);
+   int length = decryptor.DecryptFragment(fragment.c_str(), (int)fragment.length(),
+         frameNumber, fragmentNumber, &output[0]);
+   if (length < 0)
+      return false;
+   payload.assign(&output[0], length);
+   return true;
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+namespace test
+{
+
+/*
+ @about Check fragments are decrypted with any key size, and tampered data, wrong
+ position or wrong key fail authentication
+ */
+TEST(FragmentCrypto, AesGcm_AuthenticatesFragments)
+{
+   const int keySizes[] = { AesGcmKeySize128, AesGcmKeySize192, AesGcmKeySize256 };
+   for (size_t i = 0; i < sizeof(keySizes) / sizeof(keySizes[0]); ++i)
+   {
+      boost::shared_ptr<IFragmentEncryptor> encryptor = CreateAesGcmEncryptor(Key, keySizes[i]);
+      boost::shared_ptr<IFragmentDecryptor> decryptor = CreateAesGcmDecryptor(Key, keySizes[i]);
+      ASSERT_EQ(28, encryptor->GetOverhead());
+      ASSERT_EQ(28, decryptor->GetOverhead());
+
+      std::string fragment = Encrypt(*encryptor, "payload", 5, 1);
+      ASSERT_EQ(35u, fragment.length());
+      // nonce is never reused
+      ASSERT_NE(fragment, Encrypt(*encryptor, "payload", 5, 1));
+
+      std::string payload;
+      ASSERT_TRUE(Decrypt(*decryptor, fragment, 5, 1, payload));
+      ASSERT_EQ(std::string("payload"), payload);
+      ASSERT_FALSE(Decrypt(*decryptor, fragment, 5, 2, payload));
+      ASSERT_FALSE(Decrypt(*decryptor, fragment, 6, 1, payload));
+      ASSERT_FALSE(Decrypt(*decryptor, fragment.substr(0, 27), 5, 1, payload));
+      for (size_t j = 0; j < fragment.length(); j += 7)
+      {
+         std::string tampered = fragment;
+         tampered[j] ^= 0x20;
+         ASSERT_FALSE(Decrypt(*decryptor, tampered, 5, 1, payload));
+      }
+
+      ASSERT_TRUE(Decrypt(*decryptor, Encrypt(*encryptor, "", 0, 0), 0, 0, payload));
+      ASSERT_TRUE(payload.empty());
+   }
+
+   boost::shared_ptr<IFragmentDecryptor> otherKey = CreateAesGcmDecryptor(Key + 1, 16);
+   std::string payload;
+   ASSERT_FALSE(Decrypt(*otherKey, Encrypt(*CreateAesGcmEncryptor(Key, 16), "ab", 0, 0),
+         0, 0, payload));
+
+   ASSERT_THROW(CreateAesGcmDecryptor(Key, 20), std::exception);
+   ASSERT_THROW(CreateAesGcmEncryptor(0, 16), std::exception);
+}
+
+/*
+ @about Check JitterBuffer decrypts fragments into the frame and drops the ones that
+ fail authentication
+ */
+TEST(FragmentCrypto, JitterBuffer_DecryptsFragments)
+{
+   logger::Log::SetLogLevel(logger::Warning);
+   boost::shared_ptr<IFragmentEncryptor> encryptor = CreateAesGcmEncryptor(Key, 32);
+   boost::shared_ptr<IFragmentDecryptor> decryptor = CreateAesGcmDecryptor(Key, 32);
+   StubDecoder decoder;
+   StubRenderer renderer;
+   JitterBufferOptions options;
+   options.decryptor = decryptor.get();
+   boost::shared_ptr<IJitterBuffer> jitterBuffer =
+         CreateJitterBuffer(&decoder, &renderer, options);
+
+   std::string fragment = Encrypt(*encryptor, "me0", 0, 1);
+   ASSERT_EQ(result_code::sOk, jitterBuffer->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 1, 2));
+   fragment = Encrypt(*encryptor, "frame1", 1, 0);
+   ASSERT_EQ(result_code::sOk, jitterBuffer->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 1, 0, 1));
+   ASSERT_EQ(result_code::eInvalidArgument, jitterBuffer->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 2, 0, 1));
+   fragment = Encrypt(*encryptor, "fra", 0, 0);
+   fragment[fragment.length() - 1] ^= 1;
+   ASSERT_EQ(result_code::eInvalidArgument, jitterBuffer->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 0, 2));
+   fragment = Encrypt(*encryptor, "fra", 0, 0);
+   ASSERT_EQ(result_code::sOk, jitterBuffer->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 0, 2));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("frame0frame1"), renderer.GetRenderedData());
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().corruptFragments);
+}
+
+} // namespace test
+} // namespace video_coding
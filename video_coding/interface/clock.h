@@ -0,0 +1,104 @@
+/**
+ *  @file
+ *  \brief     video_coding::IClock interface
+ *  \details   Holds declaration of the IClock and ISimulatedClock interfaces. Every wait and
+ *             timestamp inside JitterBuffer goes through the clock, which allows running
+ *             the component on simulated time (deterministic, faster than real time)
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_CLOCK_H
+#define VIDEO_CODING_CLOCK_H
+
+// third-party
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace video_coding
+{
+
+/// time value in microseconds. Origin is defined by the clock implementation
+typedef boost::int64_t TimeUs;
+
+class IClock;
+class ISimulatedClock;
+
+/**
+ * Accessor to the process-wide clock backed by the monotonic system time.
+ * Used by JitterBuffer when no other clock is provided by the caller
+ *
+ * @returns - raw pointer to the system clock, never zero. Lifespan is handled internally
+ */
+IClock* GetSystemClock();
+
+/**
+ * Factory function which creates a clock with manually driven time. Time does not
+ * move unless ISimulatedClock::AdvanceTime is called
+ *
+ * @param startTime - initial value of the simulated time
+ * @returns - shared_ptr holding pointer to the newly created simulated clock
+ */
+boost::shared_ptr<ISimulatedClock> CreateSimulatedClock(TimeUs startTime = 0);
+
+/**
+ * IClock interface. Provides current time and timed waits on a condition variable
+ * measured against the very same time source
+ */
+class IClock
+{
+public:
+   typedef boost::unique_lock<boost::mutex> Lock;
+
+   /**
+    * Accessor to get current time
+    * @returns - current time in microseconds
+    */
+   virtual TimeUs GetTime() = 0;
+
+   /**
+    * Blocks on the condition variable until it is notified or the deadline is reached.
+    * Same contract as boost::condition_variable::timed_wait: lock must be held by the
+    * caller, it is released while waiting and re-acquired before return. Spurious
+    * wake-ups are possible so the caller must re-check its predicate.
+    *
+    * @param lock - lock held on the mutex associated with the condition
+    * @param condition - condition variable to wait on
+    * @param deadline - absolute time (in terms of this clock) to wait until
+    * @returns - false if deadline has been reached, true otherwise
+    */
+   virtual bool WaitUntil(Lock& lock, boost::condition_variable& condition, TimeUs deadline) = 0;
+
+   /**
+    * Helper method, same as WaitUntil but with relative timeout
+    * @param timeout - time to wait (in microseconds) starting from now
+    */
+   bool WaitFor(Lock& lock, boost::condition_variable& condition, TimeUs timeout)
+   {
+      return WaitUntil(lock, condition, GetTime() + timeout);
+   }
+
+   virtual ~IClock() {}
+};
+
+/**
+ * ISimulatedClock interface. Clock which time is driven manually by the owner, mainly
+ * by tests and benchmarks. Threads blocked in WaitUntil are woken up as soon as the
+ * time is advanced past their deadline.
+ */
+class ISimulatedClock : public IClock
+{
+public:
+
+   /**
+    * Moves the simulated time forward and wakes up all waiters
+    * @param delta - time (in microseconds) to add to current time, must be non-negative
+    */
+   virtual void AdvanceTime(TimeUs delta) = 0;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_CLOCK_H
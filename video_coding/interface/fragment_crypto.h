@@ -0,0 +1,123 @@
+/**
+ *  @file
+ *  \brief     Fragment encryption interfaces
+ *  \details   Holds declaration of IFragmentDecryptor interface, which lets JitterBuffer
+ *             authenticate and decrypt fragments while they are written into the frame,
+ *             and IFragmentEncryptor interface for the sending side
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_FRAGMENT_CRYPTO_H
+#define VIDEO_CODING_FRAGMENT_CRYPTO_H
+
+// third-party
+#include <boost/shared_ptr.hpp>
+
+namespace video_coding
+{
+
+/**
+ * Key context used by JitterBuffer to decrypt fragments, see
+ * JitterBufferOptions::decryptor. Fragment position (frame and fragment numbers) is
+ * authenticated along with the payload, so a fragment replayed at another position
+ * fails authentication. JitterBuffer serializes the calls
+ */
+class IFragmentDecryptor
+{
+public:
+
+   /**
+    * Accessor to get the number of bytes encryption adds to every fragment. Does not
+    * throw
+    * @returns - difference between encrypted and plain fragment length
+    */
+   virtual int GetOverhead() const = 0;
+
+   /**
+    * Authenticates and decrypts one fragment. Does not throw
+    * @param buffer - encrypted fragment
+    * @param length - length of the encrypted fragment, longer than GetOverhead
+    * @param frameNumber - frame number that fragment belongs to
+    * @param fragmentNumber - fragment number
+    * @param output - out parameter, at least length - GetOverhead bytes. Contents are
+    *                 undefined if fragment fails authentication
+    * @returns - length of the plain fragment, negative if fragment fails authentication
+    */
+   virtual int DecryptFragment(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      char* output) = 0;
+
+   ~IFragmentDecryptor() {}
+};
+
+/**
+ * Key context of the sending side, produces fragments accepted by the IFragmentDecryptor
+ * with the same key. Not thread-safe
+ */
+class IFragmentEncryptor
+{
+public:
+
+   /**
+    * Accessor to get the number of bytes encryption adds to every fragment. Does not
+    * throw
+    * @returns - difference between encrypted and plain fragment length
+    */
+   virtual int GetOverhead() const = 0;
+
+   /**
+    * Encrypts one fragment. Does not throw
+    * @param buffer - plain fragment
+    * @param length - length of the plain fragment
+    * @param frameNumber - frame number that fragment belongs to
+    * @param fragmentNumber - fragment number
+    * @param output - out parameter, at least length + GetOverhead bytes
+    * @returns - length of the encrypted fragment, negative on internal error
+    */
+   virtual int EncryptFragment(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      char* output) = 0;
+
+   ~IFragmentEncryptor() {}
+};
+
+/// size of AES-GCM key in bytes: AES-128, AES-192 or AES-256
+const int AesGcmKeySize128 = 16;
+const int AesGcmKeySize192 = 24;
+const int AesGcmKeySize256 = 32;
+
+/**
+ * Factory function which creates AES-GCM decryptor. Encrypted fragment is a 12-byte
+ * nonce, the ciphertext and a 16-byte authentication tag. Frame and fragment numbers
+ * are authenticated as additional data. AES-NI (or the platform equivalent) is used
+ * where supported. Caller must be prepared to handle std::exception thrown in case of
+ * invalid input arguments
+ *
+ * @param key - key bytes
+ * @param keySize - one of AesGcmKeySize values
+ * @returns - shared_ptr holding pointer to the decryptor
+ */
+boost::shared_ptr<IFragmentDecryptor> CreateAesGcmDecryptor(const char* key, int keySize);
+
+/**
+ * Factory function which creates AES-GCM encryptor, see CreateAesGcmDecryptor. Nonce
+ * is a random salt followed by a counter of encrypted fragments, so the same key may
+ * be used by the encryptor for up to 2^64 fragments. Caller must be prepared to handle
+ * std::exception thrown in case of invalid input arguments
+ *
+ * @param key - key bytes
+ * @param keySize - one of AesGcmKeySize values
+ * @returns - shared_ptr holding pointer to the encryptor
+ */
+boost::shared_ptr<IFragmentEncryptor> CreateAesGcmEncryptor(const char* key, int keySize);
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_FRAGMENT_CRYPTO_H
@@ -0,0 +1,61 @@
+/**
+ *  @file
+ *  \brief     video_coding::FrameInfo structure
+ *  \details   Holds declaration of the optional frame metadata which can be passed to
+ *             JitterBuffer along with the packet. Metadata describes inter-frame
+ *             dependencies and lets JitterBuffer decide which frames are disposable
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_FRAME_INFO_H
+#define VIDEO_CODING_FRAME_INFO_H
+
+#include "clock.h"
+
+namespace video_coding
+{
+
+/**
+ * Type of the frame in terms of inter-frame dependencies
+ */
+enum FrameType
+{
+   /// independently decodable frame, frames following it never refer to frames before it
+   KeyFrame,
+   /// frame which may be referenced by the following frames
+   ReferenceFrame,
+   /// frame which is never referenced, can be dropped without affecting other frames
+   NonReferenceFrame
+};
+
+/**
+ * Frame metadata. Must be identical for all fragments of the frame. Default-constructed
+ * instance describes a frame predicted from the previous one, which is what JitterBuffer
+ * assumes for packets received without metadata
+ */
+struct FrameInfo
+{
+   /**
+    * Constructor. Fills in default values
+    */
+   FrameInfo();
+
+   /// type of the frame
+   FrameType   type;
+   /// number of the frame this one is predicted from, ignored for key frames. Negative
+   /// value means the previous frame in sequence
+   int         dependencyFrameNumber;
+   /// presentation time of the frame (microseconds, arbitrary origin), used for render
+   /// pacing. Negative value means unknown
+   TimeUs      timestamp;
+   /// flag, indicates decoder neither needs nor changes reference state to decode the
+   /// frame (e.g. every frame of an intra-only stream), so it can be decoded out of
+   /// order, see JitterBufferOptions::decodeAhead. Key frame alone is not enough, as
+   /// decoding it replaces the references of the frames before it
+   bool        independent;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_FRAME_INFO_H
@@ -9,6 +9,13 @@
 #ifndef VIDEO_CODING_JITTER_BUFFER_H
 #define VIDEO_CODING_JITTER_BUFFER_H
 
+#include "clock.h"
+#include "frame_info.h"
+#include "fragment_crypto.h"
+#include <common/result_code.h>
+// third-party
+#include <vector>
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
 
 namespace video_engine
@@ -25,6 +32,285 @@ using video_engine::IRenderer;
 
 class IJitterBuffer;
 
+/**
+ * What JitterBuffer does when decode queue (completed frames waiting for decoder)
+ * exceeds its capacity or latency target, see JitterBufferOptions
+ */
+enum BackpressurePolicy
+{
+   /// oldest frames are dropped from decode queue regardless of their type,
+   /// decoder is expected to conceal missing references
+   DropOldest,
+   /// frames are dropped from decode queue together with every frame depending on
+   /// them, so decoding resumes from the next key frame. Requires frame metadata
+   /// (see FrameInfo), otherwise the stream never resumes
+   DropToKeyFrame,
+   /// nothing is dropped, fragments starting new frames are rejected with OutOfSpace
+   /// result code until decode queue is back within limits. Frames which are already
+   /// being received can still complete, so the queue may temporarily exceed capacity
+   SignalProducer
+};
+
+/**
+ * How JitterBuffer worker threads wait for work, see JitterBufferOptions. Applies to
+ * waits for new fragments, frames and free render slots; timed waits (frame deadlines,
+ * render pacing) always block
+ */
+enum WaitStrategy
+{
+   /// threads block on condition variable until notified
+   BlockingWait,
+   /// threads busy-spin until notified and never give up their CPUs. Intended for
+   /// threads pinned to dedicated cores, see ThreadPlacement
+   BusySpinWait,
+   /// threads spin for JitterBufferOptions::spinTime, then block until notified
+   SpinThenParkWait
+};
+
+/**
+ * Placement and scheduling of a JitterBuffer worker thread, see JitterBufferOptions.
+ * Applied by the thread itself when it starts, before it allocates its buffers, so
+ * with the default first-touch memory policy the buffers come from the NUMA node of
+ * the chosen CPUs. Frame buffers holding received fragments are allocated by the
+ * thread passing packets in, so they follow its placement instead. Supported on Linux
+ * only, ignored on other platforms. Failure to apply (e.g. no permission for real-time
+ * scheduling) is logged and the thread keeps default placement
+ */
+struct ThreadPlacement
+{
+   /**
+    * Constructor. Fills in default values
+    */
+   ThreadPlacement();
+
+   /// CPUs the thread is allowed to run on. Empty means no restriction
+   std::vector<int>     cpus;
+   /// SCHED_FIFO priority of the thread (1 - 99). Zero means default scheduling policy
+   int                  realtimePriority;
+};
+
+/// size of the checksum trailer of a fragment, see JitterBufferOptions
+const int FragmentChecksumSize = 4;
+
+/**
+ * Helper function for the sending side: computes the fragment checksum, CRC32C of the
+ * fragment payload. Checksum is appended to the payload in little-endian byte order.
+ * Does not throw
+ * @param buffer - fragment payload
+ * @param length - payload length
+ * @returns - the checksum
+ */
+boost::uint32_t ComputeFragmentChecksum(const char* buffer, int length);
+
+/**
+ * Optional settings of the IJitterBuffer component. Default-constructed instance
+ * gives the same behavior as CreateJitterBuffer without options
+ */
+struct JitterBufferOptions
+{
+   /**
+    * Constructor. Fills in default values
+    */
+   JitterBufferOptions();
+
+   /// clock to be used for every wait and timestamp inside the component. Stored as raw
+   /// pointer, lifespan must be handled by external caller. System clock is used if zero
+   IClock*              clock;
+
+   /// number of completed frames waiting for decoder above which frames are shed
+   /// (see FrameInfo). Zero disables depth-based shedding
+   int                  sheddingQueueDepth;
+   /// time since completion of the oldest frame waiting for decoder (microseconds)
+   /// above which frames are shed. Zero disables lag-based shedding
+   TimeUs               sheddingLag;
+
+   /// maximum number of completed frames waiting for decoder. Zero means unbounded
+   int                  decodeQueueCapacity;
+   /// maximum time a completed frame may wait for decoder (microseconds). Zero means
+   /// unbounded
+   TimeUs               latencyTarget;
+   /// what to do when either of the limits above is exceeded
+   BackpressurePolicy   backpressurePolicy;
+
+   /// enables render pacing if positive: decoded frames are passed to renderer at the
+   /// cadence given by frame timestamps (see FrameInfo), this frame rate (frames per
+   /// second) is used for frames without timestamps. Frames which are late by more than
+   /// one frame interval are skipped if a newer frame is already available. Zero means
+   /// frames are rendered as soon as they are decoded
+   double               renderFrameRate;
+
+   /// enables streaming decode: decoder must implement video_engine::IStreamingDecoder.
+   /// While decoder is idle, the contiguous leading part of the next frame is passed
+   /// to it as soon as fragments arrive, so decoding overlaps with frame reception
+   bool                 streamingDecode;
+
+   /// enables decode-ahead: while decoder is idle, complete frames flagged as
+   /// independent (see FrameInfo::independent) waiting behind an incomplete frame are
+   /// decoded at once and rendered in order when their turn comes. Other frames,
+   /// including key frames, are decoded in sequence only
+   bool                 decodeAhead;
+
+   /// time (microseconds) the next frame in sequence is waited for, counted from the
+   /// arrival of its first fragment (or of the first fragment of the following frame if
+   /// nothing of it has arrived). When it expires, the missing frame is skipped and the
+   /// incomplete one is either dropped or passed to concealing decoder. Zero means
+   /// frames are waited for until they complete
+   TimeUs               frameDeadline;
+   /// enables decoding of incomplete frames at deadline: decoder must implement
+   /// video_engine::IConcealingDecoder
+   bool                 decodeIncompleteFrames;
+
+   /// placement of the recycler thread, which reassembles and orders frames
+   ThreadPlacement      recyclerPlacement;
+   /// placement of the decoder thread, which also renders if render pacing is disabled
+   ThreadPlacement      decoderPlacement;
+   /// placement of the render thread, used if render pacing is enabled
+   ThreadPlacement      renderPlacement;
+
+   /// how worker threads wait for work. Spinning saves condition variable wake-up
+   /// latency at the cost of CPU time
+   WaitStrategy         waitStrategy;
+   /// time (microseconds, real time) worker threads spin before blocking in
+   /// SpinThenParkWait mode
+   TimeUs               spinTime;
+
+   /// enables fragment integrity check: every fragment passed to JB ends with
+   /// FragmentChecksumSize bytes of its checksum (see ComputeFragmentChecksum), which
+   /// is verified while the fragment is copied and stripped. Fragments which don't
+   /// match are rejected with InvalidArgument result code and counted as corrupt, so
+   /// they never reach decoder
+   bool                 verifyFragmentChecksum;
+
+   /// key context of encrypted streams: every fragment passed to JB is authenticated
+   /// and decrypted while it is written into the frame, so the payload is read once.
+   /// Fragments which fail authentication are rejected with InvalidArgument result code
+   /// and counted as corrupt. Stored as raw pointer, lifespan must be handled by
+   /// external caller. Fragments are passed as is if zero. Not compatible with
+   /// verifyFragmentChecksum, as authentication covers integrity
+   IFragmentDecryptor*  decryptor;
+
+   /// enables pull mode: JB starts no worker threads, the owner takes completed frames
+   /// on its own thread (e.g. event loop) by IJitterBuffer::DecodeNext or
+   /// IJitterBuffer::TryGetNextFrame when readiness descriptor is signaled (see
+   /// IJitterBuffer::GetReadinessDescriptor). Frame deadline, backpressure and shedding
+   /// are applied when a frame is taken, so with frameDeadline the owner loop uses
+   /// IJitterBuffer::GetNextDeadline as its poll timeout and calls them when it expires
+   /// too. Not compatible with streaming decode, decode-ahead, decoding of
+   /// incomplete frames and render pacing, which need worker threads. Wait strategy
+   /// and thread placement are ignored
+   bool                 pullMode;
+};
+
+/**
+ * Completed frame taken from JB undecoded in pull mode, see IJitterBuffer::TryGetNextFrame
+ */
+struct PulledFrame
+{
+   /**
+    * Constructor. Fills in default values
+    */
+   PulledFrame();
+
+   /// frame number
+   int                  frameNumber;
+   /// type of the frame, see FrameInfo
+   FrameType            type;
+   /// presentation time of the frame, negative if unknown
+   TimeUs               timestamp;
+   /// assembled frame data. Instance reused by the caller keeps the allocation, so a
+   /// steady stream is taken without allocations
+   std::vector<char>    data;
+};
+
+/**
+ * Snapshot of the IJitterBuffer counters. Every counter is accumulated since
+ * the component creation
+ */
+struct JitterBufferStatistics
+{
+   /**
+    * Constructor. Resets all counters
+    */
+   JitterBufferStatistics();
+
+   /// fragments accepted and stored for reassembly
+   boost::uint64_t   receivedFragments;
+   /// retransmitted fragments rejected as duplicates
+   boost::uint64_t   duplicateFragments;
+   /// fragments of frames which are already passed to decoder
+   boost::uint64_t   lateFragments;
+   /// packets rejected with InvalidArgument result code
+   boost::uint64_t   invalidPackets;
+   /// fragments rejected with InvalidArgument result code as their checksum doesn't
+   /// match or they fail authentication, see JitterBufferOptions. Not included in
+   /// invalidPackets
+   boost::uint64_t   corruptFragments;
+   /// packets rejected with OutOfSpace result code (too many incomplete frames)
+   boost::uint64_t   overflowPackets;
+   /// packets rejected with Fail result code (frame processing is blocked or
+   /// internal error)
+   boost::uint64_t   failedPackets;
+   /// frames decoded and rendered
+   boost::uint64_t   renderedFrames;
+   /// frames taken undecoded in pull mode, see IJitterBuffer::TryGetNextFrame
+   boost::uint64_t   pulledFrames;
+   /// frames dropped before decoding by overload shedding or because the frame
+   /// they depend on was dropped
+   boost::uint64_t   shedFrames;
+   /// frames dropped from decode queue by backpressure policy, see JitterBufferOptions
+   boost::uint64_t   droppedFrames;
+   /// decoded frames skipped by render pacing as stale, see JitterBufferOptions
+   boost::uint64_t   skippedFrames;
+   /// frames passed to streaming decoder in several parts, see JitterBufferOptions
+   boost::uint64_t   streamedFrames;
+   /// frames decoded ahead of their turn, see JitterBufferOptions
+   boost::uint64_t   decodedAheadFrames;
+   /// frames given up at deadline: missing or incomplete and dropped
+   boost::uint64_t   expiredFrames;
+   /// incomplete frames passed to concealing decoder at deadline
+   boost::uint64_t   concealedFrames;
+   /// completed frames waiting for decoder at the moment of the snapshot
+   boost::uint64_t   decodeQueueDepth;
+   /// time the oldest frame in decode queue has been waiting for decoder at the
+   /// moment of the snapshot (microseconds, in terms of JB clock)
+   TimeUs            decodeQueueLag;
+   /// CPU the recycler thread last ran on, -1 if unknown (not started or not Linux)
+   int               recyclerCpu;
+   /// CPU the decoder thread last ran on, -1 if unknown
+   int               decoderCpu;
+   /// CPU the render thread last ran on, -1 if unknown or render pacing is disabled
+   int               renderCpu;
+};
+
+/**
+ * Snapshot of the IIngestPath counters. Every counter is accumulated since the path
+ * creation
+ */
+struct IngestPathStatistics
+{
+   /**
+    * Constructor. Resets all counters
+    */
+   IngestPathStatistics();
+
+   /// packets received through this path
+   boost::uint64_t   receivedPackets;
+   /// fragments this path delivered before any other path
+   boost::uint64_t   firstArrivals;
+   /// redundant copies of fragments already delivered by another path (or repeated
+   /// by this one), rejected without being stored
+   boost::uint64_t   duplicatePackets;
+   /// fragments delivered by other paths only, estimated as number of distinct
+   /// fragments received by all paths minus number of fragments received through
+   /// this path (both counted since the path creation)
+   boost::uint64_t   lostPackets;
+   /// average time (microseconds, in terms of JB clock) this path lags behind the
+   /// first copy of the fragment, over duplicate packets. Zero for the leading path
+   TimeUs            averageLag;
+   /// maximum time this path lagged behind the first copy of the fragment
+   TimeUs            maxLag;
+};
+
 /**
  * Single factory function which creates instance of the IJitterBuffer
  * component. Caller must be prepared to handle std::exception thrown
@@ -39,6 +325,73 @@ boost::shared_ptr<IJitterBuffer> CreateJitterBuffer(
         IDecoder* decoder,
         IRenderer* renderer);
 
+/**
+ * Factory function which creates instance of the IJitterBuffer component with
+ * non-default options. Caller must be prepared to handle std::exception thrown
+ * in case of invalid input arguments
+ *
+ * @param decoder - raw pointer to the decoder object
+ * @param renderer - raw pointer to the renderer object
+ * @param options - component settings, see JitterBufferOptions
+ * @returns - shared_ptr holding pointer to the newly created instance of
+ *            JitterBuffer component
+ */
+boost::shared_ptr<IJitterBuffer> CreateJitterBuffer(
+        IDecoder* decoder,
+        IRenderer* renderer,
+        const JitterBufferOptions& options);
+
+/**
+ * Ingest handle of a single network path in redundant (SMPTE 2022-7 style) ingest,
+ * when the same stream is received over several paths. Created by
+ * IJitterBuffer::CreateIngestPath. The first copy of every fragment, whichever path
+ * delivers it, is passed to JB, later copies are rejected by a lock-free check
+ * before any data is copied or lock is taken. Paths may be fed from different
+ * threads concurrently. Handle must not outlive the JB it was created by
+ */
+class IIngestPath
+{
+public:
+
+   /**
+    * Same as IJitterBuffer::TryReceivePacket, redundant copies of already delivered
+    * fragments are dropped and counted in path statistics
+    *
+    * @param buffer, length, frameNumber, fragmentNumber, numFragmentsInThisFrame - see
+    *        IJitterBuffer::ReceivePacket
+    * @returns - see IJitterBuffer::TryReceivePacket, sOk for dropped copies
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame) throw() = 0;
+
+   /**
+    * Same as above, with frame metadata
+    *
+    * @param buffer, length, frameNumber, fragmentNumber, numFragmentsInThisFrame, info -
+    *        see IJitterBuffer::ReceivePacket
+    * @returns - see IJitterBuffer::TryReceivePacket, sOk for dropped copies
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info) throw() = 0;
+
+   /**
+    * Accessor to get current values of the path counters. Does not throw
+    * @returns - snapshot of the counters
+    */
+   virtual IngestPathStatistics GetStatistics() const = 0;
+
+   ~IIngestPath() {}
+};
+
 /**
  * IJitterBuffer component external interface.
  */
@@ -62,6 +415,8 @@ public:
     * Should copy the given buffer, as it may be deleted/reused immediately following
     * this call. This method will not block the call for significant period of time.
     * Decoding and Rendering will be performed by internal threads running separately.
+    * Frames that can be decoded at the time of JB destruction are decoded and rendered
+    * before the destructor returns.
     * Caller must be prepared to handle std::exception thrown from this function in case
     * of invalid input arguments or internal error (buffer overflow, etc)
     *
@@ -80,6 +435,137 @@ public:
       int fragmentNumber,
       int numFragmentsInThisFrame) = 0;
 
+   /**
+    * Same as ReceivePacket, but also passes metadata of the frame. Metadata lets JB shed
+    * disposable frames when decoder falls behind, see JitterBufferOptions. Caller must be
+    * prepared to handle std::exception, same as with ReceivePacket. Dependency frame
+    * number must be less than frame number
+    *
+    * @param buffer, length, frameNumber, fragmentNumber, numFragmentsInThisFrame - see
+    *        ReceivePacket
+    * @param info - frame metadata, must be identical for all fragments of the frame
+    */
+   virtual void ReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info) = 0;
+
+   /**
+    * Exception-free version of ReceivePacket intended for the hot ingest path. Has the
+    * same behavior, but every rejection is reported by result code and counted in
+    * statistics (see GetStatistics) instead of being thrown and logged
+    *
+    * @param buffer, length, frameNumber, fragmentNumber, numFragmentsInThisFrame - see
+    *        ReceivePacket
+    * @returns - sOk if packet is accepted (duplicate and late fragments are accepted
+    *            and silently dropped), eInvalidArgument if input arguments are invalid,
+    *            eOutOfSpace if JB is full, eFail if frame processing is blocked by an
+    *            error or internal error occurred
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame) throw() = 0;
+
+   /**
+    * Exception-free version of ReceivePacket with frame metadata
+    *
+    * @param buffer, length, frameNumber, fragmentNumber, numFragmentsInThisFrame, info -
+    *        see ReceivePacket
+    * @returns - see TryReceivePacket
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info) throw() = 0;
+
+   /**
+    * Accessor to get current values of the component counters. Does not throw
+    * @returns - snapshot of the counters
+    */
+   virtual JitterBufferStatistics GetStatistics() const = 0;
+
+   /**
+    * Creates ingest handle of one more network path for redundant ingest, see
+    * IIngestPath. Fragments passed directly to JB are not checked against redundant
+    * copies, so a stream should be fed either through paths or directly. Caller must
+    * be prepared to handle std::exception in case of memory allocation failure
+    *
+    * @returns - shared_ptr holding pointer to the new path handle
+    */
+   virtual boost::shared_ptr<IIngestPath> CreateIngestPath() = 0;
+
+   /**
+    * Blocks the call until every frame that can be decoded (completed and not
+    * preceded by an incomplete one) is decoded and rendered. Frames that are stuck
+    * behind a gap in sequence are not waited for. In pull mode the frames are decoded
+    * and rendered on the calling thread, see DecodeNext. Caller must be prepared to
+    * handle std::exception with Fail result code if frame processing is blocked by
+    * an error
+    */
+   virtual void Flush() = 0;
+
+   /**
+    * Same as Flush but limited in time. Does not throw
+    *
+    * @param timeout - maximum time to wait (in microseconds, in terms of JB clock)
+    * @returns - sOk if all decodable frames are rendered, eNotReady if timeout
+    *            expired earlier, eFail if frame processing is blocked by an error
+    */
+   virtual result_t Drain(TimeUs timeout) = 0;
+
+   /**
+    * Accessor to get the readiness descriptor of pull mode (see JitterBufferOptions),
+    * to be watched for readability by the owner event loop (poll, epoll, etc). It
+    * becomes readable when the next frame in sequence is completed or frame processing
+    * is blocked, and stays readable until DecodeNext or TryGetNextFrame returns
+    * NotReady, so both level- and edge-triggered watches work. Descriptor is owned by
+    * JB and must not be read by the caller. Does not throw
+    * @returns - descriptor, -1 if JB is not in pull mode
+    */
+   virtual int GetReadinessDescriptor() const = 0;
+
+   /**
+    * Accessor to get the moment the next frame in sequence stops being waited for, see
+    * JitterBufferOptions::frameDeadline. In pull mode it is the timeout of the owner
+    * poll: DecodeNext or TryGetNextFrame called at or after it give the frame up, even
+    * though the readiness descriptor is not signaled. Does not throw
+    * @returns - deadline in terms of JB clock, negative if there is no deadline
+    */
+   virtual TimeUs GetNextDeadline() throw() = 0;
+
+   /**
+    * Decodes the next frame in sequence and renders it on the calling thread, pull
+    * mode counterpart of the worker threads. Never waits for frames. Must not be
+    * called concurrently with itself or TryGetNextFrame. Does not throw, decoder or
+    * renderer failure blocks frame processing the same way as in push mode
+    *
+    * @returns - sOk if a frame is rendered (call again), eNotReady if there is no frame
+    *            to decode, eFail if frame processing is blocked by an error,
+    *            eUnexpected if JB is not in pull mode
+    */
+   virtual result_t DecodeNext() throw() = 0;
+
+   /**
+    * Takes the next frame in sequence out of JB without decoding it, so that the
+    * owner decodes it by other means, in pull mode. Never waits for frames. Must not be
+    * called concurrently with itself or DecodeNext. Does not throw
+    *
+    * @param frame - out parameter, the frame
+    * @returns - sOk if a frame is taken, eNotReady if there is no frame to take, eFail
+    *            if frame processing is blocked by an error, eUnexpected if JB is not
+    *            in pull mode
+    */
+   virtual result_t TryGetNextFrame(PulledFrame& frame) throw() = 0;
+
    ~IJitterBuffer() {}
 };
 
@@ -0,0 +1,140 @@
+/**
+ *  @file
+ *  \brief     video_coding::JitterBuffer class template
+ *  \details   Holds JitterBuffer template parameterized by decoder, renderer, compile-time
+ *             capacities and threading and storage policies, together with the defaults
+ *             CreateJitterBuffer instantiates it with. Header-only: any component can
+ *             instantiate the template with its own types, linking the jitter_buffer
+ *             library only for the non-template building blocks (frame containers,
+ *             worker condition, thread placement)
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_JITTER_BUFFER_TEMPLATE_H
+#define VIDEO_CODING_JITTER_BUFFER_TEMPLATE_H
+
+#include <video_coding/interface/jitter_buffer.h>
+#include <video_coding/jitter_buffer/source/jitter_buffer_impl.h>
+// third-party
+#include <stddef.h>
+#include <boost/thread/thread.hpp>
+
+namespace video_coding
+{
+
+/**
+ * Compile-time capacities of JitterBuffer, the ones used by CreateJitterBuffer.
+ * Custom traits must define the same constants, e.g. derive from this struct and
+ * hide some of them
+ */
+struct DefaultJitterBufferTraits
+{
+   /// maximum number of unprocessed (incomplete) frames that can be stored inside JB
+   static const int     MaxFrameNumber = 100;
+   /// maximum number of fragments of one frame, packets of larger frames are rejected
+   /// as invalid. Bounds the metadata a single frame can grow to, ~10Mb frame of
+   /// 1200-byte fragments
+   static const int     MaxFragmentsPerFrame = 8192;
+   /// maximum data size that can be returned by the decoder after the frame is processed
+   static const int     MaxDecodedBufferSize = 1024 * 1024; // 1Mb
+   /// maximum number of frames decoded ahead and waiting for their turn
+   static const size_t  MaxDecodedAheadFrames = 16;
+   /// maximum number of decoded frames waiting for render thread
+   static const size_t  RenderQueueCapacity = 1;
+};
+
+/**
+ * Threading policy used by CreateJitterBuffer: worker threads are boost threads and
+ * wait according to JitterBufferOptions::waitStrategy. Custom policy must provide
+ *  - Thread: handle of a running thread with `void join()`, joined and deleted by
+ *    JitterBuffer destructor
+ *  - `template <class Function> static Thread* Launch(Function body)`: starts a thread
+ *    running `body()`, throws if thread can't be started (launch is retried with the
+ *    next fragment)
+ *  - Condition: the one worker thread waits on, with the interface of WorkerCondition
+ *    and constructible from (WaitStrategy, TimeUs spinTime)
+ */
+struct DefaultThreadingPolicy
+{
+   typedef boost::thread      Thread;
+   typedef WorkerCondition    Condition;
+
+   template <class Function>
+   static Thread* Launch(Function body)
+   {
+      return new boost::thread(body);
+   }
+};
+
+/**
+ * Storage policy used by CreateJitterBuffer: incomplete frames are heap-allocated
+ * FrameBuffers kept in intrusive FrameIndex. Custom policy must provide
+ *  - Index: container of incomplete frames ordered by frame number, with the interface
+ *    of FrameIndex
+ *  - `static FrameBufferPtr CreateFrame(...)`: creates frame holding its first fragment,
+ *    takes the arguments of FrameBuffer constructor. Frame is deleted through
+ *    FrameBufferPtr, so it must be allocated by operator new
+ */
+struct DefaultStoragePolicy
+{
+   typedef FrameIndex   Index;
+
+   static FrameBufferPtr CreateFrame(const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info,
+      bool checksummed,
+      IFragmentDecryptor* decryptor)
+   {
+      return FrameBufferPtr( new FrameBuffer(buffer, length, frameNumber, fragmentNumber,
+            numFragmentsInThisFrame, info, checksummed, decryptor) );
+   }
+};
+
+/**
+ * JitterBuffer class template
+ * Implementation of the IJitterBuffer interface which calls decoder and renderer through
+ * their concrete types instead of IDecoder and IRenderer, so that the compiler can inline
+ * DecodeFrame and RenderFrame. Ingest methods stay virtual, see IJitterBuffer for the
+ * behavior. Instance can be created on stack or held by any smart pointer, destruction
+ * must happen through the concrete type.
+ *
+ * Decoder must provide `int DecodeFrame(const char* buffer, int length, char* outputBuffer)`
+ * and Renderer `void RenderFrame(const char* buffer, int length)` with the same contracts
+ * as IDecoder and IRenderer. Streaming decode and decoding of incomplete frames (see
+ * JitterBufferOptions) require Decoder to derive from IStreamingDecoder and
+ * IConcealingDecoder respectively. Traits, Threading and Storage must meet the contracts
+ * of DefaultJitterBufferTraits, DefaultThreadingPolicy and DefaultStoragePolicy.
+ */
+template <class Decoder,
+          class Renderer,
+          class Traits = DefaultJitterBufferTraits,
+          class Threading = DefaultThreadingPolicy,
+          class Storage = DefaultStoragePolicy>
+class JitterBuffer : public JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>
+{
+public:
+
+   /**
+    * Constructor. Caller must be prepared to handle std::exception thrown in case of
+    * invalid input arguments, see CreateJitterBuffer
+    *
+    * @param decoder - raw pointer to the decoder object
+    * @param renderer - raw pointer to the renderer object
+    * @param options - component settings, see JitterBufferOptions
+    */
+   JitterBuffer(
+      Decoder* decoder,
+      Renderer* renderer,
+      const JitterBufferOptions& options = JitterBufferOptions())
+      : JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>(
+            decoder, renderer, options)
+   {}
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_JITTER_BUFFER_TEMPLATE_H
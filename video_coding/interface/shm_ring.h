@@ -0,0 +1,275 @@
+/**
+ *  @file
+ *  \brief     Shared-memory ring interfaces
+ *  \details   Holds declaration of IShmRenderer and IShmFrameReader interfaces, which pass
+ *             decoded frames to a renderer running in another process through a POSIX
+ *             shared-memory ring without copying, and IShmPacketWriter and IShmIngest
+ *             interfaces, which pass fragments from a network process to JitterBuffer
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_SHM_RING_H
+#define VIDEO_CODING_SHM_RING_H
+
+#include "clock.h"
+#include "frame_info.h"
+#include <video_engine/interface/buffered_renderer.h>
+#include <common/result_code.h>
+// third-party
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace video_coding
+{
+
+class IJitterBuffer;
+
+/**
+ * Counters of the frame ring, see IShmRenderer::GetStatistics and
+ * IShmFrameReader::GetStatistics
+ */
+struct ShmRingStatistics
+{
+   /**
+    * Constructor. Fills in zero values
+    */
+   ShmRingStatistics();
+
+   /// frames published to the ring
+   boost::uint64_t   publishedFrames;
+   /// published frames which were copied into the ring, the rest were decoded right
+   /// into ring slots
+   boost::uint64_t   copiedFrames;
+   /// frames dropped as the ring was full (reader falls behind) or the frame was
+   /// larger than a slot
+   boost::uint64_t   droppedFrames;
+   /// frames released by the reader
+   boost::uint64_t   releasedFrames;
+};
+
+/**
+ * Renderer side of the ring: IRenderer adapter which publishes frames to a named
+ * POSIX shared-memory ring of fixed-size slots. Pass it as the renderer to JitterBuffer,
+ * which then decodes frames directly into ring slots (see IBufferedRenderer). Single
+ * producer: RenderFrame and GetFrameBuffer must be called by one thread at a time,
+ * which is the case for JitterBuffer. Never blocks: frame is dropped if the ring is full.
+ * The ring is removed from the system namespace on destruction, readers keep their
+ * mapping until they are destroyed
+ */
+class IShmRenderer : public video_engine::IBufferedRenderer
+{
+public:
+
+   /**
+    * Accessor to get current values of the ring counters. Does not throw
+    * @returns - snapshot of the counters
+    */
+   virtual ShmRingStatistics GetStatistics() const = 0;
+
+   ~IShmRenderer() {}
+};
+
+/**
+ * Frame mapped from the ring, see IShmFrameReader
+ */
+struct ShmFrame
+{
+   /// frame data inside the ring slot, valid until the frame is released
+   const char*       data;
+   /// frame length
+   int               length;
+   /// sequence number of the frame in the ring, gaps mean dropped frames
+   boost::uint64_t   sequence;
+};
+
+/**
+ * Reader side of the ring, to be used in the renderer process. Frames are read in order
+ * of publishing, directly from the shared mapping. Single consumer: one reader per ring
+ */
+class IShmFrameReader
+{
+public:
+
+   /**
+    * Maps the oldest unreleased frame. Calling it again before ReleaseFrame returns
+    * the same frame. Does not throw
+    * @param frame - out parameter, mapped frame
+    * @returns - false if there is no frame in the ring
+    */
+   virtual bool TryAcquireFrame(ShmFrame& frame) = 0;
+
+   /**
+    * Same as TryAcquireFrame, but waits for the frame to be published. Does not throw
+    * @param frame - out parameter, mapped frame
+    * @param timeout - maximum time to wait (microseconds)
+    * @returns - sOk if frame is mapped, eNotReady if timeout expired earlier, eFail if
+    *            the renderer is destroyed and all its frames are read
+    */
+   virtual result_t AcquireFrame(ShmFrame& frame, TimeUs timeout) = 0;
+
+   /**
+    * Returns slot of the acquired frame to the renderer. Frame data must not be
+    * accessed afterwards. Does nothing if no frame is acquired
+    */
+   virtual void ReleaseFrame() = 0;
+
+   /**
+    * Accessor to get current values of the ring counters. Does not throw
+    * @returns - snapshot of the counters
+    */
+   virtual ShmRingStatistics GetStatistics() const = 0;
+
+   ~IShmFrameReader() {}
+};
+
+/**
+ * Factory function which creates the ring and its renderer. Existing ring with the same
+ * name is replaced. Caller must be prepared to handle std::exception thrown in case
+ * of invalid input arguments or system error
+ *
+ * @param name - name of the shared memory object, e.g. "/video_output"
+ * @param slotCount - number of frames the ring holds
+ * @param slotSize - maximum frame size. Frames are decoded directly into the ring if
+ *                   it is not less than decoder output limit (1Mb by default), otherwise
+ *                   they are copied
+ * @returns - shared_ptr holding pointer to the renderer
+ */
+boost::shared_ptr<IShmRenderer> CreateShmRenderer(
+   const std::string& name,
+   int slotCount,
+   int slotSize);
+
+/**
+ * Factory function which opens existing ring for reading. Caller must be prepared to
+ * handle std::exception thrown if the ring does not exist or is incompatible
+ *
+ * @param name - name of the shared memory object, see CreateShmRenderer
+ * @returns - shared_ptr holding pointer to the reader
+ */
+boost::shared_ptr<IShmFrameReader> OpenShmFrameReader(const std::string& name);
+
+/**
+ * Counters of the packet ring, see IShmPacketWriter::GetStatistics and
+ * IShmIngest::GetStatistics
+ */
+struct ShmIngestStatistics
+{
+   /**
+    * Constructor. Fills in zero values
+    */
+   ShmIngestStatistics();
+
+   /// packets published to the ring
+   boost::uint64_t   publishedPackets;
+   /// packets dropped by the writer as the ring was full (JB process falls behind)
+   boost::uint64_t   droppedPackets;
+   /// packets taken from the ring and passed to JB
+   boost::uint64_t   receivedPackets;
+   /// packets rejected by JB (any result but sOk, see IJitterBuffer::TryReceivePacket)
+   /// or malformed
+   boost::uint64_t   rejectedPackets;
+};
+
+/**
+ * Writer side of the packet ring, to be used in the network process. Creates a named
+ * POSIX shared-memory ring of fixed-size slots and publishes fragments to it. Packet
+ * can be received (e.g. by recv) right into the slot provided by GetPacketBuffer, then
+ * it reaches JitterBuffer arena with no copy in between. Single producer: methods must
+ * be called by one thread at a time. Never blocks: packet is rejected if the ring is
+ * full. The ring is removed from the system namespace on destruction
+ */
+class IShmPacketWriter
+{
+public:
+
+   /**
+    * Provides the free slot for the next packet payload. Buffer stays valid until the
+    * next WritePacket or GetPacketBuffer call, it may be abandoned without notice.
+    * Does not throw
+    * @returns - pointer to the buffer of GetMaxPacketSize bytes, zero if the ring is full
+    */
+   virtual char* GetPacketBuffer() = 0;
+
+   /**
+    * Accessor to get the maximum payload size of the packet
+    * @returns - size of the payload part of a slot
+    */
+   virtual int GetMaxPacketSize() const = 0;
+
+   /**
+    * Publishes the packet. Payload is copied unless it is in the buffer provided by
+    * GetPacketBuffer. Does not throw
+    *
+    * @param buffer, length, frameNumber, fragmentNumber, numFragmentsInThisFrame, info -
+    *        see IJitterBuffer::ReceivePacket
+    * @returns - sOk if packet is published, eOutOfSpace if the ring is full (the packet
+    *            is dropped and counted), eInvalidArgument if the payload doesn't fit the
+    *            slot
+    */
+   virtual result_t WritePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info) = 0;
+
+   /**
+    * Accessor to get current values of the ring counters. Does not throw
+    * @returns - snapshot of the counters
+    */
+   virtual ShmIngestStatistics GetStatistics() const = 0;
+
+   ~IShmPacketWriter() {}
+};
+
+/**
+ * Reader side of the packet ring, to be used in JitterBuffer process. Runs a thread
+ * which passes every packet published to the ring to JB by TryReceivePacket, straight
+ * from the shared mapping, and releases the slot right after. Packets rejected by JB are
+ * counted and dropped. The thread stops on destruction or once the writer is destroyed
+ */
+class IShmIngest
+{
+public:
+
+   /**
+    * Accessor to get current values of the ring counters. Does not throw
+    * @returns - snapshot of the counters
+    */
+   virtual ShmIngestStatistics GetStatistics() const = 0;
+
+   ~IShmIngest() {}
+};
+
+/**
+ * Factory function which creates the packet ring and its writer. Existing ring with
+ * the same name is replaced. Caller must be prepared to handle std::exception thrown in
+ * case of invalid input arguments or system error
+ *
+ * @param name - name of the shared memory object, e.g. "/video_input"
+ * @param slotCount - number of packets the ring holds
+ * @param maxPacketSize - maximum payload size of the packet
+ * @returns - shared_ptr holding pointer to the writer
+ */
+boost::shared_ptr<IShmPacketWriter> CreateShmPacketWriter(
+   const std::string& name,
+   int slotCount,
+   int maxPacketSize);
+
+/**
+ * Factory function which opens existing packet ring and starts passing its packets to
+ * JB. Caller must be prepared to handle std::exception thrown if the ring does not
+ * exist or is incompatible
+ *
+ * @param name - name of the shared memory object, see CreateShmPacketWriter
+ * @param jitterBuffer - raw pointer to JB, must outlive the ingest
+ * @returns - shared_ptr holding pointer to the ingest
+ */
+boost::shared_ptr<IShmIngest> CreateShmIngest(const std::string& name, IJitterBuffer* jitterBuffer);
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_SHM_RING_H
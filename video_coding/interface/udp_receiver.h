@@ -0,0 +1,135 @@
+/**
+ *  @file
+ *  \brief     UDP receive frontend interface
+ *  \details   Holds declaration of IUdpReceiver interface, which owns a UDP socket and
+ *             feeds JitterBuffer with the fragments received from it in batches
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_UDP_RECEIVER_H
+#define VIDEO_CODING_UDP_RECEIVER_H
+
+// third-party
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace video_coding
+{
+
+class IJitterBuffer;
+
+/// size of the fragment header which precedes the payload in every datagram: frame
+/// number (32 bits), fragment number (16 bits) and number of fragments in the frame
+/// (16 bits), all in network byte order
+const int UdpFragmentHeaderSize = 8;
+
+/**
+ * Helper function for the sending side: fills in the fragment header. Does not throw
+ * @param buffer - datagram start, at least UdpFragmentHeaderSize bytes
+ * @param frameNumber, fragmentNumber, numFragmentsInThisFrame - see
+ *        IJitterBuffer::ReceivePacket, values are truncated to the header field size
+ */
+void WriteUdpFragmentHeader(
+   char* buffer,
+   int frameNumber,
+   int fragmentNumber,
+   int numFragmentsInThisFrame);
+
+/**
+ * UDP receive frontend options
+ */
+struct UdpReceiverOptions
+{
+   /**
+    * Constructor. Fills in default values
+    */
+   UdpReceiverOptions();
+
+   /// IPv4 address to bind the socket to
+   std::string          address;
+   /// port to bind the socket to, zero means any free port (see IUdpReceiver::GetPort)
+   int                  port;
+   /// maximum number of datagrams taken from the socket by a single system call
+   int                  batchSize;
+   /// maximum size of a datagram including the fragment header, longer ones are dropped
+   int                  maxDatagramSize;
+   /// lets the kernel coalesce datagrams of the same flow (UDP GRO) where supported,
+   /// so that a whole burst is taken by a single buffer. Coalesced datagrams are split
+   /// back before they are passed to JB
+   bool                 enableGro;
+   /// socket receive buffer size (bytes), zero keeps the system default
+   int                  receiveBufferSize;
+};
+
+/**
+ * Counters of the UDP receive frontend, see IUdpReceiver::GetStatistics
+ */
+struct UdpReceiverStatistics
+{
+   /**
+    * Constructor. Fills in zero values
+    */
+   UdpReceiverStatistics();
+
+   /// datagrams received, coalesced ones are counted separately
+   boost::uint64_t   datagrams;
+   /// system calls which returned at least one datagram
+   boost::uint64_t   batches;
+   /// received datagrams which arrived coalesced by GRO
+   boost::uint64_t   coalescedDatagrams;
+   /// datagrams which are truncated or too short to hold the fragment header
+   boost::uint64_t   malformedDatagrams;
+   /// datagrams rejected by JB (any result but sOk, see IJitterBuffer::TryReceivePacket)
+   boost::uint64_t   rejectedDatagrams;
+};
+
+/**
+ * UDP receive frontend. Owns a bound UDP socket and runs a thread which receives
+ * datagrams in batches (recvmmsg where available) into buffers allocated once, parses
+ * the fragment header (see UdpFragmentHeaderSize) and passes the payload to JB by
+ * TryReceivePacket. Packets rejected by JB are counted and dropped. The thread stops
+ * and the socket is closed on destruction
+ */
+class IUdpReceiver
+{
+public:
+
+   /**
+    * Accessor to get the port the socket is bound to. Does not throw
+    * @returns - local port
+    */
+   virtual int GetPort() const = 0;
+
+   /**
+    * Accessor to check whether datagrams may arrive coalesced. Does not throw
+    * @returns - true if GRO is requested and supported by the system
+    */
+   virtual bool IsGroEnabled() const = 0;
+
+   /**
+    * Accessor to get current values of the frontend counters. Does not throw
+    * @returns - snapshot of the counters
+    */
+   virtual UdpReceiverStatistics GetStatistics() const = 0;
+
+   ~IUdpReceiver() {}
+};
+
+/**
+ * Factory function which creates the socket and starts receiving. Caller must be
+ * prepared to handle std::exception thrown in case of invalid input arguments or system
+ * error (e.g. the port is in use)
+ *
+ * @param jitterBuffer - raw pointer to JB, must outlive the receiver
+ * @param options - socket and batching options
+ * @returns - shared_ptr holding pointer to the receiver
+ */
+boost::shared_ptr<IUdpReceiver> CreateUdpReceiver(
+   IJitterBuffer* jitterBuffer,
+   const UdpReceiverOptions& options = UdpReceiverOptions());
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_UDP_RECEIVER_H
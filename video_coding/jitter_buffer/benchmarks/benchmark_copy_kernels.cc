@@ -0,0 +1,251 @@
+/**
+ *  @file
+ *  \brief     Copy kernel benchmark
+ *  \details   Measures the effect of frame assembly on the decoder. Each iteration warms
+ *             up decoder state (a lookup table), assembles a large frame by one of the
+ *             copy kernels, then decodes: looks the table up at random positions and
+ *             reads the frame once. memcpy fills the cache with the frame and evicts the
+ *             table, non-temporal stores leave the table in place. Frame received out of
+ *             order is assembled fragment by fragment, with the stores fenced per
+ *             fragment or once per frame.
+ *             Usage: benchmark_copy_kernels
+ *                    [<frame size> [<state size> [<iterations> [<fragment size>]]]]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/jitter_buffer/source/copy_kernels.h>
+// third-party
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/// number of table lookups per decoded frame
+const int LookupCount = 1 << 18;
+
+/**
+ * Way the frame is assembled
+ */
+enum Assembly
+{
+   /// frame is received in order and copied at once
+   InOrder,
+   /// fragments are copied one by one, each copy is fenced
+   FragmentFenced,
+   /// fragments are copied one by one, the stores are fenced after the last one
+   FragmentUnfenced
+};
+
+/**
+ * Received frame
+ */
+struct Frame
+{
+   /// frame data in order
+   std::vector<char>    data;
+   /// fragments in the order of arrival, as FrameBuffer stores them
+   std::vector<char>    arena;
+   /// offsets of the fragments in the arena, in fragment number order
+   std::vector<size_t>  offsets;
+   /// size of every fragment except the last one
+   size_t               fragmentSize;
+};
+
+/**
+ * Helper routine to get time since the given point
+ * @param start - time point
+ * @returns - elapsed time (microseconds)
+ */
+double GetElapsed(const Clock::time_point& start)
+{
+   return boost::chrono::duration<double, boost::micro>(Clock::now() - start).count();
+}
+
+/**
+ * Assembles the frame with the given kernel
+ * @param kernel - kernel to use
+ * @param assembly - way the frame is assembled
+ * @param frame - received frame
+ * @param assembled - out parameter, assembled frame
+ */
+void Assemble(
+   const video_coding::CopyKernel kernel,
+   const Assembly assembly,
+   const Frame& frame,
+   std::vector<char>& assembled)
+{
+   if (assembly == InOrder)
+   {
+      video_coding::StreamingCopy(kernel, &assembled[0], &frame.data[0], frame.data.size());
+      return;
+   }
+
+   size_t position = 0;
+   for (size_t i = 0; i < frame.offsets.size(); ++i)
+   {
+      const size_t length = std::min(frame.fragmentSize, frame.data.size() - position);
+      if (assembly == FragmentFenced)
+      {
+         video_coding::StreamingCopy(kernel, &assembled[position], &frame.arena[frame.offsets[i]],
+               length);
+      }
+      else
+      {
+         video_coding::StreamingCopyUnfenced(kernel, &assembled[position],
+               &frame.arena[frame.offsets[i]], length);
+      }
+      position += length;
+   }
+   if (assembly == FragmentUnfenced)
+      video_coding::StreamingCopyFence(kernel);
+}
+
+/**
+ * Assembles and decodes frames with the given kernel and prints results
+ * @param name - kernel name to print
+ * @param kernel - kernel to use
+ * @param assembly - way the frame is assembled
+ * @param frame - received frame
+ * @param state - decoder state
+ * @param iterations - number of frames to process
+ * @returns - false if the assembled frame is corrupt
+ */
+bool Run(
+   const char* name,
+   const video_coding::CopyKernel kernel,
+   const Assembly assembly,
+   const Frame& frame,
+   std::vector<boost::uint32_t>& state,
+   const int iterations)
+{
+   if (!video_coding::IsCopyKernelSupported(kernel))
+   {
+      std::cout << std::left << std::setw(20) << name << "not supported" << std::endl;
+      return true;
+   }
+
+   std::vector<char> assembled(frame.data.size());
+   const size_t mask = state.size() - 1;
+   double copyTime = 0;
+   double lookupTime = 0;
+   double readTime = 0;
+   boost::uint32_t checksum = 0;
+   for (int i = 0; i < iterations; ++i)
+   {
+      // decoder state is hot after the previous frame
+      for (size_t k = 0; k < state.size(); k += 16)
+         checksum += state[k];
+
+      Clock::time_point start = Clock::now();
+      Assemble(kernel, assembly, frame, assembled);
+      copyTime += GetElapsed(start);
+
+      start = Clock::now();
+      boost::uint32_t position = (boost::uint32_t)i;
+      for (int k = 0; k < LookupCount; ++k)
+      {
+         position = position * 1664525u + 1013904223u;
+         checksum += state[(position >> 7) & mask];
+      }
+      lookupTime += GetElapsed(start);
+
+      start = Clock::now();
+      for (size_t k = 0; k < assembled.size(); k += 64)
+         checksum += (unsigned char)assembled[k];
+      readTime += GetElapsed(start);
+   }
+
+   std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+         << std::setprecision(1)
+         << std::setw(14) << copyTime / iterations
+         << std::setw(14) << frame.data.size() / (copyTime / iterations) / 1000
+         << std::setw(14) << lookupTime / iterations
+         << std::setw(14) << readTime / iterations
+         << std::setw(14) << (copyTime + lookupTime + readTime) / iterations
+         << std::setw(12) << (checksum & 0xFFFF) << std::endl;
+   return ::memcmp(&assembled[0], &frame.data[0], frame.data.size()) == 0;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+   const int frameSize = argc > 1 ? ::atoi(argv[1]) : 8 * 1024 * 1024;
+   const int stateSize = argc > 2 ? ::atoi(argv[2]) : 1024 * 1024;
+   const int iterations = argc > 3 ? ::atoi(argv[3]) : 200;
+   const int fragmentSize = argc > 4 ? ::atoi(argv[4]) : 1200;
+   if (frameSize <= 0 || stateSize < 64 || (stateSize & (stateSize - 1)) || iterations <= 0 ||
+       fragmentSize <= 0)
+   {
+      std::cerr << "Usage: " << argv[0]
+            << " [<frame size> [<state size, power of 2> [<iterations> [<fragment size>]]]]"
+            << std::endl;
+      return 1;
+   }
+
+   std::cout << "frame of " << frameSize << " bytes in " << fragmentSize
+         << "-byte fragments, decoder state of " << stateSize << " bytes, " << iterations
+         << " iterations, " << video_coding::StreamingCopyThreshold << " bytes threshold"
+         << std::endl;
+   std::cout << std::left << std::setw(20) << "kernel" << std::right
+         << std::setw(14) << "copy, us" << std::setw(14) << "copy, GB/s"
+         << std::setw(14) << "lookup, us" << std::setw(14) << "read, us"
+         << std::setw(14) << "total, us" << std::setw(12) << "checksum" << std::endl;
+
+   // frame misaligned by an odd offset, as fragment payloads are
+   Frame frame;
+   frame.data.resize(frameSize);
+   for (int i = 0; i < frameSize; ++i)
+      frame.data[i] = (char)(i * 7 + i / 4096);
+   // fragments arrive in reverse order
+   frame.fragmentSize = fragmentSize;
+   frame.offsets.resize((frameSize + fragmentSize - 1) / fragmentSize);
+   for (size_t i = frame.offsets.size(); i-- > 0;)
+   {
+      const size_t position = i * fragmentSize;
+      const size_t length = std::min((size_t)fragmentSize, frame.data.size() - position);
+      frame.offsets[i] = frame.arena.size();
+      frame.arena.insert(frame.arena.end(), frame.data.begin() + position,
+            frame.data.begin() + position + length);
+   }
+   std::vector<boost::uint32_t> state(stateSize / sizeof(boost::uint32_t));
+   for (size_t i = 0; i < state.size(); ++i)
+      state[i] = (boost::uint32_t)i;
+
+   bool valid = Run("memcpy", video_coding::ScalarCopyKernel, InOrder, frame, state,
+         iterations);
+   const video_coding::CopyKernel kernels[] =
+   {
+      video_coding::Sse2CopyKernel,
+      video_coding::Avx2CopyKernel,
+      video_coding::Avx512CopyKernel
+   };
+   const char* names[][3] =
+   {
+      { "sse2", "sse2 fence/frag", "sse2 fence/frame" },
+      { "avx2", "avx2 fence/frag", "avx2 fence/frame" },
+      { "avx512", "avx512 fence/frag", "avx512 fence/frame" }
+   };
+   for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); ++i)
+   {
+      valid = Run(names[i][0], kernels[i], InOrder, frame, state, iterations) && valid;
+      valid = Run(names[i][1], kernels[i], FragmentFenced, frame, state, iterations) && valid;
+      valid = Run(names[i][2], kernels[i], FragmentUnfenced, frame, state, iterations) && valid;
+   }
+   if (!valid)
+   {
+      std::cerr << "Assembled frame is corrupt" << std::endl;
+      return 1;
+   }
+   return 0;
+}
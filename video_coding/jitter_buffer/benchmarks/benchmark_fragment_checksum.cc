@@ -0,0 +1,172 @@
+/**
+ *  @file
+ *  \brief     Fragment checksum benchmark
+ *  \details   Measures the cost of fragment integrity check: copy of a fragment alone
+ *             and fused with CRC32C by each kernel, and fragment append to FrameBuffer
+ *             with and without the check. Rate is shown as the line rate one core can
+ *             sustain and as the share of the per-fragment time budget at 10 Gbit/s.
+ *             Usage: benchmark_fragment_checksum [<fragment size> [<fragments>]]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/jitter_buffer/source/frame_buffer.h>
+#include <video_coding/jitter_buffer/source/crc32c.h>
+#include <video_coding/interface/jitter_buffer.h>
+#include <logger/logger.h>
+// third-party
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <boost/chrono.hpp>
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/// line rate the budget is computed for (bits per second)
+const double LineRate = 10e9;
+
+/// fragments per frame in FrameBuffer runs
+const int FragmentsPerFrame = 100;
+
+/**
+ * Prints results of a run
+ * @param name - variant name
+ * @param elapsed - total time
+ * @param fragmentCount - number of fragments processed
+ * @param fragmentSize - size of every fragment
+ */
+void Print(const char* name, const Clock::duration elapsed, const int fragmentCount, const int fragmentSize)
+{
+   const double perFragment =
+         boost::chrono::duration<double, boost::nano>(elapsed).count() / fragmentCount;
+   const double budget = fragmentSize * 8 / LineRate * 1e9;
+   std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+         << std::setprecision(1)
+         << std::setw(14) << perFragment
+         << std::setw(14) << fragmentSize * 8 / perFragment
+         << std::setw(14) << perFragment / budget * 100 << std::endl;
+}
+
+/**
+ * Copies fragments with the given kernel and prints results
+ * @param name - variant name
+ * @param kernel - CRC32C kernel, ignored if checksum is not computed
+ * @param checksum - flag, indicates copy is fused with checksum
+ * @param fragment - fragment data
+ * @param fragmentCount - number of fragments to copy
+ * @returns - checksum of the last copy, so that the work can't be optimized out
+ */
+boost::uint32_t RunCopy(
+   const char* name,
+   const video_coding::Crc32cKernel kernel,
+   const bool checksum,
+   const std::vector<char>& fragment,
+   const int fragmentCount)
+{
+   if (!video_coding::IsCrc32cKernelSupported(kernel))
+   {
+      std::cout << std::left << std::setw(20) << name << "not supported" << std::endl;
+      return 0;
+   }
+
+   // arena of a frame, so that copies don't stay in L1
+   std::vector<char> arena(fragment.size() * FragmentsPerFrame);
+   boost::uint32_t result = 0;
+   Clock::time_point start = Clock::now();
+   for (int i = 0; i < fragmentCount; ++i)
+   {
+      char* destination = &arena[(i % FragmentsPerFrame) * fragment.size()];
+      if (checksum)
+         result ^= video_coding::CopyWithCrc32c(destination, &fragment[0], fragment.size(), kernel);
+      else
+         ::memcpy(destination, &fragment[0], fragment.size());
+   }
+   Print(name, Clock::now() - start, fragmentCount, (int)fragment.size());
+   return result ^ (boost::uint32_t)arena[fragment.size()];
+}
+
+/**
+ * Appends fragments to frames and prints results
+ * @param name - variant name
+ * @param checksummed - flag, indicates fragments carry checksum to be verified
+ * @param fragment - fragment data, including the trailer if checksummed
+ * @param fragmentCount - number of fragments to append
+ * @returns - false if a fragment is rejected
+ */
+bool RunAppend(
+   const char* name,
+   const bool checksummed,
+   const std::vector<char>& fragment,
+   const int fragmentCount)
+{
+   const video_coding::FrameInfo info;
+   const int length = (int)fragment.size();
+   bool valid = true;
+   Clock::time_point start = Clock::now();
+   for (int frameNumber = 0; frameNumber * FragmentsPerFrame < fragmentCount; ++frameNumber)
+   {
+      video_coding::FrameBuffer frameBuffer(&fragment[0], length, frameNumber, 0,
+            FragmentsPerFrame, info, checksummed);
+      for (int i = 1; i < FragmentsPerFrame; ++i)
+      {
+         valid = frameBuffer.AppendFragment(&fragment[0], length, i) ==
+               video_coding::FrameBuffer::FragmentAppended && valid;
+      }
+      valid = frameBuffer.IsFrameComplete() && valid;
+   }
+   Print(name, Clock::now() - start, fragmentCount / FragmentsPerFrame * FragmentsPerFrame, length);
+   return valid;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+   const int fragmentSize = argc > 1 ? ::atoi(argv[1]) : 1200;
+   const int fragmentCount = argc > 2 ? ::atoi(argv[2]) : 2000000;
+   if (fragmentSize <= video_coding::FragmentChecksumSize || fragmentCount < FragmentsPerFrame)
+   {
+      std::cerr << "Usage: " << argv[0] << " [<fragment size> [<fragments>]]" << std::endl;
+      return 1;
+   }
+
+   // debug records of every fragment would dominate the measurement
+   logger::Log::SetLogLevel(logger::Warning);
+
+   std::cout << fragmentCount << " fragments of " << fragmentSize << " bytes, "
+         << fragmentSize * 8 / LineRate * 1e9 << " ns per fragment at 10 Gbit/s" << std::endl;
+   std::cout << std::left << std::setw(20) << "variant" << std::right
+         << std::setw(14) << "ns/fragment" << std::setw(14) << "Gbit/s"
+         << std::setw(14) << "% budget" << std::endl;
+
+   std::vector<char> fragment(fragmentSize);
+   for (int i = 0; i < fragmentSize; ++i)
+      fragment[i] = (char)(i * 13);
+   boost::uint32_t result = RunCopy("memcpy", video_coding::SoftwareCrc32cKernel, false,
+         fragment, fragmentCount);
+   result ^= RunCopy("copy+crc software", video_coding::SoftwareCrc32cKernel, true,
+         fragment, fragmentCount / 10);
+   result ^= RunCopy("copy+crc hardware", video_coding::HardwareCrc32cKernel, true,
+         fragment, fragmentCount);
+
+   // the same fragment with the trailer, payload size unchanged
+   std::vector<char> checksummedFragment(fragment);
+   boost::uint32_t checksum = video_coding::ComputeFragmentChecksum(&fragment[0], fragmentSize);
+   for (int i = 0; i < video_coding::FragmentChecksumSize; ++i)
+      checksummedFragment.push_back((char)(checksum >> (8 * i)));
+
+   bool valid = RunAppend("append", false, fragment, fragmentCount);
+   valid = RunAppend("append verified", true, checksummedFragment, fragmentCount) && valid;
+   if (!valid)
+   {
+      std::cerr << "Fragment is rejected" << std::endl;
+      return 1;
+   }
+   std::cout << "(" << (result & 0xFF) << ")" << std::endl;
+   return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ *  @file
+ *  \brief     Fragment layout benchmark
+ *  \details   Measures reassembly cost of frames with hundreds of fragments: appending
+ *             fragments to FrameBuffer (with duplicate check) in different arrival
+ *             orders and assembling the complete frame.
+ *             Usage: benchmark_fragment_layout [<fragments per frame> [<fragment size> [<frames>]]]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/jitter_buffer/source/frame_buffer.h>
+#include <logger/logger.h>
+// third-party
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <boost/chrono.hpp>
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/**
+ * Runs the benchmark for one arrival order and prints results
+ * @param name - order name to print
+ * @param order - fragment numbers in arrival order
+ * @param fragmentSize - size of every fragment
+ * @param frameCount - number of frames to reassemble
+ */
+void Run(const char* name, const std::vector<int>& order, const int fragmentSize, const int frameCount)
+{
+   const std::vector<char> fragment(fragmentSize, 'x');
+   std::vector<char> frameData(order.size() * fragmentSize);
+   const video_coding::FrameInfo info;
+   Clock::duration appendTime = Clock::duration::zero();
+   Clock::duration assemblyTime = Clock::duration::zero();
+
+   for (int frameNumber = 0; frameNumber < frameCount; ++frameNumber)
+   {
+      Clock::time_point start = Clock::now();
+      video_coding::FrameBuffer frameBuffer(&fragment[0], fragmentSize, frameNumber,
+            order[0], (int)order.size(), info);
+      for (size_t i = 1; i < order.size(); ++i)
+         frameBuffer.AppendFragment(&fragment[0], fragmentSize, order[i]);
+      // retransmission of the whole frame exercises duplicate check alone
+      for (size_t i = 0; i < order.size(); ++i)
+         frameBuffer.AppendFragment(&fragment[0], fragmentSize, order[i]);
+      Clock::time_point assembly = Clock::now();
+      frameBuffer.GetAssembledData(&frameData[0]);
+      Clock::time_point finish = Clock::now();
+
+      appendTime += assembly - start;
+      assemblyTime += finish - assembly;
+   }
+
+   const double fragments = 2.0 * order.size() * frameCount;
+   std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+         << std::setprecision(1)
+         << std::setw(20) << boost::chrono::duration<double, boost::nano>(appendTime).count() / fragments
+         << std::setw(20) << boost::chrono::duration<double, boost::micro>(assemblyTime).count() / frameCount
+         << std::endl;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+   const int fragmentCount = argc > 1 ? ::atoi(argv[1]) : 500;
+   const int fragmentSize = argc > 2 ? ::atoi(argv[2]) : 1200;
+   const int frameCount = argc > 3 ? ::atoi(argv[3]) : 200;
+   if (fragmentCount <= 0 || fragmentSize <= 0 || frameCount <= 0)
+   {
+      std::cerr << "Usage: " << argv[0]
+            << " [<fragments per frame> [<fragment size> [<frames>]]]" << std::endl;
+      return 1;
+   }
+
+   // debug records of retransmitted fragments would dominate the measurement
+   logger::Log::SetLogLevel(logger::Warning);
+
+   std::cout << fragmentCount << " fragments of " << fragmentSize << " bytes, "
+         << frameCount << " frames" << std::endl;
+   std::cout << std::left << std::setw(12) << "order" << std::right
+         << std::setw(20) << "append, ns/frag" << std::setw(20) << "assembly, us/frame"
+         << std::endl;
+
+   std::vector<int> order(fragmentCount);
+   for (int i = 0; i < fragmentCount; ++i)
+      order[i] = i;
+   Run("forward", order, fragmentSize, frameCount);
+
+   std::reverse(order.begin(), order.end());
+   Run("reverse", order, fragmentSize, frameCount);
+
+   ::srand(1);
+   for (int i = fragmentCount - 1; i > 0; --i)
+      std::swap(order[i], order[::rand() % (i + 1)]);
+   Run("shuffled", order, fragmentSize, frameCount);
+   return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ *  @file
+ *  \brief     Decoder and renderer dispatch benchmark
+ *  \details   Compares frame throughput of JitterBuffer created by CreateJitterBuffer,
+ *             which calls decoder and renderer through IDecoder and IRenderer, with the
+ *             JitterBuffer template instantiated for the concrete types. Frames are small
+ *             and single-fragment, so per-frame overhead dominates.
+ *             Usage: benchmark_template_dispatch [<frames> [<frame size>]]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/interface/jitter_buffer.h>
+#include <video_coding/interface/jitter_buffer_template.h>
+#include <video_engine/interface/decoder.h>
+#include <video_engine/interface/renderer.h>
+#include <logger/logger.h>
+// third-party
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <boost/chrono.hpp>
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/**
+ * Decoder which copies frame data to the output
+ */
+class CopyDecoder
+{
+public:
+   int DecodeFrame(const char* buffer, int length, char* outputBuffer)
+   {
+      ::memcpy(outputBuffer, buffer, length);
+      return length;
+   }
+};
+
+/**
+ * Renderer which sums up the rendered bytes, so that rendering can't be optimized out
+ */
+class ChecksumRenderer
+{
+public:
+   ChecksumRenderer()
+      : m_checksum(0)
+   {}
+
+   void RenderFrame(const char* buffer, int length)
+   {
+      for (int i = 0; i < length; ++i)
+         m_checksum += (unsigned char)buffer[i];
+   }
+
+   /**
+    * Accessor to the checksum of rendered data
+    * @returns - sum of all rendered bytes
+    */
+   unsigned long GetChecksum() const
+   {
+      return m_checksum;
+   }
+
+private:
+   unsigned long  m_checksum;
+};
+
+/**
+ * The same decoder behind IDecoder interface
+ */
+class VirtualCopyDecoder : public video_engine::IDecoder
+{
+public:
+   virtual int DecodeFrame(const char* buffer, int length, char* outputBuffer)
+   {
+      return m_decoder.DecodeFrame(buffer, length, outputBuffer);
+   }
+
+private:
+   CopyDecoder    m_decoder;
+};
+
+/**
+ * The same renderer behind IRenderer interface
+ */
+class VirtualChecksumRenderer
+   : public video_engine::IRenderer
+   , public ChecksumRenderer
+{
+public:
+   virtual void RenderFrame(const char* buffer, int length)
+   {
+      ChecksumRenderer::RenderFrame(buffer, length);
+   }
+};
+
+/**
+ * Sends frames to JB and prints results
+ * @param name - variant name to print
+ * @param jitterBuffer - JB to measure
+ * @param renderer - renderer of that JB
+ * @param frameCount - number of frames to send
+ * @param frameSize - size of every frame
+ */
+void Run(
+   const char* name,
+   video_coding::IJitterBuffer& jitterBuffer,
+   const ChecksumRenderer& renderer,
+   const int frameCount,
+   const int frameSize)
+{
+   std::vector<char> frame(frameSize, 'x');
+   Clock::time_point start = Clock::now();
+   for (int frameNumber = 0; frameNumber < frameCount; ++frameNumber)
+   {
+      // JB holds at most 100 frames, wait for it to catch up
+      while (jitterBuffer.TryReceivePacket(&frame[0], frameSize, frameNumber, 0, 1) ==
+             result_code::eOutOfSpace)
+         jitterBuffer.Flush();
+   }
+   jitterBuffer.Flush();
+   const double elapsed =
+         boost::chrono::duration<double, boost::nano>(Clock::now() - start).count();
+
+   std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+         << std::setprecision(1)
+         << std::setw(16) << elapsed / frameCount
+         << std::setw(16) << frameCount / elapsed * 1e9
+         << std::setw(16) << renderer.GetChecksum() << std::endl;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+   const int frameCount = argc > 1 ? ::atoi(argv[1]) : 200000;
+   const int frameSize = argc > 2 ? ::atoi(argv[2]) : 64;
+   if (frameCount <= 0 || frameSize <= 0)
+   {
+      std::cerr << "Usage: " << argv[0] << " [<frames> [<frame size>]]" << std::endl;
+      return 1;
+   }
+
+   // debug records of every fragment would dominate the measurement
+   logger::Log::SetLogLevel(logger::Warning);
+
+   std::cout << frameCount << " frames of " << frameSize << " bytes" << std::endl;
+   std::cout << std::left << std::setw(12) << "dispatch" << std::right
+         << std::setw(16) << "ns/frame" << std::setw(16) << "frames/s"
+         << std::setw(16) << "checksum" << std::endl;
+
+   {
+      VirtualCopyDecoder decoder;
+      VirtualChecksumRenderer renderer;
+      boost::shared_ptr<video_coding::IJitterBuffer> jitterBuffer =
+            video_coding::CreateJitterBuffer(&decoder, &renderer);
+      Run("virtual", *jitterBuffer, renderer, frameCount, frameSize);
+   }
+   {
+      CopyDecoder decoder;
+      ChecksumRenderer renderer;
+      video_coding::JitterBuffer<CopyDecoder, ChecksumRenderer> jitterBuffer(&decoder, &renderer);
+      Run("template", jitterBuffer, renderer, frameCount, frameSize);
+   }
+   return 0;
+}
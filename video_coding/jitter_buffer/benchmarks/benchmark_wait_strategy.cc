@@ -0,0 +1,216 @@
+/**
+ *  @file
+ *  \brief     Wait strategy benchmark
+ *  \details   Measures frame completion-to-render latency of JitterBuffer with every
+ *             wait strategy (see JitterBufferOptions::waitStrategy). Frames are sent
+ *             one by one with a pause in between, so worker threads go idle and every
+ *             frame pays for their wake-up. Latency is counted from the arrival of the
+ *             last fragment of the frame to the RenderFrame call. Pull mode (see
+ *             JitterBufferOptions::pullMode) is measured the way an event loop runs it:
+ *             the sending thread polls readiness descriptor after every fragment and
+ *             decodes on the spot, with no worker threads involved.
+ *             Usage: benchmark_wait_strategy [<frames> [<interval us> [<spin time us>]]]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/interface/jitter_buffer.h>
+#include <video_engine/interface/decoder.h>
+#include <video_engine/interface/renderer.h>
+#include <logger/logger.h>
+// third-party
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/// fragments per frame, latency is counted from the last one
+const int FragmentCount = 4;
+/// size of every fragment
+const int FragmentSize = 1024;
+
+/**
+ * Decoder which copies frame data to the output
+ */
+class CopyDecoder : public video_engine::IDecoder
+{
+public:
+   virtual int DecodeFrame(const char* buffer, int length, char* outputBuffer)
+   {
+      ::memcpy(outputBuffer, buffer, length);
+      return length;
+   }
+};
+
+/**
+ * Renderer which measures latency of every frame, frame number is taken from the
+ * first bytes of the frame data
+ */
+class LatencyRenderer : public video_engine::IRenderer
+{
+public:
+
+   /**
+    * Constructor
+    * @param completionTimes - completion time of every frame, filled in by sender
+    */
+   explicit LatencyRenderer(const std::vector<Clock::time_point>& completionTimes)
+      : m_completionTimes(completionTimes)
+   {
+      m_latencies.reserve(completionTimes.size());
+   }
+
+   virtual void RenderFrame(const char* buffer, int)
+   {
+      Clock::time_point now = Clock::now();
+      int frameNumber;
+      ::memcpy(&frameNumber, buffer, sizeof(frameNumber));
+      m_latencies.push_back(
+            boost::chrono::duration<double, boost::micro>(now - m_completionTimes[frameNumber]).count());
+   }
+
+   /**
+    * Accessor to the measured latencies, must be called after JB is flushed
+    * @returns - latency of every rendered frame (microseconds)
+    */
+   std::vector<double>& GetLatencies()
+   {
+      return m_latencies;
+   }
+
+private:
+   const std::vector<Clock::time_point>&  m_completionTimes;
+   std::vector<double>                    m_latencies;
+};
+
+/**
+ * Helper function to get percentile of the sorted samples
+ * @param samples - sorted samples, not empty
+ * @param fraction - percentile as a fraction of one
+ * @returns - sample value
+ */
+double Percentile(const std::vector<double>& samples, const double fraction)
+{
+   size_t index = (size_t)(fraction * (samples.size() - 1) + 0.5);
+   return samples[index];
+}
+
+/**
+ * Helper routine to decode frames in pull mode once readiness descriptor is signaled,
+ * the way an event loop does. Does nothing on platforms without poll
+ * @param jitterBuffer - JB in pull mode
+ */
+void DecodeReadyFrames(video_coding::IJitterBuffer& jitterBuffer)
+{
+#ifndef _WIN32
+   pollfd watch = pollfd();
+   watch.fd = jitterBuffer.GetReadinessDescriptor();
+   watch.events = POLLIN;
+   if (::poll(&watch, 1, 0) == 1)
+   {
+      while (jitterBuffer.DecodeNext() == result_code::sOk)
+         ;
+   }
+#else
+   (void)jitterBuffer;
+#endif
+}
+
+/**
+ * Runs the benchmark for one wait strategy and prints results
+ * @param name - strategy name to print
+ * @param options - JB settings
+ * @param frameCount - number of frames to send
+ * @param interval - pause between frames
+ */
+void Run(
+   const char* name,
+   const video_coding::JitterBufferOptions& options,
+   const int frameCount,
+   const boost::chrono::microseconds interval)
+{
+   std::vector<Clock::time_point> completionTimes(frameCount);
+   CopyDecoder decoder;
+   LatencyRenderer renderer(completionTimes);
+   std::vector<char> fragment(FragmentSize, 'x');
+   {
+      boost::shared_ptr<video_coding::IJitterBuffer> jitterBuffer =
+            video_coding::CreateJitterBuffer(&decoder, &renderer, options);
+      for (int frameNumber = 0; frameNumber < frameCount; ++frameNumber)
+      {
+         ::memcpy(&fragment[0], &frameNumber, sizeof(frameNumber));
+         for (int i = 0; i < FragmentCount; ++i)
+         {
+            if (i == FragmentCount - 1)
+               completionTimes[frameNumber] = Clock::now();
+            jitterBuffer->TryReceivePacket(&fragment[0], FragmentSize, frameNumber, i, FragmentCount);
+            if (options.pullMode)
+               DecodeReadyFrames(*jitterBuffer);
+         }
+         boost::this_thread::sleep_for(interval);
+      }
+      jitterBuffer->Flush();
+   }
+
+   std::vector<double>& latencies = renderer.GetLatencies();
+   if (latencies.empty())
+      return;
+   std::sort(latencies.begin(), latencies.end());
+   std::cout << std::left << std::setw(16) << name << std::right << std::fixed
+         << std::setprecision(1)
+         << std::setw(10) << Percentile(latencies, 0.5)
+         << std::setw(10) << Percentile(latencies, 0.99)
+         << std::setw(10) << Percentile(latencies, 0.999)
+         << std::setw(10) << latencies.back() << std::endl;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+   const int frameCount = argc > 1 ? ::atoi(argv[1]) : 10000;
+   const boost::chrono::microseconds interval(argc > 2 ? ::atoi(argv[2]) : 100);
+   const int spinTime = argc > 3 ? ::atoi(argv[3]) : 50;
+   if (frameCount <= 0 || interval.count() < 0 || spinTime < 0)
+   {
+      std::cerr << "Usage: " << argv[0] << " [<frames> [<interval us> [<spin time us>]]]" << std::endl;
+      return 1;
+   }
+
+   // debug records of every fragment would dominate the measurement
+   logger::Log::SetLogLevel(logger::Warning);
+
+   std::cout << "completion-to-render latency, us (" << frameCount << " frames, "
+         << interval.count() << " us apart)" << std::endl;
+   std::cout << std::left << std::setw(16) << "strategy" << std::right
+         << std::setw(10) << "p50" << std::setw(10) << "p99"
+         << std::setw(10) << "p999" << std::setw(10) << "max" << std::endl;
+
+   video_coding::JitterBufferOptions options;
+   options.waitStrategy = video_coding::BlockingWait;
+   Run("block", options, frameCount, interval);
+
+   options.waitStrategy = video_coding::SpinThenParkWait;
+   options.spinTime = spinTime;
+   Run("spin-then-park", options, frameCount, interval);
+
+   options.waitStrategy = video_coding::BusySpinWait;
+   Run("busy-spin", options, frameCount, interval);
+
+   options.waitStrategy = video_coding::BlockingWait;
+   options.pullMode = true;
+   Run("pull", options, frameCount, interval);
+   return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ *  @file
+ *  \brief     SystemClock and SimulatedClock classes implementation
+ *  \details   Holds implementation of the IClock interface and clock factory functions
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "clock_impl.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#include <vector>
+#include <boost/chrono.hpp>
+
+namespace video_coding
+{
+
+IClock* GetSystemClock()
+{
+   static SystemClock systemClock;
+   return &systemClock;
+}
+
+boost::shared_ptr<ISimulatedClock> CreateSimulatedClock(const TimeUs startTime)
+{
+   boost::shared_ptr<ISimulatedClock> clock;
+   clock.reset( new SimulatedClock(startTime) );
+   return clock;
+}
+
+TimeUs SystemClock::GetTime()
+{
+   using namespace boost::chrono;
+   return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool SystemClock::WaitUntil(Lock& lock, boost::condition_variable& condition, const TimeUs deadline)
+{
+   TimeUs timeout = deadline - GetTime();
+   if (timeout <= 0)
+      return false;
+
+   condition.timed_wait(lock, boost::posix_time::microseconds(timeout));
+   return GetTime() < deadline;
+}
+
+SimulatedClock::SimulatedClock(const TimeUs startTime)
+   : m_time(startTime)
+   , m_notifyingCount(0)
+{}
+
+TimeUs SimulatedClock::GetTime()
+{
+   LOCK lock(m_guard);
+   return m_time;
+}
+
+bool SimulatedClock::WaitUntil(Lock& lock, boost::condition_variable& condition, const TimeUs deadline)
+{
+   Waiters::iterator it;
+   {
+      LOCK guard(m_guard);
+      if (m_time >= deadline)
+         return false;
+      it = m_waiters.insert(Waiter(&condition, lock.mutex()));
+   }
+
+   // AdvanceTime locks the mutex to notify, so it can't do it before the wait starts
+   condition.wait(lock);
+
+   // lock is released while waiting for notifiers, as they need it
+   lock.unlock();
+   bool beforeDeadline = false;
+   {
+      boost::unique_lock<boost::mutex> guard(m_guard);
+      m_waiters.erase(it);
+      while (m_notifyingCount)
+         m_notifiedCondition.wait(guard);
+      beforeDeadline = m_time < deadline;
+   }
+   lock.lock();
+   return beforeDeadline;
+}
+
+void SimulatedClock::AdvanceTime(const TimeUs delta)
+{
+   CHECK_ARGUMENT(delta >= 0, "Simulated time can't go backwards!");
+
+   std::vector<Waiter> waiters;
+   {
+      LOCK lock(m_guard);
+      m_time += delta;
+      waiters.assign(m_waiters.begin(), m_waiters.end());
+      ++m_notifyingCount;
+   }
+
+   // waiters lock m_guard with their own mutex held, so it is released first
+   for (size_t i = 0; i < waiters.size(); ++i)
+   {
+      LOCK lock(*waiters[i].second);
+      waiters[i].first->notify_all();
+   }
+
+   LOCK lock(m_guard);
+   --m_notifyingCount;
+   m_notifiedCondition.notify_all();
+}
+
+} // namespace video_coding
@@ -0,0 +1,77 @@
+/**
+ *  @file
+ *  \brief     SystemClock and SimulatedClock classes declaration
+ *  \details   Holds declaration of the IClock interface implementations
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_CLOCK_IMPL_H
+#define VIDEO_CODING_CLOCK_IMPL_H
+
+#include <video_coding/interface/clock.h>
+// third-party
+#include <set>
+#include <utility>
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * SystemClock class
+ * Implements IClock interface on top of the monotonic system time
+ */
+class SystemClock
+   : public IClock
+   , boost::noncopyable
+{
+public:
+   virtual TimeUs GetTime();
+   virtual bool WaitUntil(Lock& lock, boost::condition_variable& condition, TimeUs deadline);
+};
+
+/**
+ * SimulatedClock class
+ * Implements ISimulatedClock interface. Keeps track of condition variables currently
+ * blocked in WaitUntil, along with their mutexes, to be able to wake them up when the
+ * time is advanced. Waiters are notified with their own mutex locked, so notification
+ * can't slip in before the waiter blocks, and no real-time polling is needed.
+ */
+class SimulatedClock
+   : public ISimulatedClock
+   , boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor
+    * @param startTime - initial value of simulated time
+    */
+   SimulatedClock(TimeUs startTime);
+
+   virtual TimeUs GetTime();
+   virtual bool WaitUntil(Lock& lock, boost::condition_variable& condition, TimeUs deadline);
+   virtual void AdvanceTime(TimeUs delta);
+
+private:
+   typedef boost::lock_guard<boost::mutex> LOCK;
+   typedef std::pair<boost::condition_variable*, boost::mutex*> Waiter;
+   typedef std::multiset<Waiter> Waiters;
+
+   /// mutex to grant exclusive access to current time and list of waiters
+   boost::mutex               m_guard;
+   /// current simulated time
+   TimeUs                     m_time;
+   /// condition variables which are currently blocked in WaitUntil and their mutexes
+   Waiters                    m_waiters;
+   /// number of AdvanceTime calls notifying waiters outside of m_guard. Waiter doesn't
+   /// return while it is non-zero, so the notified condition and mutex stay alive
+   int                        m_notifyingCount;
+   /// condition variable to let returning waiters know notification is finished
+   boost::condition_variable  m_notifiedCondition;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_CLOCK_IMPL_H
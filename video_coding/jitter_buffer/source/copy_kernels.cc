@@ -0,0 +1,227 @@
+/**
+ *  @file
+ *  \brief     Copy kernels implementation
+ *  \details   Holds implementation of the copy functions. SIMD kernels are compiled for
+ *             their instruction sets by function attributes and picked at run time, so
+ *             the library itself runs on any x86 CPU. Kernels leave the stores unfenced,
+ *             StreamingCopy fences them on return
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "copy_kernels.h"
+// third-party
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VIDEO_CODING_X86_COPY_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+using video_coding::CopyKernel;
+
+#ifdef VIDEO_CODING_X86_COPY_KERNELS
+
+/**
+ * Helper routine to copy the unaligned head, so that the destination is aligned for
+ * the streaming stores
+ * @param destination, source, size - in/out parameters, advanced past the head
+ * @param alignment - required destination alignment
+ */
+inline void CopyHead(char*& destination, const char*& source, size_t& size, const size_t alignment)
+{
+   size_t head = (alignment - ((size_t)destination & (alignment - 1))) & (alignment - 1);
+   if (head > size)
+      head = size;
+   ::memcpy(destination, source, head);
+   destination += head;
+   source += head;
+   size -= head;
+}
+
+__attribute__((target("sse2")))
+void StreamingCopySse2(char* destination, const char* source, size_t size)
+{
+   CopyHead(destination, source, size, 16);
+   for (; size >= 64; size -= 64, source += 64, destination += 64)
+   {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 16));
+      __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 32));
+      __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 48));
+      _mm_stream_si128(reinterpret_cast<__m128i*>(destination), a);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(destination + 16), b);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(destination + 32), c);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(destination + 48), d);
+   }
+   for (; size >= 16; size -= 16, source += 16, destination += 16)
+   {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(destination),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+   }
+   ::memcpy(destination, source, size);
+}
+
+__attribute__((target("avx2")))
+void StreamingCopyAvx2(char* destination, const char* source, size_t size)
+{
+   CopyHead(destination, source, size, 32);
+   for (; size >= 128; size -= 128, source += 128, destination += 128)
+   {
+      __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+      __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 32));
+      __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 64));
+      __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 96));
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(destination), a);
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + 32), b);
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + 64), c);
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + 96), d);
+   }
+   for (; size >= 32; size -= 32, source += 32, destination += 32)
+   {
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(destination),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)));
+   }
+   ::memcpy(destination, source, size);
+   // avoids AVX-SSE transition penalty in the caller
+   _mm256_zeroupper();
+}
+
+__attribute__((target("avx512f")))
+void StreamingCopyAvx512(char* destination, const char* source, size_t size)
+{
+   CopyHead(destination, source, size, 64);
+   for (; size >= 256; size -= 256, source += 256, destination += 256)
+   {
+      __m512i a = _mm512_loadu_si512(source);
+      __m512i b = _mm512_loadu_si512(source + 64);
+      __m512i c = _mm512_loadu_si512(source + 128);
+      __m512i d = _mm512_loadu_si512(source + 192);
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(destination), a);
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(destination + 64), b);
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(destination + 128), c);
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(destination + 192), d);
+   }
+   for (; size >= 64; size -= 64, source += 64, destination += 64)
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(destination), _mm512_loadu_si512(source));
+   ::memcpy(destination, source, size);
+   _mm256_zeroupper();
+}
+
+__attribute__((target("sse2")))
+void FenceSse2()
+{
+   _mm_sfence();
+}
+
+#endif // VIDEO_CODING_X86_COPY_KERNELS
+
+/**
+ * Helper routine to detect the fastest supported kernel
+ * @returns - the kernel
+ */
+CopyKernel DetectStreamingCopyKernel()
+{
+   const CopyKernel kernels[] =
+   {
+      video_coding::Avx512CopyKernel,
+      video_coding::Avx2CopyKernel,
+      video_coding::Sse2CopyKernel
+   };
+   for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); ++i)
+   {
+      if (video_coding::IsCopyKernelSupported(kernels[i]))
+         return kernels[i];
+   }
+   return video_coding::ScalarCopyKernel;
+}
+
+/// the fastest supported kernel, detected during static initialization
+const CopyKernel BestCopyKernel = DetectStreamingCopyKernel();
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+bool IsCopyKernelSupported(const CopyKernel kernel)
+{
+   switch (kernel)
+   {
+      case ScalarCopyKernel:
+         return true;
+#ifdef VIDEO_CODING_X86_COPY_KERNELS
+      // may run before constructors of the runtime, see GCC documentation
+      case Sse2CopyKernel:
+         __builtin_cpu_init();
+         return __builtin_cpu_supports("sse2");
+      case Avx2CopyKernel:
+         __builtin_cpu_init();
+         return __builtin_cpu_supports("avx2");
+      case Avx512CopyKernel:
+         __builtin_cpu_init();
+         return __builtin_cpu_supports("avx512f");
+#endif
+      default:
+         return false;
+   }
+}
+
+CopyKernel GetStreamingCopyKernel()
+{
+   return BestCopyKernel;
+}
+
+void StreamingCopy(const CopyKernel kernel, char* destination, const char* source, const size_t size)
+{
+   StreamingCopyUnfenced(kernel, destination, source, size);
+   StreamingCopyFence(kernel);
+}
+
+void StreamingCopyUnfenced(
+   const CopyKernel kernel,
+   char* destination,
+   const char* source,
+   const size_t size)
+{
+   switch (kernel)
+   {
+#ifdef VIDEO_CODING_X86_COPY_KERNELS
+      case Sse2CopyKernel:
+         StreamingCopySse2(destination, source, size);
+         break;
+      case Avx2CopyKernel:
+         StreamingCopyAvx2(destination, source, size);
+         break;
+      case Avx512CopyKernel:
+         StreamingCopyAvx512(destination, source, size);
+         break;
+#endif
+      default:
+         ::memcpy(destination, source, size);
+         break;
+   }
+}
+
+void StreamingCopyFence(const CopyKernel kernel)
+{
+#ifdef VIDEO_CODING_X86_COPY_KERNELS
+   if (kernel != ScalarCopyKernel)
+      FenceSse2();
+#else
+   (void)kernel;
+#endif
+}
+
+void CopyData(char* destination, const char* source, const size_t size)
+{
+   if (size < StreamingCopyThreshold)
+      ::memcpy(destination, source, size);
+   else
+      StreamingCopy(BestCopyKernel, destination, source, size);
+}
+
+} // namespace video_coding
@@ -0,0 +1,90 @@
+/**
+ *  @file
+ *  \brief     Copy kernels
+ *  \details   Holds declaration of the copy functions used for frame assembly. Large
+ *             copies bypass the cache, so that assembling a big frame doesn't evict
+ *             fragment data and decoder state
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_COPY_KERNELS_H
+#define VIDEO_CODING_COPY_KERNELS_H
+
+// third-party
+#include <stddef.h>
+
+namespace video_coding
+{
+
+/// copies of at least this size (bytes) are done by StreamingCopy, smaller ones are
+/// expected to be read soon and stay in the cache
+const size_t StreamingCopyThreshold = 256 * 1024;
+
+/**
+ * Implementations of StreamingCopy
+ */
+enum CopyKernel
+{
+   /// plain memcpy, used where nothing better is available
+   ScalarCopyKernel,
+   /// 16-byte non-temporal stores
+   Sse2CopyKernel,
+   /// 32-byte non-temporal stores
+   Avx2CopyKernel,
+   /// 64-byte non-temporal stores
+   Avx512CopyKernel
+};
+
+/**
+ * Checks the kernel is compiled in and supported by the CPU. Does not throw
+ * @param kernel - kernel to check
+ * @returns - true if the kernel can be used
+ */
+bool IsCopyKernelSupported(CopyKernel kernel);
+
+/**
+ * Accessor to get the fastest supported kernel, detected once. Does not throw
+ * @returns - kernel used by CopyData
+ */
+CopyKernel GetStreamingCopyKernel();
+
+/**
+ * Copies data by non-temporal stores, which go to memory without filling the cache.
+ * Stores are complete (fenced) on return. Does not throw
+ * @param kernel - kernel to use, must be supported
+ * @param destination - destination buffer, any alignment
+ * @param source - source buffer, any alignment, must not overlap destination
+ * @param size - number of bytes to copy
+ */
+void StreamingCopy(CopyKernel kernel, char* destination, const char* source, size_t size);
+
+/**
+ * Same as StreamingCopy, but the stores are not fenced, so that a series of copies
+ * (e.g. fragments of one frame) pays for a single StreamingCopyFence after the last
+ * one. Data must not be handed to another thread before the fence. Does not throw
+ * @param kernel - kernel to use, must be supported
+ * @param destination - destination buffer, any alignment
+ * @param source - source buffer, any alignment, must not overlap destination
+ * @param size - number of bytes to copy
+ */
+void StreamingCopyUnfenced(CopyKernel kernel, char* destination, const char* source, size_t size);
+
+/**
+ * Completes the stores of preceding StreamingCopyUnfenced calls. Does not throw
+ * @param kernel - kernel the copies were done with
+ */
+void StreamingCopyFence(CopyKernel kernel);
+
+/**
+ * Copies data, dispatching on size: memcpy below StreamingCopyThreshold, StreamingCopy
+ * with the fastest kernel otherwise. Does not throw
+ * @param destination - destination buffer
+ * @param source - source buffer, must not overlap destination
+ * @param size - number of bytes to copy
+ */
+void CopyData(char* destination, const char* source, size_t size);
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_COPY_KERNELS_H
@@ -0,0 +1,198 @@
+/**
+ *  @file
+ *  \brief     CRC32C helpers implementation
+ *  \details   Holds implementation of the CRC32C functions. Hardware kernel is compiled
+ *             for SSE4.2 by function attribute and picked at run time on x86, and used
+ *             where the compiler targets the CRC extension on ARM
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "crc32c.h"
+// third-party
+#include <string.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define VIDEO_CODING_X86_CRC32C
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define VIDEO_CODING_ARM_CRC32C
+#include <arm_acle.h>
+#endif
+
+namespace
+{
+
+using video_coding::Crc32cKernel;
+
+/// reflected Castagnoli polynomial
+const boost::uint32_t Polynomial = 0x82F63B78;
+
+/**
+ * Lookup table of the software kernel
+ */
+class Crc32cTable
+{
+public:
+   Crc32cTable()
+   {
+      for (boost::uint32_t i = 0; i < 256; ++i)
+      {
+         boost::uint32_t crc = i;
+         for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (Polynomial & (0 - (crc & 1)));
+         m_table[i] = crc;
+      }
+   }
+
+   boost::uint32_t Update(boost::uint32_t crc, const unsigned char byte) const
+   {
+      return (crc >> 8) ^ m_table[(crc ^ byte) & 0xFF];
+   }
+
+private:
+   boost::uint32_t m_table[256];
+};
+
+const Crc32cTable Table;
+
+/**
+ * Software kernel: copies (if destination is set) and checksums byte by byte
+ */
+boost::uint32_t SoftwareCrc32c(char* destination, const char* source, const size_t size)
+{
+   boost::uint32_t crc = 0xFFFFFFFF;
+   for (size_t i = 0; i < size; ++i)
+      crc = Table.Update(crc, (unsigned char)source[i]);
+   if (destination)
+      ::memcpy(destination, source, size);
+   return ~crc;
+}
+
+#if defined(VIDEO_CODING_X86_CRC32C)
+
+__attribute__((target("sse4.2")))
+boost::uint32_t HardwareCrc32c(char* destination, const char* source, size_t size)
+{
+   boost::uint64_t crc = 0xFFFFFFFF;
+   for (; size >= 8; size -= 8, source += 8)
+   {
+      boost::uint64_t word;
+      ::memcpy(&word, source, 8);
+      crc = _mm_crc32_u64(crc, word);
+      if (destination)
+      {
+         ::memcpy(destination, &word, 8);
+         destination += 8;
+      }
+   }
+   boost::uint32_t crc32 = (boost::uint32_t)crc;
+   for (; size; --size, ++source)
+   {
+      crc32 = _mm_crc32_u8(crc32, (unsigned char)*source);
+      if (destination)
+         *destination++ = *source;
+   }
+   return ~crc32;
+}
+
+#elif defined(VIDEO_CODING_ARM_CRC32C)
+
+boost::uint32_t HardwareCrc32c(char* destination, const char* source, size_t size)
+{
+   boost::uint32_t crc = 0xFFFFFFFF;
+   for (; size >= 8; size -= 8, source += 8)
+   {
+      boost::uint64_t word;
+      ::memcpy(&word, source, 8);
+      crc = __crc32cd(crc, word);
+      if (destination)
+      {
+         ::memcpy(destination, &word, 8);
+         destination += 8;
+      }
+   }
+   for (; size; --size, ++source)
+   {
+      crc = __crc32cb(crc, (unsigned char)*source);
+      if (destination)
+         *destination++ = *source;
+   }
+   return ~crc;
+}
+
+#endif
+
+/**
+ * Helper routine to run the kernel
+ * @param destination - destination buffer, zero to checksum only
+ * @param source, size - data
+ * @param kernel - kernel to run
+ * @returns - the checksum
+ */
+inline boost::uint32_t RunKernel(
+   char* destination,
+   const char* source,
+   const size_t size,
+   const Crc32cKernel kernel)
+{
+#if defined(VIDEO_CODING_X86_CRC32C) || defined(VIDEO_CODING_ARM_CRC32C)
+   if (kernel == video_coding::HardwareCrc32cKernel)
+      return HardwareCrc32c(destination, source, size);
+#endif
+   return SoftwareCrc32c(destination, source, size);
+}
+
+/**
+ * Helper routine to detect the fastest supported kernel
+ * @returns - the kernel
+ */
+Crc32cKernel DetectCrc32cKernel()
+{
+   return video_coding::IsCrc32cKernelSupported(video_coding::HardwareCrc32cKernel) ?
+         video_coding::HardwareCrc32cKernel : video_coding::SoftwareCrc32cKernel;
+}
+
+/// the fastest supported kernel, detected during static initialization
+const Crc32cKernel BestCrc32cKernel = DetectCrc32cKernel();
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+bool IsCrc32cKernelSupported(const Crc32cKernel kernel)
+{
+   if (kernel == SoftwareCrc32cKernel)
+      return true;
+#if defined(VIDEO_CODING_X86_CRC32C)
+   // may run before constructors of the runtime, see GCC documentation
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("sse4.2");
+#elif defined(VIDEO_CODING_ARM_CRC32C)
+   return true;
+#else
+   return false;
+#endif
+}
+
+Crc32cKernel GetCrc32cKernel()
+{
+   return BestCrc32cKernel;
+}
+
+boost::uint32_t ComputeCrc32c(const char* source, const size_t size, const Crc32cKernel kernel)
+{
+   return RunKernel(0, source, size, kernel);
+}
+
+boost::uint32_t CopyWithCrc32c(
+   char* destination,
+   const char* source,
+   const size_t size,
+   const Crc32cKernel kernel)
+{
+   return RunKernel(destination, source, size, kernel);
+}
+
+} // namespace video_coding
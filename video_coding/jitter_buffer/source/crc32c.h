@@ -0,0 +1,70 @@
+/**
+ *  @file
+ *  \brief     CRC32C helpers
+ *  \details   Holds declaration of the CRC32C (Castagnoli) functions used to verify
+ *             fragment integrity
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_CRC32C_H
+#define VIDEO_CODING_CRC32C_H
+
+// third-party
+#include <stddef.h>
+#include <boost/cstdint.hpp>
+
+namespace video_coding
+{
+
+/**
+ * Implementations of the CRC32C functions
+ */
+enum Crc32cKernel
+{
+   /// table lookup, used where nothing better is available
+   SoftwareCrc32cKernel,
+   /// SSE4.2 CRC32 instruction (x86) or CRC extension (ARMv8)
+   HardwareCrc32cKernel
+};
+
+/**
+ * Checks the kernel is compiled in and supported by the CPU. Does not throw
+ * @param kernel - kernel to check
+ * @returns - true if the kernel can be used
+ */
+bool IsCrc32cKernelSupported(Crc32cKernel kernel);
+
+/**
+ * Accessor to get the fastest supported kernel, detected once. Does not throw
+ * @returns - kernel used by ComputeCrc32c and CopyWithCrc32c
+ */
+Crc32cKernel GetCrc32cKernel();
+
+/**
+ * Computes CRC32C of the data. Does not throw
+ * @param source - data
+ * @param size - data size
+ * @param kernel - kernel to use, must be supported
+ * @returns - the checksum
+ */
+boost::uint32_t ComputeCrc32c(const char* source, size_t size, Crc32cKernel kernel = GetCrc32cKernel());
+
+/**
+ * Copies the data and computes its CRC32C in a single pass, so that the source is read
+ * once. Does not throw
+ * @param destination - destination buffer
+ * @param source - source buffer, must not overlap destination
+ * @param size - number of bytes to copy
+ * @param kernel - kernel to use, must be supported
+ * @returns - checksum of the data
+ */
+boost::uint32_t CopyWithCrc32c(
+   char* destination,
+   const char* source,
+   size_t size,
+   Crc32cKernel kernel = GetCrc32cKernel());
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_CRC32C_H
@@ -0,0 +1,125 @@
+/**
+ *  @file
+ *  \brief     DuplicateFilter class implementation
+ *  \details   Holds implementation of the DuplicateFilter class
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "duplicate_filter.h"
+
+namespace
+{
+
+const boost::uint64_t TagMask = 0xFFFFFFFF00000000ULL;
+
+/**
+ * Helper function to get tag of the word owned by the frame
+ * @param frameNumber - frame number
+ * @returns - tag, upper half of the word
+ */
+inline boost::uint64_t MakeTag(const int frameNumber)
+{
+   return (boost::uint64_t)(boost::uint32_t)frameNumber << 32;
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+DuplicateFilter::DuplicateFilter()
+   : m_words(new Word[SlotCount * WordsPerSlot])
+   , m_arrivalTimes(new ArrivalTime[SlotCount * MaxTrackedFragments])
+   , m_deliveredCount(0)
+{
+   // zero word is owned by frame 0 with no fragments delivered, which is
+   // indistinguishable from free word
+   for (int i = 0; i < SlotCount * WordsPerSlot; ++i)
+      m_words[i].store(0, boost::memory_order_relaxed);
+   for (int i = 0; i < SlotCount * MaxTrackedFragments; ++i)
+      m_arrivalTimes[i].store(0, boost::memory_order_relaxed);
+}
+
+DuplicateFilter::Verdict DuplicateFilter::Admit(
+   const int frameNumber,
+   const int fragmentNumber,
+   const TimeUs now,
+   TimeUs& lag)
+{
+   if (fragmentNumber >= MaxTrackedFragments)
+      return Untracked;
+
+   const boost::uint64_t tag = MakeTag(frameNumber);
+   const boost::uint64_t bit = 1ULL << (fragmentNumber % BitsPerWord);
+   Word& word = GetWord(frameNumber, fragmentNumber);
+   ArrivalTime& arrivalTime =
+         m_arrivalTimes[(frameNumber % SlotCount) * MaxTrackedFragments + fragmentNumber];
+
+   boost::uint64_t value = word.load(boost::memory_order_acquire);
+   for (;;)
+   {
+      boost::uint64_t desired;
+      if ((value & TagMask) == tag)
+      {
+         if (value & bit)
+         {
+            // the first copy stores its arrival time before publishing the bit
+            lag = (TimeUs)(boost::uint32_t)(
+                  (boost::uint32_t)now - arrivalTime.load(boost::memory_order_relaxed));
+            return Duplicate;
+         }
+         desired = value | bit;
+      }
+      else if ((int)(value >> 32) > frameNumber)
+      {
+         // slot is reclaimed by a newer frame already
+         return Untracked;
+      }
+      else
+      {
+         desired = tag | bit;
+      }
+
+      // concurrent first copies may both store the time, the difference is negligible
+      arrivalTime.store((boost::uint32_t)now, boost::memory_order_relaxed);
+      if (word.compare_exchange_weak(value, desired,
+            boost::memory_order_release, boost::memory_order_acquire))
+         break;
+   }
+
+   m_deliveredCount.fetch_add(1, boost::memory_order_relaxed);
+   return FirstCopy;
+}
+
+void DuplicateFilter::Revoke(const int frameNumber, const int fragmentNumber)
+{
+   if (fragmentNumber >= MaxTrackedFragments)
+      return;
+
+   const boost::uint64_t tag = MakeTag(frameNumber);
+   const boost::uint64_t bit = 1ULL << (fragmentNumber % BitsPerWord);
+   Word& word = GetWord(frameNumber, fragmentNumber);
+
+   boost::uint64_t value = word.load(boost::memory_order_relaxed);
+   while ((value & TagMask) == tag && (value & bit))
+   {
+      if (word.compare_exchange_weak(value, value & ~bit, boost::memory_order_relaxed))
+      {
+         m_deliveredCount.fetch_sub(1, boost::memory_order_relaxed);
+         return;
+      }
+   }
+}
+
+boost::uint64_t DuplicateFilter::GetDeliveredCount() const
+{
+   return m_deliveredCount.load(boost::memory_order_relaxed);
+}
+
+DuplicateFilter::Word& DuplicateFilter::GetWord(const int frameNumber, const int fragmentNumber)
+{
+   return m_words[(frameNumber % SlotCount) * WordsPerSlot + fragmentNumber / BitsPerWord];
+}
+
+} // namespace video_coding
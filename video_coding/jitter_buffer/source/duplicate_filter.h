@@ -0,0 +1,112 @@
+/**
+ *  @file
+ *  \brief     DuplicateFilter class declaration
+ *  \details   Lock-free record of fragments delivered by redundant ingest paths
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_DUPLICATE_FILTER_H
+#define VIDEO_CODING_DUPLICATE_FILTER_H
+
+#include <video_coding/interface/clock.h>
+// third-party
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * DuplicateFilter class
+ * Remembers which fragments of the recent frames have been delivered, so that the
+ * redundant copy coming over another path is recognized in O(1) without locking.
+ * Frames are mapped to a fixed ring of slots by frame number; every slot holds
+ * arrival bitmap of the frame fragments split into words, each word tagged with the
+ * frame number it belongs to, so a newer frame reclaims the slot word by word with
+ * a single compare-and-swap. Fragments the filter cannot track (fragment number out
+ * of range, slot reclaimed by a newer frame) are reported as Untracked and left
+ * to JB own duplicate check
+ */
+class DuplicateFilter : boost::noncopyable
+{
+public:
+
+   /**
+    * Result of the fragment check
+    */
+   enum Verdict
+   {
+      /// fragment is delivered for the first time
+      FirstCopy,
+      /// fragment has already been delivered
+      Duplicate,
+      /// filter does not track the fragment
+      Untracked
+   };
+
+   /**
+    * Constructor. Allocates the ring of slots
+    */
+   DuplicateFilter();
+
+   /**
+    * Marks fragment as delivered. Thread-safe, lock-free
+    * @param frameNumber - frame number, non-negative
+    * @param fragmentNumber - fragment number, non-negative
+    * @param now - current time, remembered as arrival time of the first copy
+    * @param lag - out parameter, for Duplicate verdict the time since the first copy
+    *              arrived, untouched otherwise
+    * @returns - verdict, see Verdict
+    */
+   Verdict Admit(int frameNumber, int fragmentNumber, TimeUs now, TimeUs& lag);
+
+   /**
+    * Clears delivery mark set by Admit for the first copy which then was not stored
+    * by JB, so that the redundant copy is accepted instead. Thread-safe, lock-free
+    * @param frameNumber - frame number
+    * @param fragmentNumber - fragment number
+    */
+   void Revoke(int frameNumber, int fragmentNumber);
+
+   /**
+    * Accessor to get number of distinct fragments delivered, lock-free
+    * @returns - number of FirstCopy verdicts not revoked later
+    */
+   boost::uint64_t GetDeliveredCount() const;
+
+private:
+   typedef boost::atomic<boost::uint64_t> Word;
+   typedef boost::atomic<boost::uint32_t> ArrivalTime;
+
+   /**
+    * Helper function to find the word which tracks the fragment
+    * @param frameNumber - frame number
+    * @param fragmentNumber - fragment number, must be less than MaxTrackedFragments
+    * @returns - reference to the word
+    */
+   Word& GetWord(int frameNumber, int fragmentNumber);
+
+   /// number of frame slots, frames further apart than that evict each other
+   static const int SlotCount = 256;
+   /// number of fragments per frame tracked by the filter
+   static const int MaxTrackedFragments = 256;
+   /// fragment bits per word, the upper half of the word is the frame number tag
+   static const int BitsPerWord = 32;
+   /// number of words per frame slot
+   static const int WordsPerSlot = MaxTrackedFragments / BitsPerWord;
+
+   /// tagged arrival bitmaps, WordsPerSlot words per slot
+   boost::scoped_array<Word>              m_words;
+   /// arrival time of the first copy of every tracked fragment (lower 32 bits of the
+   /// clock, enough to measure lag of up to half an hour), MaxTrackedFragments per slot
+   boost::scoped_array<ArrivalTime>       m_arrivalTimes;
+   /// number of distinct fragments delivered
+   boost::atomic<boost::uint64_t>         m_deliveredCount;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_DUPLICATE_FILTER_H
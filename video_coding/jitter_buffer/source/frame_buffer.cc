@@ -7,37 +7,33 @@
  */
 
 #include "frame_buffer.h"
+#include "copy_kernels.h"
+#include "crc32c.h"
+#include <video_coding/interface/jitter_buffer.h>
 #include <logger/logger.h>
 // third-party
 #include <string.h>
-#include <boost/bind.hpp>
+#include <algorithm>
 
 namespace
 {
 
-/**
- * Helper function to perform comparison between two FrameFragment pointers
- * @param lhs - left-hand side frame fragment
- * @param rhs - right-hand side frame fragment
- * @returns - true if lhs less than rhs, false otherwise
- */
+/// metadata arrays are allocated for the expected number of fragments, but no more
+/// than this, as the number comes from the network
+const int MaxInitialMetadataCapacity = 1024;
 
-static bool FragmentCompareLess(
-   const video_coding::FrameFragmentPtr& lhs,
-   const video_coding::FrameFragmentPtr& rhs)
-{
-   return *(lhs.get()) < *(rhs.get());
-}
+/// limit of the payload arena size reserved upfront (bytes)
+const size_t MaxInitialPayloadCapacity = 1024 * 1024;
 
 /**
- * Helper function to perform comparison between two fragmentNumber and FrameFragment object
- * @param fragmentNumber - left-hand side frame fragment
- * @param rhs - right-hand side frame fragment
- * @returns - true if FrameFragment has  the same fragment number
+ * Helper routine to read the checksum trailer
+ * @param data - trailer start
+ * @returns - checksum stored in little-endian byte order
  */
-static bool FragmentCompareEqual(const int fragmentNumber, const video_coding::FrameFragmentPtr& rhs)
+boost::uint32_t ReadChecksum(const char* data)
 {
-   return *(rhs.get()) == fragmentNumber;
+   const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+   return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((boost::uint32_t)bytes[3] << 24);
 }
 
 } // unnamed namespace
@@ -49,55 +45,156 @@ FrameBuffer::FrameBuffer(const char* buffer,
          const int length,
          const int frameNumber,
          const int fragmentNumber,
-         const int numFragmentsInThisFrame)
+         const int numFragmentsInThisFrame,
+         const FrameInfo& info,
+         const bool checksummed,
+         IFragmentDecryptor* const decryptor)
    : m_frameNumber(frameNumber)
    , m_numFragmentsInThisFrame(numFragmentsInThisFrame)
    , m_frameIsComplete(false)
    , m_currentFrameSize(0)
+   , m_fragmentCount(0)
+   , m_metadataCapacity(std::min(numFragmentsInThisFrame, MaxInitialMetadataCapacity))
+   , m_metadata(new int[3 * m_metadataCapacity])
+   , m_fragmentNumbers(m_metadata.get())
+   , m_fragmentLengths(m_metadata.get() + m_metadataCapacity)
+   , m_fragmentOffsets(m_metadata.get() + 2 * m_metadataCapacity)
+   // fragments of a frame are usually of the same size
+   , m_payloadCapacity(std::min((size_t)numFragmentsInThisFrame * length, MaxInitialPayloadCapacity))
+   , m_payloadSize(0)
+   , m_payload(new char[m_payloadCapacity])
+   , m_payloadInOrder(true)
+   , m_checksummed(checksummed)
+   , m_decryptor(decryptor)
+   , m_info(info)
+   , m_arrivalTime(0)
+   , m_completionTime(0)
 {
    AppendFragment(buffer, length, fragmentNumber);
 }
 
-void FrameBuffer::AppendFragment(const char* buffer, int length, int fragmentNumber)
+FrameBuffer::AppendResult FrameBuffer::AppendFragment(
+   const char* buffer,
+   int length,
+   const int fragmentNumber)
 {
    if (m_frameIsComplete)
-      return;
-
-   FrameFragments::const_iterator it;
+      return FragmentDuplicated;
 
-   int count = std::count_if(
-         m_frameFragments.begin(),
-         m_frameFragments.end(),
-         boost::bind(FragmentCompareEqual, fragmentNumber, _1) );
+   // fragments usually arrive in order, so the tail is checked first
+   int position = m_fragmentCount;
+   if (position && fragmentNumber <= m_fragmentNumbers[position - 1])
+   {
+      position = (int)(std::lower_bound(m_fragmentNumbers, m_fragmentNumbers + m_fragmentCount,
+            fragmentNumber) - m_fragmentNumbers);
+      if (m_fragmentNumbers[position] == fragmentNumber)
+      {
+         LOGDBG << "Retransmitted fragment #" << fragmentNumber;
+         return FragmentDuplicated;
+      }
+   }
 
-   if (count)
+   // arena is not zero-filled, payload is written into it once
+   const int offset = (int)m_payloadSize;
+   char* payload = ReservePayload(length);
+   if (m_checksummed)
    {
-      LOGDBG << "Retransmitted fragment #" << fragmentNumber;
-      return;
+      // payload is read once: checksum is computed while it is copied to the arena
+      length -= FragmentChecksumSize;
+      if (CopyWithCrc32c(payload, buffer, length) != ReadChecksum(buffer + length))
+      {
+         LOGDBG << "Corrupted fragment #" << fragmentNumber;
+         return FragmentCorrupted;
+      }
+   }
+   else if (m_decryptor)
+   {
+      // payload is read once: ciphertext is decrypted straight into the arena, which
+      // has room for the overhead until the plain length is known
+      length = m_decryptor->DecryptFragment(buffer, length, m_frameNumber, fragmentNumber,
+            payload);
+      if (length <= 0)
+      {
+         LOGDBG << "Fragment #" << fragmentNumber << " failed authentication";
+         return FragmentCorrupted;
+      }
    }
+   else
+      ::memcpy(payload, buffer, length);
+   m_payloadSize += length;
 
+   if (position != m_fragmentCount)
+      m_payloadInOrder = false;
+   InsertMetadata(position, fragmentNumber, length, offset);
    m_currentFrameSize += length;
-   FrameFragmentPtr newFragment( new FrameFragment(buffer, length, fragmentNumber) );
-   m_frameFragments.push_back(newFragment);
 
-   if (m_frameFragments.size() == (size_t)m_numFragmentsInThisFrame)
+   if (m_fragmentCount == m_numFragmentsInThisFrame)
       m_frameIsComplete = true;
+   return FragmentAppended;
 }
 
 void FrameBuffer::GetAssembledData(char* outputBuffer)
 {
-   std::sort(m_frameFragments.begin(), m_frameFragments.end(), FragmentCompareLess);
+   if (m_payloadInOrder)
+   {
+      CopyData(outputBuffer, m_payload.get(), m_payloadSize);
+      return;
+   }
 
+   // decision is made for the whole frame, as the fragments are small on their own, and
+   // the stores are fenced once for the frame rather than per fragment
+   const bool streaming = (size_t)m_currentFrameSize >= StreamingCopyThreshold;
+   const CopyKernel kernel = streaming ? GetStreamingCopyKernel() : ScalarCopyKernel;
    int currentPos = 0;
-   int bufferLength = 0;
-   for (size_t i = 0; i < m_frameFragments.size(); ++i)
+   for (int i = 0; i < m_fragmentCount; ++i)
    {
-      bufferLength = m_frameFragments[i]->GetBufferLength();
-      ::memcpy(outputBuffer + currentPos,
-            m_frameFragments[i]->GetBufferData(),
-            bufferLength);
+      StreamingCopyUnfenced(kernel, outputBuffer + currentPos, &m_payload[m_fragmentOffsets[i]],
+            m_fragmentLengths[i]);
+      currentPos += m_fragmentLengths[i];
+   }
+   StreamingCopyFence(kernel);
+}
+
+int FrameBuffer::GetContiguousData(const int offset, std::vector<char>& outputBuffer)
+{
+   outputBuffer.clear();
+   int currentPos = 0;
+   for (int i = 0; i < m_fragmentCount && m_fragmentNumbers[i] == i; ++i)
+   {
+      const char* bufferData = &m_payload[m_fragmentOffsets[i]];
+      int bufferLength = m_fragmentLengths[i];
+      int skipped = std::min(std::max(offset - currentPos, 0), bufferLength);
+      outputBuffer.insert(outputBuffer.end(), bufferData + skipped, bufferData + bufferLength);
       currentPos += bufferLength;
    }
+   return currentPos;
+}
+
+void FrameBuffer::GetDataWithGaps(std::vector<char>& outputBuffer,
+   std::vector<unsigned char>& fragmentPresence,
+   std::vector<int>& fragmentOffsets)
+{
+   int gapLength = 0;
+   if (m_fragmentCount)
+      gapLength = *std::max_element(m_fragmentLengths, m_fragmentLengths + m_fragmentCount);
+
+   outputBuffer.clear();
+   fragmentPresence.assign(m_numFragmentsInThisFrame, 0);
+   fragmentOffsets.assign(m_numFragmentsInThisFrame, 0);
+   int received = 0;
+   for (int i = 0; i < m_numFragmentsInThisFrame; ++i)
+   {
+      fragmentOffsets[i] = (int)outputBuffer.size();
+      if (received < m_fragmentCount && m_fragmentNumbers[received] == i)
+      {
+         const char* bufferData = &m_payload[m_fragmentOffsets[received]];
+         outputBuffer.insert(outputBuffer.end(), bufferData, bufferData + m_fragmentLengths[received]);
+         fragmentPresence[i] = 1;
+         ++received;
+      }
+      else
+         outputBuffer.resize(outputBuffer.size() + gapLength, 0);
+   }
 }
 
 int FrameBuffer::GetFrameNumber() const
@@ -115,5 +212,91 @@ bool FrameBuffer::IsFrameComplete() const
    return m_frameIsComplete;
 }
 
+FrameType FrameBuffer::GetFrameType() const
+{
+   return m_info.type;
+}
+
+bool FrameBuffer::IsIndependent() const
+{
+   return m_info.independent;
+}
+
+int FrameBuffer::GetDependencyFrameNumber() const
+{
+   return m_info.dependencyFrameNumber < 0 ? m_frameNumber - 1 : m_info.dependencyFrameNumber;
+}
+
+TimeUs FrameBuffer::GetTimestamp() const
+{
+   return m_info.timestamp;
+}
+
+void FrameBuffer::SetArrivalTime(const TimeUs arrivalTime)
+{
+   m_arrivalTime = arrivalTime;
+}
+
+TimeUs FrameBuffer::GetArrivalTime() const
+{
+   return m_arrivalTime;
+}
+
+void FrameBuffer::SetCompletionTime(const TimeUs completionTime)
+{
+   m_completionTime = completionTime;
+}
+
+TimeUs FrameBuffer::GetCompletionTime() const
+{
+   return m_completionTime;
+}
+
+void FrameBuffer::InsertMetadata(
+   const int position,
+   const int fragmentNumber,
+   const int length,
+   const int offset)
+{
+   if (m_fragmentCount == m_metadataCapacity)
+   {
+      const int capacity = m_metadataCapacity * 2;
+      boost::scoped_array<int> metadata(new int[3 * capacity]);
+      std::copy(m_fragmentNumbers, m_fragmentNumbers + m_fragmentCount, metadata.get());
+      std::copy(m_fragmentLengths, m_fragmentLengths + m_fragmentCount, metadata.get() + capacity);
+      std::copy(m_fragmentOffsets, m_fragmentOffsets + m_fragmentCount, metadata.get() + 2 * capacity);
+
+      m_metadata.swap(metadata);
+      m_metadataCapacity = capacity;
+      m_fragmentNumbers = m_metadata.get();
+      m_fragmentLengths = m_metadata.get() + capacity;
+      m_fragmentOffsets = m_metadata.get() + 2 * capacity;
+   }
+
+   std::copy_backward(m_fragmentNumbers + position, m_fragmentNumbers + m_fragmentCount,
+         m_fragmentNumbers + m_fragmentCount + 1);
+   std::copy_backward(m_fragmentLengths + position, m_fragmentLengths + m_fragmentCount,
+         m_fragmentLengths + m_fragmentCount + 1);
+   std::copy_backward(m_fragmentOffsets + position, m_fragmentOffsets + m_fragmentCount,
+         m_fragmentOffsets + m_fragmentCount + 1);
+   m_fragmentNumbers[position] = fragmentNumber;
+   m_fragmentLengths[position] = length;
+   m_fragmentOffsets[position] = offset;
+   ++m_fragmentCount;
+}
+
+char* FrameBuffer::ReservePayload(const int length)
+{
+   if (m_payloadSize + length > m_payloadCapacity)
+   {
+      const size_t capacity = std::max(m_payloadCapacity * 2, m_payloadSize + length);
+      boost::scoped_array<char> payload(new char[capacity]);
+      ::memcpy(payload.get(), m_payload.get(), m_payloadSize);
+      m_payload.swap(payload);
+      m_payloadCapacity = capacity;
+   }
+   return m_payload.get() + m_payloadSize;
+}
+
 } // namespace video_coding
 
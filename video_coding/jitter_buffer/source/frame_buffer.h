@@ -9,62 +9,121 @@
 #ifndef VIDEO_CODING_FRAME_BUFFER_H
 #define VIDEO_CODING_FRAME_BUFFER_H
 
-#include "frame_fragment.h"
+#include <video_coding/interface/clock.h>
+#include <video_coding/interface/frame_info.h>
+#include <video_coding/interface/fragment_crypto.h>
 #include <common/result_code.h>
 // third-party
-#include <boost/shared_ptr.hpp>
 #include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/move/unique_ptr.hpp>
+#include <boost/intrusive/list_hook.hpp>
+#include <boost/intrusive/set_hook.hpp>
 
 namespace video_coding
 {
 
 class FrameBuffer;
-typedef boost::shared_ptr<FrameBuffer> FrameBufferPtr;
+/// the only owner of the frame while it is not linked into frame container
+/// (see frame_queue.h). Frames are moved between pipeline stages, never shared
+typedef boost::movelib::unique_ptr<FrameBuffer> FrameBufferPtr;
 
 /**
- * FrameBuffer class represents a holder which maintains a list of fragments
- * (frame_fragment.cc) in scope of one particular frame and a bunch of operations
- * upon them.
+ * FrameBuffer class represents a holder which maintains fragments in scope of one
+ * particular frame and a bunch of operations upon them. Fragment payloads are appended
+ * to a single arena in order of arrival, fragment metadata (number, length, payload
+ * offset) is kept in separate contiguous arrays sorted by fragment number, so that
+ * duplicate check and assembly scan only the metadata they need
  */
-class FrameBuffer
+class FrameBuffer : boost::noncopyable
 {
 public:
 
+   /**
+    * Result of AppendFragment
+    */
+   enum AppendResult
+   {
+      /// fragment is stored
+      FragmentAppended,
+      /// fragment is rejected as retransmitted
+      FragmentDuplicated,
+      /// fragment is rejected as its checksum doesn't match or it fails authentication
+      FragmentCorrupted
+   };
+
    /**
     * Constructor
-    * Invokes AppendFragment directly
+    * Invokes AppendFragment directly. If the first fragment is corrupted, the frame is
+    * left empty (zero GetCurrentFrameSize)
     * @param buffer - pointer to the input data
     * @param length - length of the buffer with input data
     * @param frameNumber - frame number that new fragment of data belongs to
     * @param fragmentNumber - fragment number
     * @param numFragmentsInThisFrame - number of fragments we expect to receive to mark this
     *                                  frame as completed
+    * @param info - frame metadata
+    * @param checksummed - flag, indicates every fragment ends with the checksum trailer
+    *                      (see JitterBufferOptions::verifyFragmentChecksum), which is
+    *                      longer than FragmentChecksumSize
+    * @param decryptor - key context every fragment is decrypted with (see
+    *                    JitterBufferOptions::decryptor), zero if fragments are plain.
+    *                    Fragments are longer than its overhead
     */
    FrameBuffer(const char* buffer,
       int length,
       int frameNumber,
       int fragmentNumber,
-      int numFragmentsInThisFrame);
+      int numFragmentsInThisFrame,
+      const FrameInfo& info,
+      bool checksummed = false,
+      IFragmentDecryptor* decryptor = 0);
 
    /**
     * Method to append new fragment to the frame. Manages
     *  - frame completion flag
     *  - reject of retransmitted fragments
-    *  - creation of new FrameFragment
+    *  - copying of the payload and insertion of fragment metadata in order
+    *  - verification of the checksum, which is computed while the payload is copied
+    *  - authentication and decryption of the payload, which is decrypted right into
+    *    its place in the arena
     *
     * @param buffer - pointer to the input data
     * @param length - length of the buffer with input data
     * @param fragmentNumber - fragment number
+    * @returns - whether fragment is stored or why it is rejected
     */
-   void AppendFragment(const char* buffer, int length, int fragmentNumber);
+   AppendResult AppendFragment(const char* buffer, int length, int fragmentNumber);
 
    /**
-    * Assembles the whole frame from the array of fragments
+    * Assembles the whole frame from the array of fragments. Large frames are written
+    * bypassing the cache (see CopyData), as decoder reads them only once
     * @param outputBuffer - in/out parameter, will contain assembled frame data. Size of
     *                       complete frame can be retrieved by GetCurrentFrameSize
     */
    void GetAssembledData(char* outputBuffer);
 
+   /**
+    * Collects the data of contiguous fragments starting from the first one, which is the
+    * part of the frame that can already be decoded by a streaming decoder
+    * @param offset - number of leading bytes to skip (already collected earlier)
+    * @param outputBuffer - out parameter, will contain contiguous data following the offset
+    * @returns - total size of contiguous data, including skipped bytes
+    */
+   int GetContiguousData(int offset, std::vector<char>& outputBuffer);
+
+   /**
+    * Assembles incomplete frame. Every missing fragment is zero-filled and assumed to be
+    * as long as the longest received one
+    * @param outputBuffer - out parameter, will contain assembled frame data
+    * @param fragmentPresence - out parameter, one byte per fragment, non-zero if received
+    * @param fragmentOffsets - out parameter, offset of every fragment in outputBuffer
+    */
+   void GetDataWithGaps(std::vector<char>& outputBuffer,
+      std::vector<unsigned char>& fragmentPresence,
+      std::vector<int>& fragmentOffsets);
+
    /**
     * Accessor to get current frame number
     * @returns - number of current frame
@@ -84,8 +143,78 @@ public:
     */
    bool IsFrameComplete() const;
 
+   /**
+    * Accessor to get frame type
+    * @returns - type of the frame, see FrameInfo
+    */
+   FrameType GetFrameType() const;
+
+   /**
+    * Accessor to get flag that the frame can be decoded out of order
+    * @returns - true if the frame is independent, see FrameInfo
+    */
+   bool IsIndependent() const;
+
+   /**
+    * Accessor to get number of the frame this one is predicted from
+    * @returns - dependency frame number (previous frame if not specified by metadata),
+    *            meaningless for key frames
+    */
+   int GetDependencyFrameNumber() const;
+
+   /**
+    * Accessor to get presentation time of the frame
+    * @returns - frame timestamp, negative if unknown
+    */
+   TimeUs GetTimestamp() const;
+
+   /**
+    * Stores the moment the first fragment of the frame arrived
+    * @param arrivalTime - time in terms of JB clock
+    */
+   void SetArrivalTime(TimeUs arrivalTime);
+
+   /**
+    * Accessor to get the moment the first fragment of the frame arrived
+    * @returns - time in terms of JB clock, see SetArrivalTime
+    */
+   TimeUs GetArrivalTime() const;
+
+   /**
+    * Stores the moment frame was completed
+    * @param completionTime - time in terms of JB clock
+    */
+   void SetCompletionTime(TimeUs completionTime);
+
+   /**
+    * Accessor to get the moment frame was completed
+    * @returns - time in terms of JB clock, see SetCompletionTime
+    */
+   TimeUs GetCompletionTime() const;
+
+   /// hook of FrameQueue, frame is linked into at most one queue at a time
+   boost::intrusive::list_member_hook<>   queueHook;
+   /// hook of FrameIndex
+   boost::intrusive::set_member_hook<>    indexHook;
+
 private:
-   typedef std::vector<FrameFragmentPtr> FrameFragments;
+
+   /**
+    * Inserts fragment metadata at the given position, growing the arrays if needed
+    * @param position - index in metadata arrays
+    * @param fragmentNumber - fragment number
+    * @param length - payload length
+    * @param offset - payload offset in the arena
+    */
+   void InsertMetadata(int position, int fragmentNumber, int length, int offset);
+
+   /**
+    * Grows the arena if needed, so that it has room for the given number of bytes past
+    * the stored payloads. The room is left uninitialized for the caller to write
+    * @param length - number of bytes
+    * @returns - pointer to the room
+    */
+   char* ReservePayload(int length);
 
    /// frame number
    const int         m_frameNumber;
@@ -95,8 +224,37 @@ private:
    bool              m_frameIsComplete;
    /// holds current frame size (in bytes) - summary of all fragments sizes
    int               m_currentFrameSize;
-   /// container that holds frame fragments
-   FrameFragments    m_frameFragments;
+   /// number of fragments received
+   int                        m_fragmentCount;
+   /// capacity of metadata arrays
+   int                        m_metadataCapacity;
+   /// single allocation holding three metadata arrays of m_metadataCapacity elements
+   boost::scoped_array<int>   m_metadata;
+   /// fragment numbers in ascending order, points into m_metadata
+   int*                       m_fragmentNumbers;
+   /// payload length of every fragment, points into m_metadata
+   int*                       m_fragmentLengths;
+   /// payload offset of every fragment in the arena, points into m_metadata
+   int*                       m_fragmentOffsets;
+   /// capacity of the payload arena (bytes)
+   size_t                     m_payloadCapacity;
+   /// number of arena bytes holding the payloads
+   size_t                     m_payloadSize;
+   /// payloads of all fragments in order of arrival, bytes past m_payloadSize are
+   /// uninitialized
+   boost::scoped_array<char>  m_payload;
+   /// flag, indicates fragments arrived in order, so the arena is the assembled frame
+   bool                       m_payloadInOrder;
+   /// flag, indicates fragments end with the checksum trailer
+   const bool                 m_checksummed;
+   /// key context fragments are decrypted with, zero if they are plain
+   IFragmentDecryptor* const  m_decryptor;
+   /// frame metadata
+   const FrameInfo   m_info;
+   /// moment the first fragment arrived (in terms of JB clock)
+   TimeUs            m_arrivalTime;
+   /// moment the frame was completed (in terms of JB clock)
+   TimeUs            m_completionTime;
 };
 
 } // namespace video_coding
@@ -0,0 +1,131 @@
+/**
+ *  @file
+ *  \brief     FrameQueue and FrameIndex classes implementation
+ *  \details   Holds implementation of the FrameQueue and FrameIndex classes
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "frame_queue.h"
+// third-party
+#include <boost/checked_delete.hpp>
+
+namespace video_coding
+{
+
+FrameQueue::~FrameQueue()
+{
+   m_frames.clear_and_dispose(boost::checked_deleter<FrameBuffer>());
+}
+
+bool FrameQueue::IsEmpty() const
+{
+   return m_frames.empty();
+}
+
+size_t FrameQueue::GetSize() const
+{
+   return m_frames.size();
+}
+
+const FrameBuffer& FrameQueue::GetFront() const
+{
+   return m_frames.front();
+}
+
+void FrameQueue::PushBack(FrameBufferPtr frame)
+{
+   m_frames.push_back(*frame.release());
+}
+
+FrameBufferPtr FrameQueue::PopFront()
+{
+   FrameBuffer& frame = m_frames.front();
+   m_frames.pop_front();
+   return FrameBufferPtr(&frame);
+}
+
+void FrameQueue::Splice(FrameQueue& other)
+{
+   m_frames.splice(m_frames.end(), other.m_frames);
+}
+
+FrameQueue::ConstIterator FrameQueue::Begin() const
+{
+   return m_frames.begin();
+}
+
+FrameQueue::ConstIterator FrameQueue::End() const
+{
+   return m_frames.end();
+}
+
+int FrameIndex::FrameNumberOf::operator()(const FrameBuffer& frame) const
+{
+   return frame.GetFrameNumber();
+}
+
+FrameIndex::~FrameIndex()
+{
+   m_frames.clear_and_dispose(boost::checked_deleter<FrameBuffer>());
+}
+
+bool FrameIndex::IsEmpty() const
+{
+   return m_frames.empty();
+}
+
+size_t FrameIndex::GetSize() const
+{
+   return m_frames.size();
+}
+
+FrameBuffer* FrameIndex::Find(const int frameNumber)
+{
+   Frames::iterator it = m_frames.find(frameNumber);
+   return it == m_frames.end() ? 0 : &*it;
+}
+
+const FrameBuffer* FrameIndex::Find(const int frameNumber) const
+{
+   Frames::const_iterator it = m_frames.find(frameNumber);
+   return it == m_frames.end() ? 0 : &*it;
+}
+
+FrameBuffer* FrameIndex::GetFirst()
+{
+   return m_frames.empty() ? 0 : &*m_frames.begin();
+}
+
+const FrameBuffer* FrameIndex::GetFirst() const
+{
+   return m_frames.empty() ? 0 : &*m_frames.begin();
+}
+
+void FrameIndex::Insert(FrameBufferPtr frame)
+{
+   m_frames.insert(*frame.release());
+}
+
+FrameBufferPtr FrameIndex::Take(FrameBuffer& frame)
+{
+   m_frames.erase(m_frames.iterator_to(frame));
+   return FrameBufferPtr(&frame);
+}
+
+FrameIndex::Iterator FrameIndex::Begin()
+{
+   return m_frames.begin();
+}
+
+FrameIndex::Iterator FrameIndex::End()
+{
+   return m_frames.end();
+}
+
+FrameIndex::Iterator FrameIndex::UpperBound(const int frameNumber)
+{
+   return m_frames.upper_bound(frameNumber);
+}
+
+} // namespace video_coding
@@ -0,0 +1,178 @@
+/**
+ *  @file
+ *  \brief     FrameQueue and FrameIndex classes declaration
+ *  \details   Intrusive containers which own the frames linked into them. Frames move
+ *             between containers of the pipeline stages without any allocation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_FRAME_QUEUE_H
+#define VIDEO_CODING_FRAME_QUEUE_H
+
+#include "frame_buffer.h"
+// third-party
+#include <boost/intrusive/list.hpp>
+#include <boost/intrusive/set.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * FrameQueue class
+ * FIFO of frames linked through FrameBuffer::queueHook. Owns the frames: the frame is
+ * taken over by PushBack and given away by PopFront, frames left are deleted together
+ * with the queue
+ */
+class FrameQueue : boost::noncopyable
+{
+   typedef boost::intrusive::member_hook<FrameBuffer,
+         boost::intrusive::list_member_hook<>, &FrameBuffer::queueHook> Hook;
+   typedef boost::intrusive::list<FrameBuffer, Hook> Frames;
+
+public:
+   typedef Frames::const_iterator ConstIterator;
+
+   /**
+    * Destructor. Deletes frames left in the queue
+    */
+   ~FrameQueue();
+
+   /**
+    * Accessor to check if queue is empty
+    * @returns - true if there are no frames in the queue
+    */
+   bool IsEmpty() const;
+
+   /**
+    * Accessor to get number of frames in the queue, constant time
+    * @returns - number of frames
+    */
+   size_t GetSize() const;
+
+   /**
+    * Accessor to the head frame, queue must not be empty
+    * @returns - reference to the head frame, owned by the queue
+    */
+   const FrameBuffer& GetFront() const;
+
+   /**
+    * Takes over the frame and links it to the tail of the queue
+    * @param frame - frame to add, must not be linked into another queue
+    */
+   void PushBack(FrameBufferPtr frame);
+
+   /**
+    * Unlinks the head frame and gives it away, queue must not be empty
+    * @returns - the head frame
+    */
+   FrameBufferPtr PopFront();
+
+   /**
+    * Moves all frames of another queue to the tail of this one, constant time
+    * @param other - queue to take frames from, empty on return
+    */
+   void Splice(FrameQueue& other);
+
+   /**
+    * Iterators to walk through the frames from head to tail
+    */
+   ConstIterator Begin() const;
+   ConstIterator End() const;
+
+private:
+   /// linked frames
+   Frames   m_frames;
+};
+
+/**
+ * FrameIndex class
+ * Frames ordered by frame number, linked through FrameBuffer::indexHook. Owns the frames
+ * the same way as FrameQueue does
+ */
+class FrameIndex : boost::noncopyable
+{
+   /**
+    * Key extractor, lets the index be searched by frame number
+    */
+   struct FrameNumberOf
+   {
+      typedef int type;
+      int operator()(const FrameBuffer& frame) const;
+   };
+
+   typedef boost::intrusive::member_hook<FrameBuffer,
+         boost::intrusive::set_member_hook<>, &FrameBuffer::indexHook> Hook;
+   typedef boost::intrusive::set<FrameBuffer, Hook,
+         boost::intrusive::key_of_value<FrameNumberOf> > Frames;
+
+public:
+   typedef Frames::iterator Iterator;
+
+   /**
+    * Destructor. Deletes frames left in the index
+    */
+   ~FrameIndex();
+
+   /**
+    * Accessor to check if index is empty
+    * @returns - true if there are no frames in the index
+    */
+   bool IsEmpty() const;
+
+   /**
+    * Accessor to get number of frames in the index, constant time
+    * @returns - number of frames
+    */
+   size_t GetSize() const;
+
+   /**
+    * Looks up the frame by number
+    * @param frameNumber - frame number
+    * @returns - pointer to the frame owned by the index, zero if there is no such frame
+    */
+   FrameBuffer* Find(int frameNumber);
+   const FrameBuffer* Find(int frameNumber) const;
+
+   /**
+    * Accessor to the frame with the lowest number
+    * @returns - pointer to the frame owned by the index, zero if index is empty
+    */
+   FrameBuffer* GetFirst();
+   const FrameBuffer* GetFirst() const;
+
+   /**
+    * Takes over the frame and links it into the index
+    * @param frame - frame to add, its number must not be in the index yet
+    */
+   void Insert(FrameBufferPtr frame);
+
+   /**
+    * Unlinks the frame and gives it away, constant time
+    * @param frame - frame owned by the index
+    * @returns - the same frame
+    */
+   FrameBufferPtr Take(FrameBuffer& frame);
+
+   /**
+    * Iterators to walk through the frames in order of their numbers
+    */
+   Iterator Begin();
+   Iterator End();
+
+   /**
+    * Finds the first frame with the number greater than given one
+    * @param frameNumber - frame number
+    * @returns - iterator to the frame, End() if there is no such frame
+    */
+   Iterator UpperBound(int frameNumber);
+
+private:
+   /// linked frames
+   Frames   m_frames;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_FRAME_QUEUE_H
@@ -0,0 +1,96 @@
+/**
+ *  @file
+ *  \brief     IngestPathImpl class implementation
+ *  \details   Holds implementation of the IIngestPath interface
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "ingest_path_impl.h"
+
+namespace video_coding
+{
+
+IngestPathImpl::IngestPathImpl(IJitterBuffer& jitterBuffer, DuplicateFilter& filter, IClock* clock)
+   : m_jitterBuffer(jitterBuffer)
+   , m_filter(filter)
+   , m_clock(clock)
+   , m_deliveredAtCreation(filter.GetDeliveredCount())
+   , m_receivedPackets(0)
+   , m_firstArrivals(0)
+   , m_duplicatePackets(0)
+   , m_lagSum(0)
+   , m_maxLag(0)
+{}
+
+result_t IngestPathImpl::TryReceivePacket(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame) throw()
+{
+   return TryReceivePacket(buffer, length, frameNumber, fragmentNumber,
+         numFragmentsInThisFrame, FrameInfo());
+}
+
+result_t IngestPathImpl::TryReceivePacket(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame,
+   const FrameInfo& info) throw()
+{
+   m_receivedPackets.fetch_add(1, boost::memory_order_relaxed);
+
+   // malformed packets are left to JB to reject and count
+   if (frameNumber < 0 || fragmentNumber < 0)
+      return m_jitterBuffer.TryReceivePacket(buffer, length, frameNumber, fragmentNumber,
+            numFragmentsInThisFrame, info);
+
+   TimeUs lag = 0;
+   DuplicateFilter::Verdict verdict =
+         m_filter.Admit(frameNumber, fragmentNumber, m_clock->GetTime(), lag);
+   if (verdict == DuplicateFilter::Duplicate)
+   {
+      m_duplicatePackets.fetch_add(1, boost::memory_order_relaxed);
+      m_lagSum.fetch_add((boost::uint64_t)lag, boost::memory_order_relaxed);
+      TimeUs maxLag = m_maxLag.load(boost::memory_order_relaxed);
+      while (lag > maxLag &&
+             !m_maxLag.compare_exchange_weak(maxLag, lag, boost::memory_order_relaxed));
+      return result_code::sOk;
+   }
+
+   result_t result = m_jitterBuffer.TryReceivePacket(buffer, length, frameNumber,
+         fragmentNumber, numFragmentsInThisFrame, info);
+   if (verdict == DuplicateFilter::FirstCopy)
+   {
+      // copy rejected by JB (e.g. it is full) must not shadow the redundant one
+      if (result != result_code::sOk)
+         m_filter.Revoke(frameNumber, fragmentNumber);
+      else
+         m_firstArrivals.fetch_add(1, boost::memory_order_relaxed);
+   }
+   return result;
+}
+
+IngestPathStatistics IngestPathImpl::GetStatistics() const
+{
+   IngestPathStatistics statistics;
+   statistics.receivedPackets = m_receivedPackets.load(boost::memory_order_relaxed);
+   statistics.firstArrivals = m_firstArrivals.load(boost::memory_order_relaxed);
+   statistics.duplicatePackets = m_duplicatePackets.load(boost::memory_order_relaxed);
+
+   boost::uint64_t delivered = m_filter.GetDeliveredCount() - m_deliveredAtCreation;
+   boost::uint64_t received = statistics.firstArrivals + statistics.duplicatePackets;
+   statistics.lostPackets = delivered > received ? delivered - received : 0;
+
+   if (statistics.duplicatePackets)
+      statistics.averageLag = (TimeUs)(m_lagSum.load(boost::memory_order_relaxed) /
+            statistics.duplicatePackets);
+   statistics.maxLag = m_maxLag.load(boost::memory_order_relaxed);
+   return statistics;
+}
+
+} // namespace video_coding
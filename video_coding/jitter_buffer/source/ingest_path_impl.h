@@ -0,0 +1,93 @@
+/**
+ *  @file
+ *  \brief     IngestPathImpl class declaration
+ *  \details   Holds declaration of the IIngestPath interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_INGEST_PATH_IMPL_H
+#define VIDEO_CODING_INGEST_PATH_IMPL_H
+
+#include <video_coding/interface/jitter_buffer.h>
+#include "duplicate_filter.h"
+// third-party
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * IngestPathImpl class
+ * Implements interface IIngestPath. Checks every fragment against the filter shared
+ * by all paths of the JB and forwards the first copy to JB
+ */
+class IngestPathImpl
+   : public IIngestPath
+   , boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor
+    * @param jitterBuffer - JB the fragments are forwarded to
+    * @param filter - filter shared by all paths of the JB
+    * @param clock - clock to measure lag with
+    */
+   IngestPathImpl(IJitterBuffer& jitterBuffer, DuplicateFilter& filter, IClock* clock);
+
+   /**
+    * IIngestPath interface method implementation. For more details see IIngestPath
+    * interface.
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame) throw();
+
+   /**
+    * IIngestPath interface method implementation. For more details see IIngestPath
+    * interface.
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info) throw();
+
+   /**
+    * IIngestPath interface method implementation. For more details see IIngestPath
+    * interface.
+    */
+   virtual IngestPathStatistics GetStatistics() const;
+
+private:
+   typedef boost::atomic<boost::uint64_t> Counter;
+
+   /// JB the fragments are forwarded to
+   IJitterBuffer&                         m_jitterBuffer;
+   /// filter shared by all paths of the JB
+   DuplicateFilter&                       m_filter;
+   /// clock to measure lag with
+   IClock*                                m_clock;
+   /// number of distinct fragments delivered by all paths at the path creation
+   const boost::uint64_t                  m_deliveredAtCreation;
+
+   /// see IngestPathStatistics
+   Counter                                m_receivedPackets;
+   Counter                                m_firstArrivals;
+   Counter                                m_duplicatePackets;
+   /// sum of lags of duplicate packets
+   Counter                                m_lagSum;
+   /// see IngestPathStatistics
+   boost::atomic<TimeUs>                  m_maxLag;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_INGEST_PATH_IMPL_H
@@ -8,15 +8,100 @@
  */
 
 #include <video_coding/interface/jitter_buffer.h>
-#include "jitter_buffer_impl.h"
+#include <video_coding/interface/jitter_buffer_template.h>
+#include <video_engine/interface/decoder.h>
+#include <video_engine/interface/renderer.h>
+#include "crc32c.h"
 
 namespace video_coding
 {
 
+FrameInfo::FrameInfo()
+   : type(ReferenceFrame)
+   , dependencyFrameNumber(-1)
+   , timestamp(-1)
+   , independent(false)
+{}
+
+ThreadPlacement::ThreadPlacement()
+   : realtimePriority(0)
+{}
+
+JitterBufferOptions::JitterBufferOptions()
+   : clock(0)
+   , sheddingQueueDepth(0)
+   , sheddingLag(0)
+   , decodeQueueCapacity(0)
+   , latencyTarget(0)
+   , backpressurePolicy(DropOldest)
+   , renderFrameRate(0)
+   , streamingDecode(false)
+   , decodeAhead(false)
+   , frameDeadline(0)
+   , decodeIncompleteFrames(false)
+   , waitStrategy(BlockingWait)
+   , spinTime(50)
+   , verifyFragmentChecksum(false)
+   , decryptor(0)
+   , pullMode(false)
+{}
+
+PulledFrame::PulledFrame()
+   : frameNumber(-1)
+   , type(ReferenceFrame)
+   , timestamp(-1)
+{}
+
+JitterBufferStatistics::JitterBufferStatistics()
+   : receivedFragments(0)
+   , duplicateFragments(0)
+   , lateFragments(0)
+   , invalidPackets(0)
+   , corruptFragments(0)
+   , overflowPackets(0)
+   , failedPackets(0)
+   , renderedFrames(0)
+   , pulledFrames(0)
+   , shedFrames(0)
+   , droppedFrames(0)
+   , skippedFrames(0)
+   , streamedFrames(0)
+   , decodedAheadFrames(0)
+   , expiredFrames(0)
+   , concealedFrames(0)
+   , decodeQueueDepth(0)
+   , decodeQueueLag(0)
+   , recyclerCpu(-1)
+   , decoderCpu(-1)
+   , renderCpu(-1)
+{}
+
+boost::uint32_t ComputeFragmentChecksum(const char* buffer, const int length)
+{
+   return ComputeCrc32c(buffer, length > 0 ? (size_t)length : 0);
+}
+
+IngestPathStatistics::IngestPathStatistics()
+   : receivedPackets(0)
+   , firstArrivals(0)
+   , duplicatePackets(0)
+   , lostPackets(0)
+   , averageLag(0)
+   , maxLag(0)
+{}
+
 boost::shared_ptr<IJitterBuffer> CreateJitterBuffer(IDecoder* decoder, IRenderer* renderer)
+{
+   return CreateJitterBuffer(decoder, renderer, JitterBufferOptions());
+}
+
+boost::shared_ptr<IJitterBuffer> CreateJitterBuffer(
+   IDecoder* decoder,
+   IRenderer* renderer,
+   const JitterBufferOptions& options)
 {
    boost::shared_ptr<IJitterBuffer> jitterBuffer;
-   jitterBuffer.reset( new JitterBufferImpl(decoder, renderer) );
+   jitterBuffer.reset( new JitterBuffer<IDecoder, IRenderer>(decoder, renderer, options) );
    return jitterBuffer;
 }
 
@@ -11,21 +11,71 @@
 
 #include <video_coding/interface/jitter_buffer.h>
 #include "frame_buffer.h"
+#include "frame_queue.h"
+#include "duplicate_filter.h"
+#include "worker_condition.h"
+#include "ingest_path_impl.h"
+#include "thread_placement.h"
+#include "readiness_event.h"
+#include <video_engine/interface/streaming_decoder.h>
+#include <video_engine/interface/concealing_decoder.h>
+#include <video_engine/interface/buffered_renderer.h>
+#include <common/result_code.h>
+#include <common/exception_dispatcher.h>
 // third-party
-#include <map>
+#include <algorithm>
 #include <list>
+#include <vector>
+#include <boost/atomic.hpp>
 #include <boost/thread.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/bind.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/scoped_array.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/type_traits/is_polymorphic.hpp>
 
 namespace video_coding
 {
 
+using video_engine::IStreamingDecoder;
+using video_engine::IConcealingDecoder;
+using video_engine::IBufferedRenderer;
+
+/**
+ * Helper function to query optional interface of the decoder or renderer
+ * (IStreamingDecoder, IConcealingDecoder, IBufferedRenderer). Overload for polymorphic
+ * types
+ * @param object - decoder or renderer instance
+ * @returns - the same object if the interface is implemented, zero otherwise
+ */
+template <class Interface, class Object>
+Interface* QueryOptionalInterface(Object* object, boost::true_type /*polymorphic*/)
+{
+   return dynamic_cast<Interface*>(object);
+}
+
+/**
+ * Helper function to query optional interface of the decoder or renderer. Overload
+ * for non-polymorphic types, which implement none of the optional interfaces
+ * @returns - zero
+ */
+template <class Interface, class Object>
+Interface* QueryOptionalInterface(Object* /*object*/, boost::false_type /*polymorphic*/)
+{
+   return 0;
+}
+
 /**
- * JitterBufferImpl class
- * Implements interface IJitterBuffer.
+ * JitterBufferImpl class template
+ * Implements interface IJitterBuffer. Decoder and renderer are called through their
+ * concrete types, so that the calls can be inlined, capacities are compile-time
+ * constants of the traits, worker threads and their conditions are created by the
+ * threading policy and frames are created and indexed by the storage policy. See
+ * JitterBuffer in video_coding/interface/jitter_buffer_template.h for requirements to
+ * the template arguments
  */
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
 class JitterBufferImpl
    : public IJitterBuffer
    , boost::noncopyable
@@ -34,9 +84,9 @@ public:
 
    /**
     * Constructor. For more details about behavior and input arguments take a look
-    * at the IJItterBuffer interface declaration
+    * at the IJItterBuffer interface declaration and JitterBufferOptions
     */
-   JitterBufferImpl(IDecoder* decoder, IRenderer* renderer);
+   JitterBufferImpl(Decoder* decoder, Renderer* renderer, const JitterBufferOptions& options);
 
    /**
     * Destructor. Performs component tear down procedure, stops running threads
@@ -44,8 +94,8 @@ public:
    virtual ~JitterBufferImpl();
 
    /**
-    * IJitterBuffer interface method implementation. Responsible for receiving and storing
-    * incoming packets in internal buffer. For more details see IJitterBuffer interface.
+    * IJitterBuffer interface method implementation. Throwing wrapper around
+    * TryReceivePacket. For more details see IJitterBuffer interface.
     */
    virtual void ReceivePacket(
       const char* buffer,
@@ -54,15 +104,351 @@ public:
       int fragmentNumber,
       int numFragmentsInThisFrame);
 
+   /**
+    * IJitterBuffer interface method implementation. Throwing wrapper around
+    * TryReceivePacket. For more details see IJitterBuffer interface.
+    */
+   virtual void ReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info);
+
+   /**
+    * IJitterBuffer interface method implementation. Responsible for receiving and storing
+    * incoming packets in internal buffer. For more details see IJitterBuffer interface.
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame) throw();
+
+   /**
+    * IJitterBuffer interface method implementation. Responsible for receiving and storing
+    * incoming packets in internal buffer. For more details see IJitterBuffer interface.
+    */
+   virtual result_t TryReceivePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info) throw();
+
+   /**
+    * IJitterBuffer interface method implementation. For more details see IJitterBuffer
+    * interface.
+    */
+   virtual JitterBufferStatistics GetStatistics() const;
+
+   /**
+    * IJitterBuffer interface method implementation. Creates duplicate filter shared
+    * by all paths along with the first path. For more details see IJitterBuffer
+    * interface.
+    */
+   virtual boost::shared_ptr<IIngestPath> CreateIngestPath();
+
+   /**
+    * IJitterBuffer interface method implementation. Blocks until every promotable frame
+    * is rendered. For more details see IJitterBuffer interface.
+    */
+   virtual void Flush();
+
+   /**
+    * IJitterBuffer interface method implementation. Same as Flush but limited in time.
+    * For more details see IJitterBuffer interface.
+    */
+   virtual result_t Drain(TimeUs timeout);
+
+   /**
+    * IJitterBuffer interface method implementation. For more details see IJitterBuffer
+    * interface.
+    */
+   virtual int GetReadinessDescriptor() const;
+
+   /**
+    * IJitterBuffer interface method implementation. For more details see IJitterBuffer
+    * interface.
+    */
+   virtual TimeUs GetNextDeadline() throw();
+
+   /**
+    * IJitterBuffer interface method implementation. Does the work of decoder thread
+    * for one frame. For more details see IJitterBuffer interface.
+    */
+   virtual result_t DecodeNext() throw();
+
+   /**
+    * IJitterBuffer interface method implementation. For more details see IJitterBuffer
+    * interface.
+    */
+   virtual result_t TryGetNextFrame(PulledFrame& frame) throw();
+
 private:
    typedef boost::lock_guard<boost::mutex> LOCK;
-   typedef std::map<int, FrameBufferPtr> FrameBuffers;
-   typedef std::list<FrameBufferPtr> FrameList;
+   typedef boost::atomic<boost::uint64_t> Counter;
+   typedef typename Threading::Thread Thread;
+   typedef typename Threading::Condition Condition;
+   typedef typename Storage::Index Index;
+
+   /**
+    * Decoded frame waiting for render pacing
+    */
+   struct DecodedFrame
+   {
+      /// decoder output
+      std::vector<char> data;
+      /// presentation time, negative if unknown
+      TimeUs            timestamp;
+   };
+   typedef std::list<DecodedFrame> DecodedFrames;
+
+   /**
+    * Output of the frame decoded ahead of its turn, see DecodeAheadFrame
+    */
+   struct ReorderSlot
+   {
+      /**
+       * Constructor. Creates free slot
+       */
+      ReorderSlot() : frameNumber(-1) {}
+
+      /// frame number, -1 if the slot is free
+      int               frameNumber;
+      /// decoder output, keeps its capacity while the slot is free
+      std::vector<char> data;
+   };
+   typedef std::vector<ReorderSlot> ReorderBuffer;
+
+   /**
+    * Counters behind JitterBufferStatistics. Updated by relaxed atomic increments,
+    * so ingest and worker threads never contend on them
+    */
+   struct Counters
+   {
+      Counters();
+
+      Counter  receivedFragments;
+      Counter  duplicateFragments;
+      Counter  lateFragments;
+      Counter  invalidPackets;
+      Counter  corruptFragments;
+      Counter  overflowPackets;
+      Counter  failedPackets;
+      Counter  renderedFrames;
+      Counter  pulledFrames;
+      Counter  shedFrames;
+      Counter  droppedFrames;
+      Counter  skippedFrames;
+      Counter  streamedFrames;
+      Counter  decodedAheadFrames;
+      Counter  expiredFrames;
+      Counter  concealedFrames;
+      Counter  decodeQueueDepth;
+      boost::atomic<int>   recyclerCpu;
+      boost::atomic<int>   decoderCpu;
+      boost::atomic<int>   renderCpu;
+   };
+
+   /**
+    * Helper function to increment one of the counters
+    * @param counter - counter to increment
+    */
+   static void Increment(Counter& counter);
+
+   /**
+    * Helper function to apply placement settings to the calling worker thread. Failure
+    * is logged and ignored
+    * @param placement - settings to apply
+    */
+   static void PlaceWorkerThread(const ThreadPlacement& placement) throw();
 
    /**
-    * Recycler thread main routine. Thread is running in a loop in this function
-    * unless shutdown is requested. Upon the shutdown unprocessed fragments will be
-    * purged without processing.
+    * Waits until there are no frames ready for decoding and all frames already passed
+    * to decoder are rendered
+    *
+    * @param useDeadline - if false deadline is ignored and method waits infinitely
+    * @param deadline - absolute time (in terms of JB clock) to wait until
+    * @returns - sOk if drained, eNotReady if deadline is reached, eFail if frame
+    *            processing is blocked
+    */
+   result_t WaitForDrain(bool useDeadline, TimeUs deadline);
+
+   /**
+    * Checks if the next frame in a sequence is completed and can be passed to decoder.
+    * Must be called with m_unsortedFrameBuffersGuard locked
+    * @returns - true if next frame is ready for decoding
+    */
+   bool IsNextFramePromotable() const;
+
+   /**
+    * Calculates the moment the next frame in sequence stops being waited for, see
+    * JitterBufferOptions::frameDeadline. Must be called with m_unsortedFrameBuffersGuard
+    * locked
+    * @returns - deadline in terms of JB clock, negative if there is no deadline
+    */
+   TimeUs GetNextFrameDeadline() const;
+
+   /**
+    * Gives up the next frame in sequence once its deadline expired: missing frames are
+    * skipped, incomplete frame is either passed to concealing decoder or dropped.
+    * Must be called with m_unsortedFrameBuffersGuard locked
+    * @param promotedFrames - in/out parameter, incomplete frame is added to it if it
+    *                         is going to be decoded
+    */
+   void ExpireNextFrame(FrameQueue& promotedFrames);
+
+   /**
+    * Moves the sequence of completed frames following the last decoded one to the given
+    * queue. Must be called with m_unsortedFrameBuffersGuard locked
+    * @param promotedFrames - in/out parameter, frames are added to it
+    */
+   void PromoteCompletedFrames(FrameQueue& promotedFrames);
+
+   /**
+    * Appends promoted frames to decode queue. Must be called with
+    * m_sortedFrameBuffersGuard locked
+    * @param promotedFrames - frames to append, emptied by the call
+    */
+   void QueuePromotedFrames(FrameQueue& promotedFrames);
+
+   /**
+    * Raises m_frameProcessingIsBlocked flag and wakes up Drain/Flush callers
+    */
+   void BlockFrameProcessing();
+
+   /**
+    * Signals readiness descriptor in pull mode unless it is already signaled, does
+    * nothing in push mode. Must be called with m_unsortedFrameBuffersGuard locked
+    */
+   void SignalReadiness();
+
+   /**
+    * Launches recycler, decoder and render threads with the first accepted fragment
+    * (delayed initialization), does nothing in pull mode. Must be called with
+    * m_unsortedFrameBuffersGuard locked, so ingest paths racing with the first
+    * fragments launch them once
+    */
+   void LaunchWorkerThreads();
+
+   /**
+    * Takes the next frame to be processed in pull mode, doing the work of recycler and
+    * decoder threads: frames are promoted or given up at deadline, decode queue is
+    * trimmed and frames are shed. Resets readiness descriptor if there is no frame
+    * @returns - the frame, empty if there is none
+    */
+   FrameBufferPtr TakeNextFrame();
+
+   /**
+    * Decodes and renders every frame that can be taken in pull mode, on the calling
+    * thread. Pull mode counterpart of WaitForDrain
+    *
+    * @param useDeadline - if false deadline is ignored
+    * @param deadline - absolute time (in terms of JB clock) to stop at
+    * @returns - sOk if there are no more frames, eNotReady if deadline is reached,
+    *            eFail if frame processing is blocked
+    */
+   result_t DecodePulledFrames(bool useDeadline, TimeUs deadline);
+
+   /**
+    * Reassembles complete frame and passes it to decoder
+    * @param frameBuffer - the frame, released once reassembled
+    * @param frameData - assembly buffer, passed by caller to keep the allocation
+    *                    between calls
+    * @param outputBuffer - buffer for decoder output
+    * @returns - size of decoder output
+    */
+   int DecodeCompleteFrame(FrameBufferPtr& frameBuffer, std::vector<char>& frameData,
+      char* outputBuffer);
+
+   /**
+    * Decides whether the frame at the head of decode queue must be dropped instead of
+    * decoding. Frames are shed when decoder is overloaded (see JitterBufferOptions):
+    *  - non-reference frames are dropped first;
+    *  - reference frames are dropped only if there is a key frame further in the queue,
+    *    then the whole chain up to that key frame is dropped.
+    * Frames which depend on a dropped reference frame are always dropped.
+    * Must be called by decoder thread with m_sortedFrameBuffersGuard locked
+    *
+    * @param frameBuffer - frame at the head of decode queue
+    * @returns - true if frame must be dropped
+    */
+   bool ShouldShedFrame(const FrameBuffer& frameBuffer);
+
+   /**
+    * Remembers the reference frame is dropped, so that frames depending on it are
+    * dropped too. Must be called with m_sortedFrameBuffersGuard locked
+    * @param frameNumber - number of the dropped frame
+    */
+   void AddShedReference(int frameNumber);
+
+   /**
+    * Checks if the reference frame is dropped since the last key frame. Must be called
+    * with m_sortedFrameBuffersGuard locked
+    * @param frameNumber - reference frame number
+    * @returns - true if the frame is dropped
+    */
+   bool IsShedReference(int frameNumber) const;
+
+   /**
+    * Checks if decoder falls behind: either decode queue is too deep or the frame
+    * has been waiting for too long. Must be called with m_sortedFrameBuffersGuard locked
+    *
+    * @param frameBuffer - frame at the head of decode queue
+    * @returns - true if shedding thresholds are exceeded
+    */
+   bool IsDecoderOverloaded(const FrameBuffer& frameBuffer) const;
+
+   /**
+    * Checks if decode queue exceeds its capacity or latency target (see JitterBufferOptions).
+    * Lock-free, based on decode queue gauges
+    * @returns - true if either of the limits is exceeded
+    */
+   bool IsDecodeQueueOverLimit() const;
+
+   /**
+    * Accessor to get time the head frame of decode queue has been waiting for decoder.
+    * Lock-free, based on decode queue gauges
+    * @returns - decode queue lag (microseconds), zero if queue is empty
+    */
+   TimeUs GetDecodeQueueLag() const;
+
+   /**
+    * Drops frames from the head of decode queue according to backpressure policy until
+    * the queue is back within limits. Must be called with m_sortedFrameBuffersGuard locked
+    * @returns - number of frames dropped, caller must pass it to FinishFrameProcessing
+    *            once the lock is released
+    */
+   int TrimDecodeQueue();
+
+   /**
+    * Removes head frame from decode queue. Must be called with m_sortedFrameBuffersGuard
+    * locked and the queue not empty
+    * @returns - frame removed
+    */
+   FrameBufferPtr PopFrontFrame();
+
+   /**
+    * Refreshes decode queue depth and head completion time after the queue is changed.
+    * Must be called with m_sortedFrameBuffersGuard locked
+    */
+   void UpdateDecodeQueueGauges();
+
+   /**
+    * Lets Drain/Flush know that frames passed to decoder are completely processed
+    * (rendered or dropped)
+    * @param frameCount - number of frames processed
+    */
+   void FinishFrameProcessing(int frameCount);
+
+   /**
+    * Recycler thread main routine. Thread sleeps until the next frame in a sequence
+    * is completed. Upon the shutdown completed frames which follow the sequence
+    * are passed to decoder, other unprocessed fragments are purged without processing.
     * The main aim of this function is to traverse through the list of frames and
     * identify if any frame is ready for decoding. Ready-to-decode frames must satisfy
     * two requirements:
@@ -73,8 +459,7 @@ private:
 
    /**
     * Decoder thread main routine. Thread is running in a loop in this function
-    * unless shutdown is requested. Upon the shutdown unprocessed fragments will be
-    * purged without processing.
+    * until recycler thread is finished and all frames passed by it are processed.
     * According to Decoder contract, frames can be processed only when there are no
     * gaps. If known exception occurs during frame processing (decoding or rendering)
     * then component triggers a error and stops receiving new packets to notify the caller
@@ -82,17 +467,86 @@ private:
     */
    void ProcessCompletedFrames();
 
-   /// raw pointer to the instance which implements IDecoder interface
-   IDecoder*                              m_decoder;
-   /// raw pointer to the instance which implements IRenderer interface
-   IRenderer*                             m_renderer;
+   /**
+    * Passes newly arrived contiguous data of the next frame to streaming decoder.
+    * Called by decoder thread while decode queue is empty
+    * @param partData - buffer to be used for the data, passed by caller to keep
+    *                   the allocation between calls
+    */
+   void StreamNextFrame(std::vector<char>& partData);
+
+   /**
+    * Decodes the first complete independent frame which is waiting behind an incomplete
+    * one and stores decoder output in reorder buffer until the frame's turn comes.
+    * Called by decoder thread while decode queue is empty. Skipped while streaming
+    * decoder is in the middle of a frame
+    * @param frameData - assembly buffer, grows to the frame size
+    * @param decodedData - buffer for decoder output
+    * @returns - true if a frame has been decoded
+    */
+   bool DecodeAheadFrame(std::vector<char>& frameData, char* decodedData);
+
+   /**
+    * Looks up output of the frame decoded ahead. Called by decoder thread only
+    * @param frameNumber - frame number, -1 to look up a free slot
+    * @returns - reorder buffer slot, zero if there is none
+    */
+   ReorderSlot* FindDecodedAhead(int frameNumber);
+
+   /**
+    * Lets streaming decoder know that partially passed frame is dropped, if any
+    */
+   void AbortStreamedFrame();
+
+   /**
+    * Fills m_freeRenderFrames pool. Buffers are written once, so their pages are
+    * faulted in by the calling thread and come from the memory node of its CPU. Used by
+    * decoder thread after its placement is applied, if render pacing is enabled
+    */
+   void AllocateRenderFrames();
+
+   /**
+    * Passes decoded frame to render thread. Blocks while render queue is full, which
+    * keeps render pacing from adding more than one frame of latency. Frame is copied
+    * into a node of m_freeRenderFrames pool, so nothing is allocated. Used by decoder
+    * thread if render pacing is enabled
+    *
+    * @param decodedData - decoder output
+    * @param decodedBufferSize - size of decoder output
+    * @param timestamp - presentation time of the frame, negative if unknown
+    */
+   void ScheduleRender(const char* decodedData, int decodedBufferSize, TimeUs timestamp);
+
+   /**
+    * Render thread main routine, used if render pacing is enabled. Frames are rendered
+    * on the schedule anchored to JB clock: due time of every next frame is the due time
+    * of the previous one plus frame interval, so render delays do not accumulate. Frame
+    * which is late by more than one interval is skipped if a newer frame is available,
+    * otherwise it is rendered at once and the schedule is re-anchored. Once decoder
+    * thread is finished the remaining frames are rendered without pacing
+    */
+   void RenderScheduledFrames();
+
+   /// raw pointer to the decoder, see IDecoder interface
+   Decoder*                               m_decoder;
+   /// the same decoder if streaming decode is enabled, zero otherwise
+   IStreamingDecoder*                     m_streamingDecoder;
+   /// the same decoder if decoding of incomplete frames is enabled, zero otherwise
+   IConcealingDecoder*                    m_concealingDecoder;
+   /// raw pointer to the renderer, see IRenderer interface
+   Renderer*                              m_renderer;
+   /// the same renderer if it provides buffers for decoder output, zero otherwise
+   IBufferedRenderer*                     m_bufferedRenderer;
+   /// raw pointer to the clock used for every wait and timestamp inside JB
+   IClock*                                m_clock;
+   /// component settings
+   const JitterBufferOptions              m_options;
 
    /// mutex to grant exclusive access to the buffer with unsorted frames
    boost::mutex                           m_unsortedFrameBuffersGuard;
-   /// container which holds pair [frameNumber, FrameBuffer]. Stores buffers with
-   /// all fragments of incoming frames (except for empty one and retransmitted),
-   /// in the order of arrival
-   FrameBuffers                           m_unsortedFrameBuffers;
+   /// container which holds frames by frame number. Stores buffers with
+   /// all fragments of incoming frames (except for empty one and retransmitted)
+   Index                                  m_unsortedFrameBuffers;
 
    /// mutex to grant exclusive access to the buffer with sorted frames
    /// that are ready for decoding
@@ -100,39 +554,1411 @@ private:
    /// container which holds only completed frames - frames which have all
    /// fragments received. Frames are placed in this container in the
    /// proper order (sorted, ready for decoding)
-   FrameList                              m_sortedFrameBuffers;
+   FrameQueue                             m_sortedFrameBuffers;
+   /// number of key frames in sorted buffer. Protected by m_sortedFrameBuffersGuard
+   int                                    m_queuedKeyFrames;
+   /// numbers of reference frames dropped since the last key frame, kept without
+   /// allocation in a ring indexed by frame number, -1 in unused slots. A slot is reused
+   /// by the reference dropped Traits::MaxFrameNumber frames later. Protected by
+   /// m_sortedFrameBuffersGuard
+   int                                    m_shedReferences[Traits::MaxFrameNumber];
+   /// completion time of the head frame in sorted buffer, written under
+   /// m_sortedFrameBuffersGuard and read without locking to estimate decode queue lag
+   boost::atomic<TimeUs>                  m_headCompletionTime;
    /// Indicates last decoded frame number
    int                                    m_lastDecodedFrameNumber;
+   /// number of frames passed to sorted buffer but not yet rendered. Protected
+   /// by m_unsortedFrameBuffersGuard
+   int                                    m_framesInFlight;
+   /// Condition variable to notify Drain/Flush callers that frame processing
+   /// has progressed
+   boost::condition_variable              m_drainCondition;
+   /// Indicates recycler thread is stopped and no more frames will be added
+   /// to sorted buffer. Protected by m_sortedFrameBuffersGuard
+   bool                                   m_recyclerFinished;
 
    /// Condition variable to notify recycle task about new incoming fragments
-   boost::condition_variable              m_recycleCondition;
-   /// Indicates if recycle task has already been launched
-   bool                                   m_recycleTaskLaunched;
+   Condition                              m_recycleCondition;
+   /// Indicates if worker threads have already been launched. Protected by
+   /// m_unsortedFrameBuffersGuard
+   bool                                   m_workerThreadsLaunched;
    /// Condition variable to notify decoder task that new frame is ready
    /// for decoding
-   boost::condition_variable              m_decoderCondition;
-   /// Indicates if decoding task has already been launched
-   bool                                   m_dataProcessingTaskLaunched;
+   Condition                              m_decoderCondition;
+   /// Indicates there is work for idle decoder thread: new fragments of the next frame
+   /// arrived (streaming decode mode) or a frame can be decoded ahead (decode-ahead mode)
+   boost::atomic<bool>                    m_idleWorkReady;
+   /// number of the frame partially passed to streaming decoder, -1 if none.
+   /// Accessed by decoder thread only
+   int                                    m_streamedFrameNumber;
+   /// number of bytes of that frame already passed to streaming decoder
+   int                                    m_streamedBytes;
+   /// output of frames decoded ahead of their turn, Traits::MaxDecodedAheadFrames slots
+   /// allocated once in decode-ahead mode. Accessed by decoder thread only
+   ReorderBuffer                          m_reorderBuffer;
+   /// frame decode-ahead is assembling outside of m_unsortedFrameBuffersGuard, zero if
+   /// none. Set under that lock while the frame is still in the index, cleared under
+   /// m_sortedFrameBuffersGuard
+   boost::atomic<FrameBuffer*>            m_decodeAheadFrame;
+   /// that frame once dropped from decode queue meanwhile, released by decoder thread
+   /// when assembly is done. Protected by m_sortedFrameBuffersGuard
+   FrameBufferPtr                         m_droppedDecodeAheadFrame;
 
    /// Recycle thread will be used to traverse through the list of
    /// available unsorted frames and move them to sorted buffer.
    /// Will be launched with the first incoming data fragment
    /// (delayed initialization)
-   boost::scoped_ptr<boost::thread>       m_recyclerThread;
+   boost::scoped_ptr<Thread>              m_recyclerThread;
 
    /// Decoder thread will be used to traverse through the list of
    /// sorted frames, adjust fragments and pass this frame to decoder
    /// and then to the renderer. Will be launched with the first incoming
    /// data fragment (delayed initialization)
-   boost::scoped_ptr<boost::thread>       m_dataProcessingThread;
+   boost::scoped_ptr<Thread>              m_dataProcessingThread;
+
+   /// mutex to grant exclusive access to the render queue
+   boost::mutex                           m_renderGuard;
+   /// decoded frames waiting for render thread
+   DecodedFrames                          m_renderQueue;
+   /// pool of render queue nodes with buffers sized for the largest decoded frame,
+   /// nodes are spliced to m_renderQueue and back. Filled by decoder thread on start.
+   /// Protected by m_renderGuard
+   DecodedFrames                          m_freeRenderFrames;
+   /// Condition variable to notify render thread about new decoded frames
+   Condition                              m_renderCondition;
+   /// Condition variable to notify decoder thread that render queue has space
+   Condition                              m_renderSlotCondition;
+   /// Indicates decoder thread is stopped and no more frames will be added to
+   /// render queue. Protected by m_renderGuard
+   bool                                   m_decoderFinished;
+   /// Indicates render thread is stopped by an error. Protected by m_renderGuard
+   bool                                   m_rendererStopped;
+   /// Render thread, launched together with decoder thread if render pacing is enabled
+   boost::scoped_ptr<Thread>              m_renderThread;
 
    /// Flag that component shutdown has been requested
    bool                                   m_shutdownRequested;
 
-   /// flag indicates some critical error at video processing stage
-   bool                                   m_frameProcessingIsBlocked;
+   /// flag indicates some critical error at video processing stage. Atomic as it
+   /// is checked by ingest path without locking
+   boost::atomic<bool>                    m_frameProcessingIsBlocked;
+
+   /// component counters, see GetStatistics
+   Counters                               m_counters;
+
+   /// mutex to serialize creation of ingest paths
+   boost::mutex                           m_ingestPathsGuard;
+   /// record of fragments delivered by redundant ingest paths, created with the first
+   /// path. Protected by m_ingestPathsGuard
+   boost::scoped_ptr<DuplicateFilter>     m_duplicateFilter;
+
+   /// readiness descriptor of pull mode, zero in push mode
+   boost::scoped_ptr<ReadinessEvent>      m_readinessEvent;
+   /// Indicates readiness descriptor is signaled. Protected by m_unsortedFrameBuffersGuard
+   bool                                   m_readinessSignaled;
+   /// decoder output buffer of pull mode, allocated by the first DecodeNext
+   boost::scoped_array<char>              m_pulledDecodedData;
+   /// assembly buffer of pull mode
+   std::vector<char>                      m_pulledFrameData;
 };
 
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::JitterBufferImpl(
+   Decoder* decoder,
+   Renderer* renderer,
+   const JitterBufferOptions& options)
+   : IJitterBuffer(0, 0)
+   , m_clock(options.clock ? options.clock : GetSystemClock())
+   , m_options(options)
+   , m_queuedKeyFrames(0)
+   , m_headCompletionTime(0)
+   , m_lastDecodedFrameNumber(-1)
+   , m_framesInFlight(0)
+   , m_recyclerFinished(false)
+   , m_recycleCondition(options.waitStrategy, options.spinTime)
+   , m_workerThreadsLaunched(false)
+   , m_decoderCondition(options.waitStrategy, options.spinTime)
+   , m_idleWorkReady(false)
+   , m_streamedFrameNumber(-1)
+   , m_streamedBytes(0)
+   , m_decodeAheadFrame(0)
+   , m_renderCondition(options.waitStrategy, options.spinTime)
+   , m_renderSlotCondition(options.waitStrategy, options.spinTime)
+   , m_decoderFinished(false)
+   , m_rendererStopped(false)
+   , m_shutdownRequested(false)
+   , m_frameProcessingIsBlocked(false)
+   , m_readinessSignaled(false)
+{
+   CHECK_ARGUMENT(decoder != 0, "Decoder is zero!");
+   CHECK_ARGUMENT(renderer != 0, "Renderer is zero!");
+   std::fill(m_shedReferences, m_shedReferences + Traits::MaxFrameNumber, -1);
+   m_decoder = decoder;
+   m_streamingDecoder = 0;
+   if (options.streamingDecode)
+   {
+      m_streamingDecoder = QueryOptionalInterface<IStreamingDecoder>(decoder,
+            boost::is_polymorphic<Decoder>());
+      CHECK_ARGUMENT(m_streamingDecoder != 0, "Decoder does not support streaming!");
+   }
+   m_concealingDecoder = 0;
+   if (options.decodeIncompleteFrames)
+   {
+      m_concealingDecoder = QueryOptionalInterface<IConcealingDecoder>(decoder,
+            boost::is_polymorphic<Decoder>());
+      CHECK_ARGUMENT(m_concealingDecoder != 0, "Decoder does not support concealment!");
+   }
+   m_renderer = renderer;
+   m_bufferedRenderer = QueryOptionalInterface<IBufferedRenderer>(renderer,
+         boost::is_polymorphic<Renderer>());
+   CHECK_ARGUMENT(!options.decryptor || !options.verifyFragmentChecksum,
+         "Fragment checksum is not used with decryption!");
+   if (options.pullMode)
+   {
+      CHECK_ARGUMENT(!options.streamingDecode && !options.decodeAhead &&
+            !options.decodeIncompleteFrames && options.renderFrameRate <= 0,
+            "Pull mode does not support options which need worker threads!");
+      m_readinessEvent.reset( new ReadinessEvent() );
+   }
+   if (options.decodeAhead)
+      m_reorderBuffer.resize(Traits::MaxDecodedAheadFrames);
+   ValidateThreadPlacement(options.recyclerPlacement);
+   ValidateThreadPlacement(options.decoderPlacement);
+   ValidateThreadPlacement(options.renderPlacement);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::~JitterBufferImpl()
+{
+   // nobody else decodes in pull mode, the owner is the one destroying JB
+   if (m_options.pullMode)
+      DecodePulledFrames(false, 0);
+
+   {
+      // recycler promotes whatever is left in a sequence and then lets decoder
+      // finish the remaining frames, so no completed frame is lost
+      LOCK lock(m_unsortedFrameBuffersGuard);
+      m_shutdownRequested = true;
+      m_recycleCondition.NotifyOne();
+   }
+
+   if (m_recyclerThread.get())
+      m_recyclerThread->join();
+
+   if (m_dataProcessingThread.get())
+      m_dataProcessingThread->join();
+
+   if (m_renderThread.get())
+      m_renderThread->join();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::Flush()
+{
+   if (WaitForDrain(false, 0) != result_code::sOk)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Frame processing is blocked!";
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+result_t JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::Drain(const TimeUs timeout)
+{
+   return WaitForDrain(true, m_clock->GetTime() + timeout);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+int JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::GetReadinessDescriptor() const
+{
+   return m_readinessEvent ? m_readinessEvent->GetDescriptor() : -1;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+TimeUs JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::GetNextDeadline() throw()
+{
+   LOCK lock(m_unsortedFrameBuffersGuard);
+   return GetNextFrameDeadline();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+result_t JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::DecodeNext() throw()
+{
+   if (!m_options.pullMode)
+      return result_code::eUnexpected;
+   if (m_frameProcessingIsBlocked)
+      return result_code::eFail;
+
+   try
+   {
+      FrameBufferPtr frameBuffer = TakeNextFrame();
+      if (!frameBuffer)
+         return result_code::eNotReady;
+
+      // since Decoder response size is fixed we can allocate buffer once
+      if (!m_pulledDecodedData)
+         m_pulledDecodedData.reset( new char[Traits::MaxDecodedBufferSize] );
+      char* outputBuffer = m_pulledDecodedData.get();
+      if (m_bufferedRenderer)
+      {
+         char* renderBuffer = m_bufferedRenderer->GetFrameBuffer(Traits::MaxDecodedBufferSize);
+         if (renderBuffer)
+            outputBuffer = renderBuffer;
+      }
+
+      int decodedBufferSize = DecodeCompleteFrame(frameBuffer, m_pulledFrameData, outputBuffer);
+      m_renderer->RenderFrame(outputBuffer, decodedBufferSize);
+      Increment(m_counters.renderedFrames);
+      FinishFrameProcessing(1);
+   }
+   catch (const std::exception&)
+   {
+      // the same as decoder thread failure in push mode
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+      BlockFrameProcessing();
+      return result_code::eFail;
+   }
+   return result_code::sOk;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+result_t JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::TryGetNextFrame(PulledFrame& frame) throw()
+{
+   if (!m_options.pullMode)
+      return result_code::eUnexpected;
+   if (m_frameProcessingIsBlocked)
+      return result_code::eFail;
+
+   try
+   {
+      FrameBufferPtr frameBuffer = TakeNextFrame();
+      if (!frameBuffer)
+         return result_code::eNotReady;
+
+      frame.frameNumber = frameBuffer->GetFrameNumber();
+      frame.type = frameBuffer->GetFrameType();
+      frame.timestamp = frameBuffer->GetTimestamp();
+      frame.data.resize(frameBuffer->GetCurrentFrameSize());
+      frameBuffer->GetAssembledData(&frame.data[0]);
+      frameBuffer.reset();
+
+      Increment(m_counters.pulledFrames);
+      FinishFrameProcessing(1);
+   }
+   catch (const std::exception&)
+   {
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+      BlockFrameProcessing();
+      return result_code::eFail;
+   }
+   return result_code::sOk;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::ReceivePacket(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame)
+{
+   ReceivePacket(buffer, length, frameNumber, fragmentNumber, numFragmentsInThisFrame,
+         FrameInfo());
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::ReceivePacket(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame,
+   const FrameInfo& info)
+{
+   result_t result = TryReceivePacket(buffer, length, frameNumber, fragmentNumber,
+         numFragmentsInThisFrame, info);
+   if (result == result_code::sOk)
+      return;
+
+   try
+   {
+      switch (result)
+      {
+         case result_code::eInvalidArgument:
+            THROW_INVALID_ARGUMENT << "Invalid packet: buffer " << (const void*)buffer
+               << ", length " << length << ", frame #" << frameNumber << ", fragment #"
+               << fragmentNumber << " of " << numFragmentsInThisFrame << ", dependency #"
+               << info.dependencyFrameNumber;
+         case result_code::eOutOfSpace:
+            THROW_BASIC_EXCEPTION(result) << "Jitter Buffer is full";
+         default:
+            THROW_BASIC_EXCEPTION(result) << "Frame processing is blocked!";
+      }
+   }
+   catch(const std::exception&)
+   {
+      // Let dispatcher trace exception source: can be helpful in revising call stack in case
+      // of exceptions from underlying components
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+      throw;
+   }
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+result_t JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::TryReceivePacket(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame) throw()
+{
+   return TryReceivePacket(buffer, length, frameNumber, fragmentNumber,
+         numFragmentsInThisFrame, FrameInfo());
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+result_t JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::TryReceivePacket(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame,
+   const FrameInfo& info) throw()
+{
+   if (buffer == 0 || length <= 0 || frameNumber < 0 || fragmentNumber < 0 ||
+       fragmentNumber >= numFragmentsInThisFrame ||
+       numFragmentsInThisFrame > Traits::MaxFragmentsPerFrame ||
+       (info.type != KeyFrame && info.dependencyFrameNumber >= frameNumber) ||
+       (m_options.verifyFragmentChecksum && length <= FragmentChecksumSize) ||
+       (m_options.decryptor && length <= m_options.decryptor->GetOverhead()))
+   {
+      Increment(m_counters.invalidPackets);
+      return result_code::eInvalidArgument;
+   }
+
+   // let the caller know that JB is broken (either of worker threads encountered
+   // critical error and therefore component is unable to function properly further)
+   if (m_frameProcessingIsBlocked)
+   {
+      Increment(m_counters.failedPackets);
+      return result_code::eFail;
+   }
+
+   try
+   {
+      bool idleWorkReady = false;
+
+      // start new section here to limit the scope where locker is used
+      {  // Prefer this local scope as new function would require list of input params
+         // compared to what we have in 'ReceivePacket' method
+         LOCK lock(m_unsortedFrameBuffersGuard);
+         if (frameNumber <= m_lastDecodedFrameNumber)
+         {
+            Increment(m_counters.lateFragments);
+            return result_code::sOk;
+         }
+
+         FrameBuffer* frameBuffer = m_unsortedFrameBuffers.Find(frameNumber);
+         if (!frameBuffer)
+         {
+            if (m_unsortedFrameBuffers.GetSize() == (size_t)Traits::MaxFrameNumber ||
+                (m_options.backpressurePolicy == SignalProducer && IsDecodeQueueOverLimit()))
+            {
+               Increment(m_counters.overflowPackets);
+               return result_code::eOutOfSpace;
+            }
+
+            LOGDBG << "New frame #" << frameNumber << " arrived (fragment #"
+                   << fragmentNumber << " of " << numFragmentsInThisFrame << ")";
+
+            FrameBufferPtr newFrameBuffer = Storage::CreateFrame(
+                  buffer,
+                  length,
+                  frameNumber,
+                  fragmentNumber,
+                  numFragmentsInThisFrame,
+                  info,
+                  m_options.verifyFragmentChecksum,
+                  m_options.decryptor);
+            if (!newFrameBuffer->GetCurrentFrameSize())
+            {
+               Increment(m_counters.corruptFragments);
+               return result_code::eInvalidArgument;
+            }
+
+            newFrameBuffer->SetArrivalTime(m_clock->GetTime());
+            frameBuffer = newFrameBuffer.get();
+            m_unsortedFrameBuffers.Insert(boost::move(newFrameBuffer));
+         }
+         else
+         {
+            // fragment of some old frame
+            LOGDBG << "Frame #" << frameNumber << " got new fragment #" << fragmentNumber;
+            switch (frameBuffer->AppendFragment(buffer, length, fragmentNumber))
+            {
+               case FrameBuffer::FragmentDuplicated:
+                  Increment(m_counters.duplicateFragments);
+                  return result_code::sOk;
+               case FrameBuffer::FragmentCorrupted:
+                  Increment(m_counters.corruptFragments);
+                  return result_code::eInvalidArgument;
+               default:
+                  break;
+            }
+         }
+
+         Increment(m_counters.receivedFragments);
+         // completion time is the origin of the playout lag, see IsDecoderOverloaded
+         if (frameBuffer->IsFrameComplete())
+         {
+            frameBuffer->SetCompletionTime(m_clock->GetTime());
+            if (frameNumber == m_lastDecodedFrameNumber + 1)
+               SignalReadiness();
+         }
+
+         bool idleWork = (m_streamingDecoder && frameNumber == m_lastDecodedFrameNumber + 1) ||
+               (m_options.decodeAhead && frameBuffer->IsFrameComplete() &&
+                frameBuffer->IsIndependent() && frameNumber > m_lastDecodedFrameNumber + 1);
+         if (idleWork)
+            idleWorkReady = !m_idleWorkReady.exchange(true);
+
+         LaunchWorkerThreads();
+      }
+
+      // wake up decoder thread if it is idle, see StreamNextFrame and DecodeAheadFrame
+      if (idleWorkReady)
+      {
+         LOCK lock(m_sortedFrameBuffersGuard);
+         m_decoderCondition.NotifyOne();
+      }
+   }
+   catch(const std::exception&)
+   {
+      // allocation or thread creation failure, report it the same way as
+      // any other rejection
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+      Increment(m_counters.failedPackets);
+      return result_code::eFail;
+   }
+
+   // notify recycler thread every time the new fragment arrives - this will help
+   // keeping frame buffer free from old completed frames
+   m_recycleCondition.NotifyOne();
+   return result_code::sOk;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+JitterBufferStatistics JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::GetStatistics() const
+{
+   JitterBufferStatistics statistics;
+   statistics.receivedFragments = m_counters.receivedFragments.load(boost::memory_order_relaxed);
+   statistics.duplicateFragments = m_counters.duplicateFragments.load(boost::memory_order_relaxed);
+   statistics.lateFragments = m_counters.lateFragments.load(boost::memory_order_relaxed);
+   statistics.invalidPackets = m_counters.invalidPackets.load(boost::memory_order_relaxed);
+   statistics.corruptFragments = m_counters.corruptFragments.load(boost::memory_order_relaxed);
+   statistics.overflowPackets = m_counters.overflowPackets.load(boost::memory_order_relaxed);
+   statistics.failedPackets = m_counters.failedPackets.load(boost::memory_order_relaxed);
+   statistics.renderedFrames = m_counters.renderedFrames.load(boost::memory_order_relaxed);
+   statistics.pulledFrames = m_counters.pulledFrames.load(boost::memory_order_relaxed);
+   statistics.shedFrames = m_counters.shedFrames.load(boost::memory_order_relaxed);
+   statistics.droppedFrames = m_counters.droppedFrames.load(boost::memory_order_relaxed);
+   statistics.skippedFrames = m_counters.skippedFrames.load(boost::memory_order_relaxed);
+   statistics.streamedFrames = m_counters.streamedFrames.load(boost::memory_order_relaxed);
+   statistics.decodedAheadFrames = m_counters.decodedAheadFrames.load(boost::memory_order_relaxed);
+   statistics.expiredFrames = m_counters.expiredFrames.load(boost::memory_order_relaxed);
+   statistics.concealedFrames = m_counters.concealedFrames.load(boost::memory_order_relaxed);
+   statistics.decodeQueueDepth = m_counters.decodeQueueDepth.load(boost::memory_order_relaxed);
+   statistics.decodeQueueLag = GetDecodeQueueLag();
+   statistics.recyclerCpu = m_counters.recyclerCpu.load(boost::memory_order_relaxed);
+   statistics.decoderCpu = m_counters.decoderCpu.load(boost::memory_order_relaxed);
+   statistics.renderCpu = m_counters.renderCpu.load(boost::memory_order_relaxed);
+   return statistics;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+boost::shared_ptr<IIngestPath> JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::CreateIngestPath()
+{
+   LOCK lock(m_ingestPathsGuard);
+   if (!m_duplicateFilter)
+      m_duplicateFilter.reset(new DuplicateFilter());
+   return boost::shared_ptr<IIngestPath>(new IngestPathImpl(*this, *m_duplicateFilter, m_clock));
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::Counters::Counters()
+   : receivedFragments(0)
+   , duplicateFragments(0)
+   , lateFragments(0)
+   , invalidPackets(0)
+   , corruptFragments(0)
+   , overflowPackets(0)
+   , failedPackets(0)
+   , renderedFrames(0)
+   , pulledFrames(0)
+   , shedFrames(0)
+   , droppedFrames(0)
+   , skippedFrames(0)
+   , streamedFrames(0)
+   , decodedAheadFrames(0)
+   , expiredFrames(0)
+   , concealedFrames(0)
+   , decodeQueueDepth(0)
+   , recyclerCpu(-1)
+   , decoderCpu(-1)
+   , renderCpu(-1)
+{}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::Increment(Counter& counter)
+{
+   counter.fetch_add(1, boost::memory_order_relaxed);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::PlaceWorkerThread(
+   const ThreadPlacement& placement) throw()
+{
+   try
+   {
+      ApplyThreadPlacement(placement);
+   }
+   catch(const std::exception&)
+   {
+      // thread keeps default placement, which is not a reason to stop processing
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+   }
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+result_t JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::WaitForDrain(
+   const bool useDeadline,
+   const TimeUs deadline)
+{
+   if (m_options.pullMode)
+      return DecodePulledFrames(useDeadline, deadline);
+
+   boost::unique_lock<boost::mutex> lock(m_unsortedFrameBuffersGuard);
+   while (!m_frameProcessingIsBlocked)
+   {
+      bool nextFramePromotable = IsNextFramePromotable();
+      if (!nextFramePromotable && !m_framesInFlight)
+         return result_code::sOk;
+
+      // recycler may still be waiting for notification about the last fragment
+      if (nextFramePromotable)
+         m_recycleCondition.NotifyOne();
+
+      if (!useDeadline)
+         m_drainCondition.wait(lock);
+      else if (!m_clock->WaitUntil(lock, m_drainCondition, deadline))
+         return (IsNextFramePromotable() || m_framesInFlight) ? result_code::eNotReady : result_code::sOk;
+   }
+   return result_code::eFail;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+FrameBufferPtr JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::TakeNextFrame()
+{
+   FrameQueue promotedFrames;
+   {
+      LOCK lock(m_unsortedFrameBuffersGuard);
+      TimeUs deadline;
+      while (!IsNextFramePromotable() && promotedFrames.IsEmpty() &&
+             (deadline = GetNextFrameDeadline()) >= 0 && m_clock->GetTime() >= deadline)
+         ExpireNextFrame(promotedFrames);
+      PromoteCompletedFrames(promotedFrames);
+   }
+
+   FrameBufferPtr frameBuffer;
+   int droppedFrames = 0;
+   int shedFrames = 0;
+   {
+      LOCK lock(m_sortedFrameBuffersGuard);
+      QueuePromotedFrames(promotedFrames);
+      droppedFrames = TrimDecodeQueue();
+      while (!frameBuffer && !m_sortedFrameBuffers.IsEmpty())
+      {
+         bool shed = ShouldShedFrame(m_sortedFrameBuffers.GetFront());
+         frameBuffer = PopFrontFrame();
+         if (shed)
+         {
+            LOGDBG << "Frame #" << frameBuffer->GetFrameNumber() << " is shed";
+            frameBuffer.reset();
+            ++shedFrames;
+         }
+      }
+   }
+
+   m_counters.shedFrames.fetch_add(shedFrames, boost::memory_order_relaxed);
+   if (droppedFrames + shedFrames)
+      FinishFrameProcessing(droppedFrames + shedFrames);
+
+   if (!frameBuffer)
+   {
+      LOCK lock(m_unsortedFrameBuffersGuard);
+      // frame completed meanwhile keeps the descriptor signaled, and so does the error
+      if (m_readinessSignaled && !IsNextFramePromotable() && !m_frameProcessingIsBlocked)
+      {
+         m_readinessEvent->Reset();
+         m_readinessSignaled = false;
+      }
+   }
+   return boost::move(frameBuffer);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+result_t JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::DecodePulledFrames(
+   const bool useDeadline,
+   const TimeUs deadline)
+{
+   while (true)
+   {
+      result_t result = DecodeNext();
+      if (result == result_code::eNotReady)
+         return result_code::sOk;
+      if (result != result_code::sOk)
+         return result_code::eFail;
+      if (useDeadline && m_clock->GetTime() >= deadline)
+         return result_code::eNotReady;
+   }
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+int JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::DecodeCompleteFrame(
+   FrameBufferPtr& frameBuffer,
+   std::vector<char>& frameData,
+   char* outputBuffer)
+{
+   LOGDBG << "Reassembling frame #" << frameBuffer->GetFrameNumber();
+   int currentFrameSize = frameBuffer->GetCurrentFrameSize();
+
+   // assembly buffer only grows, so steady stream is decoded without allocations
+   if (frameData.size() < (size_t)currentFrameSize)
+      frameData.resize(currentFrameSize);
+   frameBuffer->GetAssembledData(&frameData[0]);
+   frameBuffer.reset();
+
+   return m_decoder->DecodeFrame(&frameData[0], currentFrameSize, outputBuffer);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+bool JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::IsNextFramePromotable() const
+{
+   const FrameBuffer* frameBuffer = m_unsortedFrameBuffers.Find(m_lastDecodedFrameNumber + 1);
+   return frameBuffer && frameBuffer->IsFrameComplete();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+TimeUs JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::GetNextFrameDeadline() const
+{
+   const FrameBuffer* firstFrame = m_unsortedFrameBuffers.GetFirst();
+   if (m_options.frameDeadline <= 0 || !firstFrame)
+      return -1;
+
+   // the lowest frame is either the next one or the first one following the gap
+   return firstFrame->GetArrivalTime() + m_options.frameDeadline;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::ExpireNextFrame(FrameQueue& promotedFrames)
+{
+   FrameBuffer& firstFrame = *m_unsortedFrameBuffers.GetFirst();
+   const int frameNumber = firstFrame.GetFrameNumber();
+   if (frameNumber != m_lastDecodedFrameNumber + 1)
+   {
+      LOGDBG << "Frames #" << m_lastDecodedFrameNumber + 1 << " - #" << frameNumber - 1
+             << " are missing at deadline, skip them";
+      m_counters.expiredFrames.fetch_add(frameNumber - m_lastDecodedFrameNumber - 1,
+            boost::memory_order_relaxed);
+      m_lastDecodedFrameNumber = frameNumber - 1;
+      return;
+   }
+
+   FrameBufferPtr frameBuffer = m_unsortedFrameBuffers.Take(firstFrame);
+   if (m_concealingDecoder)
+   {
+      LOGDBG << "Frame #" << frameNumber << " is incomplete at deadline, pass it for concealment";
+      // lag of the incomplete frame is counted from the moment it is given up
+      frameBuffer->SetCompletionTime(m_clock->GetTime());
+      promotedFrames.PushBack(boost::move(frameBuffer));
+      ++m_framesInFlight;
+   }
+   else
+   {
+      LOGDBG << "Frame #" << frameNumber << " is incomplete at deadline, drop it";
+      Increment(m_counters.expiredFrames);
+   }
+
+   ++m_lastDecodedFrameNumber;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::PromoteCompletedFrames(FrameQueue& promotedFrames)
+{
+   FrameBuffer* frameBuffer;
+   while ( (frameBuffer = m_unsortedFrameBuffers.Find(m_lastDecodedFrameNumber + 1)) &&
+           frameBuffer->IsFrameComplete() )
+   {
+      promotedFrames.PushBack(m_unsortedFrameBuffers.Take(*frameBuffer));
+      ++m_lastDecodedFrameNumber;
+      ++m_framesInFlight;
+   }
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::QueuePromotedFrames(FrameQueue& promotedFrames)
+{
+   for (FrameQueue::ConstIterator frame = promotedFrames.Begin(); frame != promotedFrames.End(); ++frame)
+   {
+      if (frame->GetFrameType() == KeyFrame)
+         ++m_queuedKeyFrames;
+   }
+   m_sortedFrameBuffers.Splice(promotedFrames);
+   UpdateDecodeQueueGauges();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::BlockFrameProcessing()
+{
+   LOCK lock(m_unsortedFrameBuffersGuard);
+   m_frameProcessingIsBlocked = true;
+   m_drainCondition.notify_all();
+   // let the owner find out in pull mode
+   SignalReadiness();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::SignalReadiness()
+{
+   if (m_readinessEvent && !m_readinessSignaled)
+   {
+      m_readinessEvent->Signal();
+      m_readinessSignaled = true;
+   }
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::LaunchWorkerThreads()
+{
+   if (m_workerThreadsLaunched || m_options.pullMode)
+      return;
+
+   // threads launched before a failure are kept, the rest are retried with the next
+   // fragment
+   if (!m_recyclerThread)
+   {
+      m_recyclerThread.reset( Threading::Launch(
+            boost::bind(&JitterBufferImpl::RecycleExistingFrames, this)) );
+   }
+   if (!m_dataProcessingThread)
+   {
+      m_dataProcessingThread.reset( Threading::Launch(
+            boost::bind(&JitterBufferImpl::ProcessCompletedFrames, this)) );
+   }
+   if (m_options.renderFrameRate > 0 && !m_renderThread)
+   {
+      m_renderThread.reset( Threading::Launch(
+            boost::bind(&JitterBufferImpl::RenderScheduledFrames, this)) );
+   }
+   m_workerThreadsLaunched = true;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+bool JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::ShouldShedFrame(const FrameBuffer& frameBuffer)
+{
+   const FrameType frameType = frameBuffer.GetFrameType();
+   if (frameType == KeyFrame)
+      std::fill(m_shedReferences, m_shedReferences + Traits::MaxFrameNumber, -1);
+   else if (IsShedReference(frameBuffer.GetDependencyFrameNumber()))
+   {
+      if (frameType == ReferenceFrame)
+         AddShedReference(frameBuffer.GetFrameNumber());
+      return true;
+   }
+
+   if (!IsDecoderOverloaded(frameBuffer))
+      return false;
+
+   if (frameType == NonReferenceFrame)
+      return true;
+
+   // dropping a reference frame breaks every frame up to the next key frame,
+   // so it makes sense only if that key frame is already here
+   int nextKeyFrames = m_queuedKeyFrames - (frameType == KeyFrame ? 1 : 0);
+   if (!nextKeyFrames)
+      return false;
+
+   AddShedReference(frameBuffer.GetFrameNumber());
+   return true;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::AddShedReference(const int frameNumber)
+{
+   m_shedReferences[frameNumber % Traits::MaxFrameNumber] = frameNumber;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+bool JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::IsShedReference(const int frameNumber) const
+{
+   return frameNumber >= 0 && m_shedReferences[frameNumber % Traits::MaxFrameNumber] == frameNumber;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+bool JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::IsDecoderOverloaded(
+   const FrameBuffer& frameBuffer) const
+{
+   if (m_options.sheddingQueueDepth > 0 &&
+       m_sortedFrameBuffers.GetSize() > (size_t)m_options.sheddingQueueDepth)
+      return true;
+
+   return m_options.sheddingLag > 0 &&
+          m_clock->GetTime() - frameBuffer.GetCompletionTime() > m_options.sheddingLag;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+bool JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::IsDecodeQueueOverLimit() const
+{
+   if (m_options.decodeQueueCapacity > 0 &&
+       m_counters.decodeQueueDepth.load(boost::memory_order_relaxed) >
+       (boost::uint64_t)m_options.decodeQueueCapacity)
+      return true;
+
+   return m_options.latencyTarget > 0 && GetDecodeQueueLag() > m_options.latencyTarget;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+TimeUs JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::GetDecodeQueueLag() const
+{
+   if (!m_counters.decodeQueueDepth.load(boost::memory_order_relaxed))
+      return 0;
+   return m_clock->GetTime() - m_headCompletionTime.load(boost::memory_order_relaxed);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+int JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::TrimDecodeQueue()
+{
+   if (m_options.backpressurePolicy == SignalProducer)
+      return 0;
+
+   int droppedFrames = 0;
+   while (!m_sortedFrameBuffers.IsEmpty() && IsDecodeQueueOverLimit())
+   {
+      const FrameBuffer& frameBuffer = m_sortedFrameBuffers.GetFront();
+      if (m_options.backpressurePolicy == DropToKeyFrame)
+      {
+         // decoding resumes from the head key frame, dropping it makes sense only
+         // if there is another one further in the queue
+         if (frameBuffer.GetFrameType() == KeyFrame && m_queuedKeyFrames == 1)
+            break;
+         // frames depending on the dropped one are shed by decoder thread
+         AddShedReference(frameBuffer.GetFrameNumber());
+      }
+
+      LOGDBG << "Frame #" << frameBuffer.GetFrameNumber() << " is dropped from decode queue";
+      FrameBufferPtr droppedFrame = PopFrontFrame();
+      // decode-ahead may be reading it, the frame is released once it is done
+      if (droppedFrame.get() == m_decodeAheadFrame.load(boost::memory_order_relaxed))
+         m_droppedDecodeAheadFrame = boost::move(droppedFrame);
+      ++droppedFrames;
+   }
+
+   m_counters.droppedFrames.fetch_add(droppedFrames, boost::memory_order_relaxed);
+   return droppedFrames;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+FrameBufferPtr JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::PopFrontFrame()
+{
+   FrameBufferPtr frameBuffer = m_sortedFrameBuffers.PopFront();
+   if (frameBuffer->GetFrameType() == KeyFrame)
+      --m_queuedKeyFrames;
+   UpdateDecodeQueueGauges();
+   return boost::move(frameBuffer);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::UpdateDecodeQueueGauges()
+{
+   if (!m_sortedFrameBuffers.IsEmpty())
+   {
+      m_headCompletionTime.store(m_sortedFrameBuffers.GetFront().GetCompletionTime(),
+            boost::memory_order_relaxed);
+   }
+   m_counters.decodeQueueDepth.store(m_sortedFrameBuffers.GetSize(), boost::memory_order_relaxed);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::FinishFrameProcessing(const int frameCount)
+{
+   LOCK lock(m_unsortedFrameBuffersGuard);
+   m_framesInFlight -= frameCount;
+   m_drainCondition.notify_all();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::RecycleExistingFrames()
+{
+   try
+   {
+      PlaceWorkerThread(m_options.recyclerPlacement);
+      FrameQueue tempArray;
+
+      while (true)
+      {
+         m_counters.recyclerCpu.store(GetCurrentCpu(), boost::memory_order_relaxed);
+         { // loop through unsorted frames
+            boost::unique_lock<boost::mutex> lock(m_unsortedFrameBuffersGuard);
+            while (!m_shutdownRequested && !IsNextFramePromotable() && tempArray.IsEmpty())
+            {
+               TimeUs deadline = GetNextFrameDeadline();
+               if (deadline < 0)
+                  m_recycleCondition.Wait(lock);
+               else if (m_clock->GetTime() >= deadline)
+                  ExpireNextFrame(tempArray);
+               else
+                  m_clock->WaitUntil(lock, m_recycleCondition.GetCondition(), deadline);
+            }
+
+            // on shutdown all frames which are ready to be decoded are passed
+            // further, the rest are purged
+            if (!IsNextFramePromotable() && tempArray.IsEmpty())
+               break;
+
+            // pick up the whole sequence of completed frames at once
+            PromoteCompletedFrames(tempArray);
+         }
+
+         int droppedFrames = 0;
+         {
+            LOCK lock(m_sortedFrameBuffersGuard);
+            QueuePromotedFrames(tempArray);
+            droppedFrames = TrimDecodeQueue();
+            m_decoderCondition.NotifyOne();
+         }
+
+         if (droppedFrames)
+            FinishFrameProcessing(droppedFrames);
+      } // while (true)
+   }
+   catch (const std::exception&)
+   {
+      // log error but do not throw as it's a thread routine
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+      BlockFrameProcessing();
+   }
+
+   // let decoder finish with the frames it already has and stop
+   LOCK lock(m_sortedFrameBuffersGuard);
+   m_recyclerFinished = true;
+   m_decoderCondition.NotifyOne();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::ProcessCompletedFrames()
+{
+   try
+   {
+      // placed before any allocation, so that buffers are local to the thread CPU
+      PlaceWorkerThread(m_options.decoderPlacement);
+      FrameBufferPtr frameBuffer;
+
+      // since Decoder response size is fixed we can allocate buffer once
+      boost::scoped_array<char> decodedData( new char[Traits::MaxDecodedBufferSize] );
+      if (m_options.renderFrameRate > 0)
+         AllocateRenderFrames();
+      std::vector<char> partData;
+      std::vector<char> frameData;
+      std::vector<unsigned char> fragmentPresence;
+      std::vector<int> fragmentOffsets;
+
+      while (true)
+      {
+         m_counters.decoderCpu.store(GetCurrentCpu(), boost::memory_order_relaxed);
+         bool shed = false;
+         int droppedFrames = 0;
+         { // locker scope
+            boost::unique_lock<boost::mutex> lock(m_sortedFrameBuffersGuard);
+            while (!m_recyclerFinished && m_sortedFrameBuffers.IsEmpty())
+            {
+               if (m_idleWorkReady.exchange(false))
+               {
+                  lock.unlock();
+                  if (m_streamingDecoder)
+                     StreamNextFrame(partData);
+                  // one frame at a time, so decode-ahead never delays frames in sequence
+                  if (m_options.decodeAhead && DecodeAheadFrame(frameData, decodedData.get()))
+                     m_idleWorkReady = true;
+                  lock.lock();
+                  continue;
+               }
+               m_decoderCondition.Wait(lock);
+            }
+
+            if (m_sortedFrameBuffers.IsEmpty())
+               break;
+
+            // frames keep aging while decoder is busy, so latency target is
+            // checked once again right before decoding
+            droppedFrames = TrimDecodeQueue();
+            if (!m_sortedFrameBuffers.IsEmpty())
+            {
+               shed = ShouldShedFrame(m_sortedFrameBuffers.GetFront());
+               frameBuffer = PopFrontFrame();
+            }
+         }
+
+         if (droppedFrames)
+            FinishFrameProcessing(droppedFrames);
+
+         if (!frameBuffer)
+            continue;
+
+         // streamed frame is either this one or it was dropped from decode queue
+         if (frameBuffer->GetFrameNumber() != m_streamedFrameNumber || shed)
+            AbortStreamedFrame();
+
+         // frames decoded ahead of this one were dropped from decode queue
+         ReorderSlot* decodedAhead = 0;
+         for (typename ReorderBuffer::iterator slot = m_reorderBuffer.begin();
+              slot != m_reorderBuffer.end(); ++slot)
+         {
+            if (slot->frameNumber < frameBuffer->GetFrameNumber())
+               slot->frameNumber = -1;
+            else if (slot->frameNumber == frameBuffer->GetFrameNumber())
+               decodedAhead = &*slot;
+         }
+         if (shed && decodedAhead)
+         {
+            decodedAhead->frameNumber = -1;
+            decodedAhead = 0;
+         }
+
+         if (shed)
+         {
+            LOGDBG << "Frame #" << frameBuffer->GetFrameNumber() << " is shed";
+            frameBuffer.reset();
+            Increment(m_counters.shedFrames);
+            FinishFrameProcessing(1);
+            continue;
+         }
+
+         TimeUs timestamp = frameBuffer->GetTimestamp();
+         int decodedBufferSize = 0;
+         // frame rendered right away is decoded into the renderer buffer, if it has one
+         char* outputBuffer = decodedData.get();
+         if (m_bufferedRenderer && m_options.renderFrameRate <= 0 && !decodedAhead)
+         {
+            char* renderBuffer = m_bufferedRenderer->GetFrameBuffer(Traits::MaxDecodedBufferSize);
+            if (renderBuffer)
+               outputBuffer = renderBuffer;
+         }
+         if (decodedAhead)
+         {
+            frameBuffer.reset();
+            decodedBufferSize = (int)decodedAhead->data.size();
+            if (decodedBufferSize)
+               outputBuffer = &decodedAhead->data[0];
+            // output stays in place until this thread decodes ahead again
+            decodedAhead->frameNumber = -1;
+         }
+         else if (!frameBuffer->IsFrameComplete())
+         {
+            AbortStreamedFrame();
+            frameBuffer->GetDataWithGaps(partData, fragmentPresence, fragmentOffsets);
+            frameBuffer.reset();
+
+            decodedBufferSize = m_concealingDecoder->DecodeIncompleteFrame(
+                  partData.empty() ? 0 : &partData[0],
+                  (int)partData.size(),
+                  &fragmentPresence[0],
+                  &fragmentOffsets[0],
+                  (int)fragmentPresence.size(),
+                  outputBuffer);
+            Increment(m_counters.concealedFrames);
+         }
+         else if (m_streamedFrameNumber >= 0)
+         {
+            // pass the rest of the frame and let decoder finish it
+            frameBuffer->GetContiguousData(m_streamedBytes, partData);
+            frameBuffer.reset();
+            if (!partData.empty())
+               m_streamingDecoder->DecodeFramePart(&partData[0], (int)partData.size());
+
+            m_streamedFrameNumber = -1;
+            decodedBufferSize = m_streamingDecoder->FinishFrame(outputBuffer);
+            Increment(m_counters.streamedFrames);
+         }
+         else
+            decodedBufferSize = DecodeCompleteFrame(frameBuffer, frameData, outputBuffer);
+
+         const char* output = outputBuffer;
+         if (m_options.renderFrameRate > 0)
+         {
+            ScheduleRender(output, decodedBufferSize, timestamp);
+            continue;
+         }
+
+         m_renderer->RenderFrame(output, decodedBufferSize);
+         Increment(m_counters.renderedFrames);
+         FinishFrameProcessing(1);
+      } // while (true)
+   }
+   catch (const std::exception&)
+   {
+      // log error but do not throw as it's a thread routine
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+      BlockFrameProcessing();
+   }
+
+   // incomplete frames are purged on shutdown
+   try
+   {
+      AbortStreamedFrame();
+   }
+   catch (const std::exception&)
+   {
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+   }
+
+   // let render thread finish with the frames it already has and stop
+   LOCK lock(m_renderGuard);
+   m_decoderFinished = true;
+   m_renderCondition.NotifyOne();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::StreamNextFrame(std::vector<char>& partData)
+{
+   int frameNumber = 0;
+   int contiguousSize = 0;
+   {
+      LOCK lock(m_unsortedFrameBuffersGuard);
+      frameNumber = m_lastDecodedFrameNumber + 1;
+      FrameBuffer* frameBuffer = m_unsortedFrameBuffers.Find(frameNumber);
+      if (!frameBuffer)
+         return;
+
+      int offset = (frameNumber == m_streamedFrameNumber) ? m_streamedBytes : 0;
+      contiguousSize = frameBuffer->GetContiguousData(offset, partData);
+   }
+
+   if (partData.empty())
+      return;
+
+   if (frameNumber != m_streamedFrameNumber)
+   {
+      AbortStreamedFrame();
+      m_streamedFrameNumber = frameNumber;
+   }
+   m_streamedBytes = contiguousSize;
+
+   LOGDBG << "Streaming " << partData.size() << " bytes of frame #" << frameNumber;
+   m_streamingDecoder->DecodeFramePart(&partData[0], (int)partData.size());
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+bool JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::DecodeAheadFrame(
+   std::vector<char>& frameData,
+   char* decodedData)
+{
+   // streaming decoder is in the middle of a frame, it can't take another one
+   if (m_streamedFrameNumber >= 0)
+      return false;
+   ReorderSlot* slot = FindDecodedAhead(-1);
+   if (!slot)
+      return false;
+
+   FrameBuffer* frameBuffer = 0;
+   {
+      LOCK lock(m_unsortedFrameBuffersGuard);
+      for (typename Index::Iterator it = m_unsortedFrameBuffers.UpperBound(m_lastDecodedFrameNumber + 1);
+           it != m_unsortedFrameBuffers.End(); ++it)
+      {
+         if (it->IsFrameComplete() && it->IsIndependent() && !FindDecodedAhead(it->GetFrameNumber()))
+         {
+            frameBuffer = &*it;
+            m_decodeAheadFrame.store(frameBuffer, boost::memory_order_relaxed);
+            break;
+         }
+      }
+   }
+
+   if (!frameBuffer)
+      return false;
+
+   // complete frame is never written again, so it is assembled without blocking ingest;
+   // it is kept alive if dropped from decode queue meanwhile, see TrimDecodeQueue
+   const int frameNumber = frameBuffer->GetFrameNumber();
+   const int frameSize = frameBuffer->GetCurrentFrameSize();
+   if (frameData.size() < (size_t)frameSize)
+      frameData.resize(frameSize);
+   frameBuffer->GetAssembledData(&frameData[0]);
+   {
+      LOCK lock(m_sortedFrameBuffersGuard);
+      m_decodeAheadFrame.store(0, boost::memory_order_relaxed);
+      m_droppedDecodeAheadFrame.reset();
+   }
+
+   LOGDBG << "Decoding frame #" << frameNumber << " ahead";
+   int decodedBufferSize = m_decoder->DecodeFrame(&frameData[0], frameSize, decodedData);
+
+   // frame may have been promoted meanwhile, but it is popped by this very thread
+   // so the output is in place by then
+   slot->frameNumber = frameNumber;
+   slot->data.assign(decodedData, decodedData + decodedBufferSize);
+   Increment(m_counters.decodedAheadFrames);
+   return true;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+typename JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::ReorderSlot*
+JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::FindDecodedAhead(const int frameNumber)
+{
+   for (typename ReorderBuffer::iterator slot = m_reorderBuffer.begin();
+        slot != m_reorderBuffer.end(); ++slot)
+   {
+      if (slot->frameNumber == frameNumber)
+         return &*slot;
+   }
+   return 0;
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::AbortStreamedFrame()
+{
+   if (m_streamedFrameNumber < 0)
+      return;
+
+   LOGDBG << "Streamed frame #" << m_streamedFrameNumber << " is dropped";
+   m_streamedFrameNumber = -1;
+   m_streamingDecoder->AbortFrame();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::AllocateRenderFrames()
+{
+   // decoder takes a node while queue is short of one frame, and one more node is
+   // held by render thread
+   DecodedFrames frames(Traits::RenderQueueCapacity + 1);
+   for (typename DecodedFrames::iterator it = frames.begin(); it != frames.end(); ++it)
+   {
+      // resize writes the whole buffer, clear keeps the capacity
+      it->data.resize(Traits::MaxDecodedBufferSize);
+      it->data.clear();
+   }
+   LOCK lock(m_renderGuard);
+   m_freeRenderFrames.splice(m_freeRenderFrames.end(), frames);
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::ScheduleRender(
+   const char* decodedData,
+   const int decodedBufferSize,
+   const TimeUs timestamp)
+{
+   DecodedFrames frames;
+   {
+      boost::unique_lock<boost::mutex> lock(m_renderGuard);
+      while (!m_rendererStopped && m_renderQueue.size() >= Traits::RenderQueueCapacity)
+         m_renderSlotCondition.Wait(lock);
+
+      if (m_rendererStopped)
+         THROW_BASIC_EXCEPTION(result_code::eFail) << "Render thread is stopped";
+
+      // pool always has a node here, see AllocateRenderFrames
+      frames.splice(frames.end(), m_freeRenderFrames, m_freeRenderFrames.begin());
+   }
+
+   // copied without the lock, buffer capacity is enough for any decoder output
+   frames.front().data.assign(decodedData, decodedData + decodedBufferSize);
+   frames.front().timestamp = timestamp;
+
+   LOCK lock(m_renderGuard);
+   m_renderQueue.splice(m_renderQueue.end(), frames);
+   m_renderCondition.NotifyOne();
+}
+
+template <class Decoder, class Renderer, class Traits, class Threading, class Storage>
+void JitterBufferImpl<Decoder, Renderer, Traits, Threading, Storage>::RenderScheduledFrames()
+{
+   try
+   {
+      PlaceWorkerThread(m_options.renderPlacement);
+      const TimeUs defaultInterval = (TimeUs)(1000000.0 / m_options.renderFrameRate);
+      DecodedFrames frames;
+      bool anchored = false;
+      TimeUs dueTime = 0;
+      TimeUs lastTimestamp = -1;
+
+      while (true)
+      {
+         m_counters.renderCpu.store(GetCurrentCpu(), boost::memory_order_relaxed);
+         { // locker scope
+            boost::unique_lock<boost::mutex> lock(m_renderGuard);
+            // node of the previous frame goes back to the pool
+            m_freeRenderFrames.splice(m_freeRenderFrames.end(), frames);
+            while (!m_decoderFinished && m_renderQueue.empty())
+               m_renderCondition.Wait(lock);
+
+            if (m_renderQueue.empty())
+               break;
+
+            frames.splice(frames.end(), m_renderQueue, m_renderQueue.begin());
+            m_renderSlotCondition.NotifyOne();
+         }
+         const DecodedFrame& frame = frames.front();
+
+         TimeUs interval = defaultInterval;
+         if (frame.timestamp >= 0 && lastTimestamp >= 0 && frame.timestamp > lastTimestamp)
+            interval = frame.timestamp - lastTimestamp;
+         lastTimestamp = frame.timestamp;
+
+         TimeUs now = m_clock->GetTime();
+         dueTime = anchored ? dueTime + interval : now;
+         anchored = true;
+
+         if (now > dueTime + interval)
+         {
+            // stale frame is not worth rendering if there is something newer for this
+            // time slot anywhere in the pipeline (decode queue, decoder or render queue)
+            bool newerFrameReady = false;
+            {
+               LOCK lock(m_unsortedFrameBuffersGuard);
+               newerFrameReady = m_framesInFlight > 1;
+            }
+            if (newerFrameReady)
+            {
+               Increment(m_counters.skippedFrames);
+               FinishFrameProcessing(1);
+               continue;
+            }
+            dueTime = now;
+         }
+
+         { // wait for the due time unless decoder is already finished
+            boost::unique_lock<boost::mutex> lock(m_renderGuard);
+            while (!m_decoderFinished &&
+                   m_clock->WaitUntil(lock, m_renderCondition.GetCondition(), dueTime))
+               ;
+         }
+
+         m_renderer->RenderFrame(frame.data.empty() ? 0 : &frame.data[0], (int)frame.data.size());
+         Increment(m_counters.renderedFrames);
+         FinishFrameProcessing(1);
+      } // while (true)
+   }
+   catch (const std::exception&)
+   {
+      // log error but do not throw as it's a thread routine
+      exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+      BlockFrameProcessing();
+   }
+
+   // let decoder know nobody takes frames any more
+   LOCK lock(m_renderGuard);
+   m_rendererStopped = true;
+   m_renderSlotCondition.NotifyOne();
+}
+
+
 } // namespace video_coding
 
 #endif // VIDEO_CODING_JITTER_BUFFER_IMPL_H
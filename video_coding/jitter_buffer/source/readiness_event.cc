@@ -0,0 +1,88 @@
+/**
+ *  @file
+ *  \brief     ReadinessEvent class implementation
+ *  \details   Holds implementation of the ReadinessEvent class based on eventfd on Linux
+ *             and on a pipe on other POSIX platforms
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "readiness_event.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#include <boost/cstdint.hpp>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+namespace video_coding
+{
+
+ReadinessEvent::ReadinessEvent()
+   : m_readDescriptor(-1)
+   , m_writeDescriptor(-1)
+{
+#if defined(__linux__)
+   m_readDescriptor = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   if (m_readDescriptor < 0)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to create eventfd, error " << errno;
+   m_writeDescriptor = m_readDescriptor;
+#elif !defined(_WIN32)
+   int descriptors[2];
+   if (::pipe(descriptors) != 0)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to create pipe, error " << errno;
+   m_readDescriptor = descriptors[0];
+   m_writeDescriptor = descriptors[1];
+   for (int i = 0; i < 2; ++i)
+   {
+      ::fcntl(descriptors[i], F_SETFL, ::fcntl(descriptors[i], F_GETFL) | O_NONBLOCK);
+      ::fcntl(descriptors[i], F_SETFD, FD_CLOEXEC);
+   }
+#else
+   THROW_BASIC_EXCEPTION(result_code::eFail) << "Readiness descriptor is not supported";
+#endif
+}
+
+ReadinessEvent::~ReadinessEvent()
+{
+#ifndef _WIN32
+   if (m_writeDescriptor != m_readDescriptor)
+      ::close(m_writeDescriptor);
+   ::close(m_readDescriptor);
+#endif
+}
+
+int ReadinessEvent::GetDescriptor() const
+{
+   return m_readDescriptor;
+}
+
+void ReadinessEvent::Signal()
+{
+#if defined(__linux__)
+   const boost::uint64_t value = 1;
+   ssize_t written = ::write(m_writeDescriptor, &value, sizeof(value));
+   (void)written;
+#elif !defined(_WIN32)
+   const char value = 1;
+   ssize_t written = ::write(m_writeDescriptor, &value, sizeof(value));
+   (void)written;
+#endif
+}
+
+void ReadinessEvent::Reset()
+{
+#ifndef _WIN32
+   // eventfd counter is cleared by a single read, pipe holds at most one byte
+   boost::uint64_t value;
+   ssize_t taken = ::read(m_readDescriptor, &value, sizeof(value));
+   (void)taken;
+#endif
+}
+
+} // namespace video_coding
@@ -0,0 +1,64 @@
+/**
+ *  @file
+ *  \brief     ReadinessEvent class declaration
+ *  \details   Holds declaration of the ReadinessEvent class
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_READINESS_EVENT_H
+#define VIDEO_CODING_READINESS_EVENT_H
+
+// third-party
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * ReadinessEvent class owns a file descriptor which becomes readable when the event
+ * is signaled, so that it can be watched by poll/epoll of an external event loop.
+ * Based on eventfd on Linux and on a non-blocking pipe on other POSIX platforms
+ */
+class ReadinessEvent : boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. Creates the event in non-signaled state. Throws std::exception on
+    * system error or if platform is not supported
+    */
+   ReadinessEvent();
+
+   /**
+    * Destructor. Closes the descriptors
+    */
+   ~ReadinessEvent();
+
+   /**
+    * Accessor to get the descriptor to be watched for readability
+    * @returns - descriptor
+    */
+   int GetDescriptor() const;
+
+   /**
+    * Makes the descriptor readable. Must not be called again before Reset. Does not
+    * throw
+    */
+   void Signal();
+
+   /**
+    * Makes the descriptor not readable. Does not throw
+    */
+   void Reset();
+
+private:
+   /// descriptor watched by the event loop
+   int         m_readDescriptor;
+   /// descriptor written by Signal, the same as m_readDescriptor for eventfd
+   int         m_writeDescriptor;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_READINESS_EVENT_H
@@ -0,0 +1,74 @@
+/**
+ *  @file
+ *  \brief     Worker thread placement helpers
+ *  \details   Holds implementation of the ThreadPlacement related functions, based on
+ *             pthread affinity and scheduling API on Linux
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "thread_placement.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace video_coding
+{
+
+void ValidateThreadPlacement(const ThreadPlacement& placement)
+{
+   CHECK_ARGUMENT(placement.realtimePriority >= 0 && placement.realtimePriority <= 99,
+         "Invalid real-time priority " << placement.realtimePriority);
+#ifdef __linux__
+   for (size_t i = 0; i < placement.cpus.size(); ++i)
+   {
+      CHECK_ARGUMENT(placement.cpus[i] >= 0 && placement.cpus[i] < CPU_SETSIZE,
+            "Invalid CPU number " << placement.cpus[i]);
+   }
+#endif
+}
+
+void ApplyThreadPlacement(const ThreadPlacement& placement)
+{
+#ifdef __linux__
+   if (!placement.cpus.empty())
+   {
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      for (size_t i = 0; i < placement.cpus.size(); ++i)
+         CPU_SET(placement.cpus[i], &cpuSet);
+
+      int error = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+      if (error)
+         THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to set thread affinity, error " << error;
+      // let the scheduler move the thread to the allowed CPU before it touches memory
+      ::sched_yield();
+   }
+
+   if (placement.realtimePriority > 0)
+   {
+      sched_param parameters = sched_param();
+      parameters.sched_priority = placement.realtimePriority;
+      int error = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &parameters);
+      if (error)
+         THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to set SCHED_FIFO priority "
+               << placement.realtimePriority << ", error " << error;
+   }
+#else
+   (void)placement;
+#endif
+}
+
+int GetCurrentCpu()
+{
+#ifdef __linux__
+   return ::sched_getcpu();
+#else
+   return -1;
+#endif
+}
+
+} // namespace video_coding
@@ -0,0 +1,42 @@
+/**
+ *  @file
+ *  \brief     Worker thread placement helpers
+ *  \details   Holds declaration of the functions which apply ThreadPlacement settings
+ *             to the calling thread and query the CPU it runs on
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_THREAD_PLACEMENT_H
+#define VIDEO_CODING_THREAD_PLACEMENT_H
+
+#include <video_coding/interface/jitter_buffer.h>
+
+namespace video_coding
+{
+
+/**
+ * Checks placement settings are valid on this platform. Throws std::exception with
+ * InvalidArgument result code otherwise
+ * @param placement - settings to check
+ */
+void ValidateThreadPlacement(const ThreadPlacement& placement);
+
+/**
+ * Applies placement settings to the calling thread: restricts it to the given CPUs
+ * and switches it to real-time scheduling. Does nothing for default settings or if
+ * platform is not supported. Throws std::exception with Fail result code if settings
+ * can't be applied
+ * @param placement - settings to apply
+ */
+void ApplyThreadPlacement(const ThreadPlacement& placement);
+
+/**
+ * Helper function to get CPU the calling thread runs on. Does not throw
+ * @returns - CPU number, -1 if unknown
+ */
+int GetCurrentCpu();
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_THREAD_PLACEMENT_H
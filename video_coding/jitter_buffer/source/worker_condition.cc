@@ -0,0 +1,97 @@
+/**
+ *  @file
+ *  \brief     WorkerCondition class implementation
+ *  \details   Holds implementation of the WorkerCondition class
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "worker_condition.h"
+// third-party
+#include <boost/chrono.hpp>
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+/// number of spin iterations between checks of the spin time
+const int SpinBatch = 64;
+
+/**
+ * Helper function to hint CPU that the thread is spinning, which saves power and
+ * frees resources for the sibling hyper-thread
+ */
+inline void CpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+   _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+   __asm__ __volatile__("yield");
+#endif
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+WorkerCondition::WorkerCondition(const WaitStrategy strategy, const TimeUs spinTime)
+   : m_strategy(strategy)
+   , m_spinTime(spinTime)
+   , m_sequence(0)
+   , m_expiredSequence(0)
+   , m_spinExpired(false)
+{}
+
+void WorkerCondition::NotifyOne()
+{
+   m_sequence.fetch_add(1, boost::memory_order_release);
+   m_condition.notify_one();
+}
+
+void WorkerCondition::Wait(boost::unique_lock<boost::mutex>& lock)
+{
+   const unsigned int sequence = m_sequence.load(boost::memory_order_relaxed);
+   if (m_strategy != BlockingWait && !(m_spinExpired && sequence == m_expiredSequence))
+   {
+      m_spinExpired = false;
+      lock.unlock();
+      bool notified = Spin(sequence);
+      lock.lock();
+      if (!notified)
+      {
+         m_spinExpired = true;
+         m_expiredSequence = sequence;
+      }
+      return;
+   }
+
+   m_spinExpired = false;
+   m_condition.wait(lock);
+}
+
+boost::condition_variable& WorkerCondition::GetCondition()
+{
+   return m_condition;
+}
+
+bool WorkerCondition::Spin(const unsigned int sequence) const
+{
+   typedef boost::chrono::steady_clock Clock;
+   const Clock::time_point deadline = Clock::now() + boost::chrono::microseconds(m_spinTime);
+   while (true)
+   {
+      for (int i = 0; i < SpinBatch; ++i)
+      {
+         if (m_sequence.load(boost::memory_order_acquire) != sequence)
+            return true;
+         CpuRelax();
+      }
+      if (m_strategy == SpinThenParkWait && Clock::now() >= deadline)
+         return false;
+   }
+}
+
+} // namespace video_coding
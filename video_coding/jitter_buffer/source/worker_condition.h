@@ -0,0 +1,87 @@
+/**
+ *  @file
+ *  \brief     WorkerCondition class declaration
+ *  \details   Condition variable which lets the waiting worker thread spin before it
+ *             blocks, according to JitterBufferOptions::waitStrategy
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_WORKER_CONDITION_H
+#define VIDEO_CODING_WORKER_CONDITION_H
+
+#include <video_coding/interface/jitter_buffer.h>
+// third-party
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * WorkerCondition class
+ * Wraps condition variable and counts notifications, so that the waiter can watch the
+ * counter without the lock instead of blocking. Wait may return spuriously, caller
+ * re-checks its predicate under the lock, the same as with plain condition variable.
+ * When spinning expires Wait returns to let caller re-check the predicate and the
+ * next Wait blocks unless notification arrives in between, so no notification is lost.
+ * Designed for a single waiting thread
+ */
+class WorkerCondition : boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor
+    * @param strategy - how Wait waits for notification
+    * @param spinTime - time (microseconds, real time) Wait spins in SpinThenParkWait mode
+    */
+   WorkerCondition(WaitStrategy strategy, TimeUs spinTime);
+
+   /**
+    * Wakes up the waiting thread
+    */
+   void NotifyOne();
+
+   /**
+    * Waits for notification according to the strategy
+    * @param lock - lock of the mutex protecting the predicate, held on entry and exit
+    */
+   void Wait(boost::unique_lock<boost::mutex>& lock);
+
+   /**
+    * Accessor to the underlying condition variable, used for timed waits which always
+    * block (see IClock::WaitUntil)
+    * @returns - reference to the condition variable
+    */
+   boost::condition_variable& GetCondition();
+
+private:
+
+   /**
+    * Spins until notification arrives or spin time expires
+    * @param sequence - notification counter value before spinning
+    * @returns - true if notified
+    */
+   bool Spin(unsigned int sequence) const;
+
+   /// how Wait waits for notification
+   const WaitStrategy                     m_strategy;
+   /// time Wait spins in SpinThenParkWait mode
+   const TimeUs                           m_spinTime;
+   /// condition variable to block on
+   boost::condition_variable              m_condition;
+   /// number of notifications sent
+   boost::atomic<unsigned int>            m_sequence;
+   /// notification counter value when spinning expired last time, next Wait blocks
+   /// if there were no notifications since then. Accessed under the waiter lock
+   unsigned int                           m_expiredSequence;
+   /// Indicates m_expiredSequence is valid
+   bool                                   m_spinExpired;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_WORKER_CONDITION_H
@@ -0,0 +1,65 @@
+#include "allocation_counter.h"
+// third-party
+#include <stdlib.h>
+#include <new>
+#include <boost/atomic.hpp>
+
+namespace
+{
+
+boost::atomic<boost::uint64_t> allocationCount(0);
+
+void* CountedAllocate(std::size_t size)
+{
+   allocationCount.fetch_add(1, boost::memory_order_relaxed);
+   void* memory = ::malloc(size ? size : 1);
+   if (!memory)
+      throw std::bad_alloc();
+   return memory;
+}
+
+} // unnamed namespace
+
+// replacements of the global allocation functions, see GetAllocationCount
+void* operator new(std::size_t size)
+{
+   return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+   return CountedAllocate(size);
+}
+
+void operator delete(void* memory) throw()
+{
+   ::free(memory);
+}
+
+void operator delete[](void* memory) throw()
+{
+   ::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) throw()
+{
+   ::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) throw()
+{
+   ::free(memory);
+}
+
+namespace video_coding
+{
+namespace test
+{
+
+boost::uint64_t GetAllocationCount()
+{
+   return allocationCount.load(boost::memory_order_relaxed);
+}
+
+} // namespace test
+} // namespace video_coding
@@ -0,0 +1,22 @@
+#ifndef VIDEO_CODING_TEST_ALLOCATION_COUNTER_H
+#define VIDEO_CODING_TEST_ALLOCATION_COUNTER_H
+
+// third-party
+#include <boost/cstdint.hpp>
+
+namespace video_coding
+{
+namespace test
+{
+
+/**
+ * Accessor to the number of global operator new calls made by the test binary
+ * in every thread so far
+ * @returns - number of allocations
+ */
+boost::uint64_t GetAllocationCount();
+
+} // namespace test
+} // namespace video_coding
+
+#endif // VIDEO_CODING_TEST_ALLOCATION_COUNTER_H
@@ -44,6 +44,24 @@ result_t FixtureJitterBuffer::CreateJB(IDecoder* decoder, IRenderer* renderer)
    }
 }
 
+result_t FixtureJitterBuffer::CreateJB(const JitterBufferOptions& options)
+{
+   try
+   {
+      m_jitterBuffer = CreateJitterBuffer(m_decoder.get(), m_renderer.get(), options);
+      return result_code::sOk;
+   }
+   catch(const std::exception&)
+   {
+      return exception::ExceptionDispatcher::Dispatch(BOOST_CURRENT_FUNCTION);
+   }
+}
+
+void FixtureJitterBuffer::ReleaseJB()
+{
+   m_jitterBuffer.reset();
+}
+
 result_t FixtureJitterBuffer::CheckReceiverFunction(
       const char* buffer,
       const int length,
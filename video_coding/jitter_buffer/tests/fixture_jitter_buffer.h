@@ -27,6 +27,8 @@ public:
    void TearDown();
 
    result_t CreateJB(IDecoder* decoder, IRenderer* renderer);
+   result_t CreateJB(const JitterBufferOptions& options);
+   void ReleaseJB();
    result_t CheckReceiverFunction(const char* buffer,
          const int length,
          const int frameNumber,
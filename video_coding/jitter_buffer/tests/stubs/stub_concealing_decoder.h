@@ -0,0 +1,54 @@
+#ifndef VIDEO_CODING_TEST_STUB_CONCEALING_DECODER_H
+#define VIDEO_CODING_TEST_STUB_CONCEALING_DECODER_H
+
+#include <video_engine/interface/concealing_decoder.h>
+#include "stub_decoder.h"
+// third-party
+#include <memory.h>
+
+namespace video_coding
+{
+namespace test
+{
+
+/// byte the stub puts in place of every missing fragment
+const char ConcealedFragment = '?';
+
+class StubConcealingDecoder : public ::video_engine::IConcealingDecoder
+{
+public:
+   virtual int DecodeFrame(const char* buffer, int length, char* outputBuffer)
+   {
+      int outputSize = (length < DecoderMaxOutputSize) ? length : DecoderMaxOutputSize;
+      ::memcpy(outputBuffer, buffer, outputSize);
+      return length;
+   }
+
+   virtual int DecodeIncompleteFrame(const char* buffer,
+      int length,
+      const unsigned char* fragmentPresence,
+      const int* fragmentOffsets,
+      int numFragments,
+      char* outputBuffer)
+   {
+      int outputSize = 0;
+      for (int i = 0; i < numFragments; ++i)
+      {
+         int fragmentEnd = (i + 1 < numFragments) ? fragmentOffsets[i + 1] : length;
+         if (!fragmentPresence[i])
+         {
+            outputBuffer[outputSize++] = ConcealedFragment;
+            continue;
+         }
+         ::memcpy(outputBuffer + outputSize, buffer + fragmentOffsets[i],
+               fragmentEnd - fragmentOffsets[i]);
+         outputSize += fragmentEnd - fragmentOffsets[i];
+      }
+      return outputSize;
+   }
+};
+
+} // namespace test
+} // namespace video_coding
+
+#endif // VIDEO_CODING_TEST_STUB_CONCEALING_DECODER_H
@@ -3,7 +3,8 @@
 
 #include <video_engine/interface/renderer.h>
 // third-party
-#include <boost/thread/barrier.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 namespace video_coding
 {
@@ -15,10 +16,19 @@ class StubRenderer : public ::video_engine::IRenderer
 public:
    StubRenderer()
       : m_dataLength(0)
+      , m_blocked(false)
+      , m_blockedCalls(0)
    {}
 
    void RenderFrame(const char* buffer, int length)
    {
+      boost::unique_lock<boost::mutex> lock(m_guard);
+      ++m_blockedCalls;
+      m_unblockedCondition.notify_all();
+      while (m_blocked)
+         m_unblockedCondition.wait(lock);
+      --m_blockedCalls;
+
       std::string tempString;
       tempString.assign(buffer, length);
       m_renderData += tempString;
@@ -28,12 +38,38 @@ public:
 
    std::string GetRenderedData()
    {
+      boost::lock_guard<boost::mutex> lock(m_guard);
       return m_renderData;
    }
 
+   /**
+    * Makes RenderFrame block the calling thread until the renderer is unblocked
+    * @param blocked - true to hold rendering, false to let it continue
+    */
+   void SetBlocked(bool blocked)
+   {
+      boost::lock_guard<boost::mutex> lock(m_guard);
+      m_blocked = blocked;
+      m_unblockedCondition.notify_all();
+   }
+
+   /**
+    * Blocks the calling thread until RenderFrame is called while renderer is blocked
+    */
+   void WaitForBlockedCall()
+   {
+      boost::unique_lock<boost::mutex> lock(m_guard);
+      while (!m_blocked || !m_blockedCalls)
+         m_unblockedCondition.wait(lock);
+   }
+
 private:
-   std::string m_renderData;
-   int         m_dataLength;
+   std::string                m_renderData;
+   int                        m_dataLength;
+   bool                       m_blocked;
+   int                        m_blockedCalls;
+   boost::mutex               m_guard;
+   boost::condition_variable  m_unblockedCondition;
 };
 
 } // namespace test
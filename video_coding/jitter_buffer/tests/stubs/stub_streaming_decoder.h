@@ -0,0 +1,86 @@
+#ifndef VIDEO_CODING_TEST_STUB_STREAMING_DECODER_H
+#define VIDEO_CODING_TEST_STUB_STREAMING_DECODER_H
+
+#include <video_engine/interface/streaming_decoder.h>
+#include "stub_decoder.h"
+// third-party
+#include <string>
+#include <memory.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace video_coding
+{
+namespace test
+{
+
+class StubStreamingDecoder : public ::video_engine::IStreamingDecoder
+{
+public:
+   StubStreamingDecoder()
+      : m_partCount(0)
+      , m_abortCount(0)
+   {}
+
+   virtual int DecodeFrame(const char* buffer, int length, char* outputBuffer)
+   {
+      int outputSize = (length < DecoderMaxOutputSize) ? length : DecoderMaxOutputSize;
+      ::memcpy(outputBuffer, buffer, outputSize);
+      return length;
+   }
+
+   virtual void DecodeFramePart(const char* buffer, int length)
+   {
+      boost::lock_guard<boost::mutex> lock(m_guard);
+      m_frameData.append(buffer, length);
+      ++m_partCount;
+   }
+
+   virtual int FinishFrame(char* outputBuffer)
+   {
+      boost::lock_guard<boost::mutex> lock(m_guard);
+      int length = (int)m_frameData.size();
+      ::memcpy(outputBuffer, m_frameData.data(), length);
+      m_frameData.clear();
+      return length;
+   }
+
+   virtual void AbortFrame()
+   {
+      boost::lock_guard<boost::mutex> lock(m_guard);
+      m_frameData.clear();
+      ++m_abortCount;
+   }
+
+   /**
+    * Accessor to get data of the frame which is being decoded
+    */
+   std::string GetFrameData()
+   {
+      boost::lock_guard<boost::mutex> lock(m_guard);
+      return m_frameData;
+   }
+
+   int GetPartCount()
+   {
+      boost::lock_guard<boost::mutex> lock(m_guard);
+      return m_partCount;
+   }
+
+   int GetAbortCount()
+   {
+      boost::lock_guard<boost::mutex> lock(m_guard);
+      return m_abortCount;
+   }
+
+private:
+   std::string    m_frameData;
+   int            m_partCount;
+   int            m_abortCount;
+   boost::mutex   m_guard;
+};
+
+} // namespace test
+} // namespace video_coding
+
+#endif // VIDEO_CODING_TEST_STUB_STREAMING_DECODER_H
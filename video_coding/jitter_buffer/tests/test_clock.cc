@@ -0,0 +1,111 @@
+
+#include <video_coding/interface/clock.h>
+#include <common/exception_dispatcher.h>
+// third-party
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+namespace
+{
+
+/**
+ * Helper routine to be run in a separate thread: blocks on the clock until deadline
+ * is reached and reports the result
+ *
+ * @param clock - clock to wait on
+ * @param deadline - absolute time to wait until
+ * @param deadlineReached - out parameter, set to true once deadline is reached
+ */
+void WaitForDeadline(video_coding::IClock* clock, video_coding::TimeUs deadline, bool* deadlineReached)
+{
+   boost::mutex mutex;
+   boost::condition_variable condition;
+   video_coding::IClock::Lock lock(mutex);
+   while (clock->WaitUntil(lock, condition, deadline))
+      ;
+   *deadlineReached = true;
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+namespace test
+{
+
+/*
+ @about Check simulated time doesn't move on its own and follows AdvanceTime calls
+ */
+TEST(SimulatedClock, AdvanceTime_MovesTimeForward)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock(100);
+   ASSERT_EQ(100, clock->GetTime());
+
+   boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+   ASSERT_EQ(100, clock->GetTime());
+
+   clock->AdvanceTime(1000);
+   ASSERT_EQ(1100, clock->GetTime());
+}
+
+/*
+ @about Check simulated time can't go backwards
+ */
+TEST(SimulatedClock, AdvanceTime_NegativeDelta)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   ASSERT_THROW(clock->AdvanceTime(-1), std::exception);
+   ASSERT_EQ(0, clock->GetTime());
+}
+
+/*
+ @about Check wait returns immediately if deadline is already reached
+ */
+TEST(SimulatedClock, WaitUntil_DeadlineInThePast)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock(500);
+   boost::mutex mutex;
+   boost::condition_variable condition;
+   IClock::Lock lock(mutex);
+
+   ASSERT_FALSE(clock->WaitUntil(lock, condition, 500));
+   ASSERT_FALSE(clock->WaitFor(lock, condition, 0));
+}
+
+/*
+ @about Check waiter is blocked until simulated time is advanced past its deadline
+ regardless of how much real time has passed
+ */
+TEST(SimulatedClock, WaitUntil_WokenUpByAdvanceTime)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   bool deadlineReached = false;
+   boost::thread waiter(boost::bind(WaitForDeadline, clock.get(), 1000000, &deadlineReached));
+
+   clock->AdvanceTime(999999);
+   ASSERT_FALSE(waiter.timed_join(boost::posix_time::milliseconds(50)));
+
+   clock->AdvanceTime(1);
+   ASSERT_TRUE(waiter.timed_join(boost::posix_time::seconds(5)));
+   ASSERT_TRUE(deadlineReached);
+}
+
+/*
+ @about Check system clock is monotonic and its timed wait honors the deadline
+ */
+TEST(SystemClock, WaitFor_Timeout)
+{
+   IClock* clock = GetSystemClock();
+   boost::mutex mutex;
+   boost::condition_variable condition;
+   IClock::Lock lock(mutex);
+
+   TimeUs startTime = clock->GetTime();
+   while (clock->WaitFor(lock, condition, 20000))
+      ;
+   ASSERT_GE(clock->GetTime() - startTime, 20000);
+}
+
+} // namespace test
+} // namespace video_coding
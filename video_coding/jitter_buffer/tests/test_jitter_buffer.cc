@@ -1,11 +1,153 @@
 
 #include "fixture_jitter_buffer.h"
+#include "stubs/stub_streaming_decoder.h"
+#include "stubs/stub_concealing_decoder.h"
+#include "allocation_counter.h"
+#include <video_coding/interface/jitter_buffer_template.h>
 // third-party
+#include <boost/bind.hpp>
 #include <boost/thread.hpp>
+#ifdef __linux__
+#include <sched.h>
+#include <poll.h>
+#endif
 
 namespace
 {
 
+/**
+ * Decoder which passes frames through as is, without virtual methods
+ */
+struct CopyDecoder
+{
+   int DecodeFrame(const char* buffer, int length, char* outputBuffer)
+   {
+      std::copy(buffer, buffer + length, outputBuffer);
+      return length;
+   }
+};
+
+/**
+ * Renderer which collects rendered frames, without virtual methods
+ */
+struct StringRenderer
+{
+   void RenderFrame(const char* buffer, int length)
+   {
+      data.append(buffer, length);
+   }
+
+   std::string data;
+};
+
+/**
+ * Decryptor which expects every fragment to end with a byte derived from its position,
+ * payload is passed through as is
+ */
+class PositionDecryptor : public video_coding::IFragmentDecryptor
+{
+public:
+   static char GetTag(int frameNumber, int fragmentNumber)
+   {
+      return (char)(frameNumber * 16 + fragmentNumber);
+   }
+
+   int GetOverhead() const
+   {
+      return 1;
+   }
+
+   int DecryptFragment(const char* buffer, int length, int frameNumber, int fragmentNumber,
+      char* output)
+   {
+      if (buffer[length - 1] != GetTag(frameNumber, fragmentNumber))
+         return -1;
+      std::copy(buffer, buffer + length - 1, output);
+      return length - 1;
+   }
+};
+
+/**
+ * Helper routine to be run in a separate thread: passes two-fragment frames over the
+ * ingest path once all senders are ready
+ *
+ * @param path - ingest path to pass fragments over
+ * @param barrier - barrier to start together with the other senders
+ * @param frames - number of frames to pass
+ */
+void SendFrames(video_coding::IIngestPath* path, boost::barrier* barrier, const int frames)
+{
+   barrier->wait();
+   for (int i = 0; i < frames; ++i)
+   {
+      const char fragments[] = { (char)('A' + i % 26), (char)('a' + i % 26) };
+      path->TryReceivePacket(&fragments[0], 1, i, 0, 2);
+      path->TryReceivePacket(&fragments[1], 1, i, 1, 2);
+   }
+}
+
+#ifdef __linux__
+/**
+ * Helper routine to check the descriptor is readable, without waiting
+ * @param descriptor - descriptor to check
+ * @returns - true if readable
+ */
+bool IsReadable(const int descriptor)
+{
+   pollfd watch = pollfd();
+   watch.fd = descriptor;
+   watch.events = POLLIN;
+   return ::poll(&watch, 1, 0) == 1 && (watch.revents & POLLIN);
+}
+#endif
+
+/**
+ * JitterBuffer traits which limit frames to two fragments
+ */
+struct TwoFragmentTraits : video_coding::DefaultJitterBufferTraits
+{
+   static const int MaxFragmentsPerFrame = 2;
+};
+
+/**
+ * JitterBuffer threading policy which counts launched worker threads
+ */
+struct CountingThreadingPolicy : video_coding::DefaultThreadingPolicy
+{
+   template <class Function>
+   static Thread* Launch(Function body)
+   {
+      ++launchedThreads;
+      return DefaultThreadingPolicy::Launch(body);
+   }
+
+   static boost::atomic<int> launchedThreads;
+};
+boost::atomic<int> CountingThreadingPolicy::launchedThreads(0);
+
+/**
+ * JitterBuffer storage policy which counts created frames
+ */
+struct CountingStoragePolicy : video_coding::DefaultStoragePolicy
+{
+   static video_coding::FrameBufferPtr CreateFrame(const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const video_coding::FrameInfo& info,
+      bool checksummed,
+      video_coding::IFragmentDecryptor* decryptor)
+   {
+      ++createdFrames;
+      return DefaultStoragePolicy::CreateFrame(buffer, length, frameNumber, fragmentNumber,
+            numFragmentsInThisFrame, info, checksummed, decryptor);
+   }
+
+   static int createdFrames;
+};
+int CountingStoragePolicy::createdFrames = 0;
+
 /**
  *  Data fragmentation routine: divide incoming data into chunked
  *  blocks of given length and package them to output list in the straight order
@@ -41,6 +183,53 @@ std::string GenerateData(const size_t dataSize)
    return tempString;
 }
 
+/**
+ * Helper routine to append checksum trailer to the fragment payload
+ *
+ * @param payload - fragment payload
+ * @returns - fragment to be passed to JB with checksum verification enabled
+ */
+std::string AppendChecksum(const std::string& payload)
+{
+   boost::uint32_t checksum =
+         video_coding::ComputeFragmentChecksum(payload.c_str(), (int)payload.length());
+   std::string fragment(payload);
+   for (int i = 0; i < video_coding::FragmentChecksumSize; ++i)
+      fragment += (char)(checksum >> (8 * i));
+   return fragment;
+}
+
+/**
+ * Helper routine to be run in a separate thread: keeps advancing simulated time
+ * until stop is requested
+ *
+ * @param clock - simulated clock to drive
+ * @param step - time to add at every iteration
+ * @param stopRequested - flag to stop the routine
+ */
+void DriveClock(video_coding::ISimulatedClock* clock, video_coding::TimeUs step, volatile bool* stopRequested)
+{
+   while (!*stopRequested)
+   {
+      clock->AdvanceTime(step);
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+   }
+}
+
+/**
+ * Helper routine to wait until renderer receives expected data
+ *
+ * @param renderer - renderer stub
+ * @param expectedData - data we are waiting for
+ * @returns - false if data is not rendered in 5 seconds
+ */
+bool WaitForRenderedData(video_coding::test::StubRenderer& renderer, const std::string& expectedData)
+{
+   for (int i = 0; i < 5000 && renderer.GetRenderedData() != expectedData; ++i)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+   return renderer.GetRenderedData() == expectedData;
+}
+
 } // unnamed namespace
 
 namespace video_coding
@@ -92,7 +281,7 @@ TEST_F(FixtureJitterBuffer, Initialization_CheckCorrectArguments)
  */
 TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_ZeroBuffer)
 {
-   result_t code = CheckReceiverFunction(0, 1, 1, 1, 1);
+   result_t code = CheckReceiverFunction(0, 1, 1, 0, 1);
    ASSERT_EQ(result_code::eInvalidArgument, code);
 }
 
@@ -101,7 +290,7 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_ZeroBuffer)
  */
 TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_ZeroBufferLength)
 {
-   result_t code = CheckReceiverFunction((char*)1, 0, 1, 1, 1);
+   result_t code = CheckReceiverFunction((char*)1, 0, 1, 0, 1);
    ASSERT_EQ(result_code::eInvalidArgument, code);
 }
 
@@ -110,7 +299,7 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_ZeroBufferLength)
  */
 TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_NegativeFrameNumber)
 {
-   result_t code = CheckReceiverFunction((char*)1, 1, -1, 1, 1);
+   result_t code = CheckReceiverFunction((char*)1, 1, -1, 0, 1);
    ASSERT_EQ(result_code::eInvalidArgument, code);
 }
 
@@ -128,10 +317,37 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_NegativeFragmentNumber)
  */
 TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_ZeroFragmentCount)
 {
-   result_t code = CheckReceiverFunction((char*)1, 1, 1, 1, 0);
+   result_t code = CheckReceiverFunction((char*)1, 1, 1, 0, 0);
    ASSERT_EQ(result_code::eInvalidArgument, code);
 }
 
+/*
+ @about Check call to ReceivePacket fails if fragment number is out of the frame
+ */
+TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_FragmentNumberOutOfRange)
+{
+   ASSERT_EQ(result_code::eInvalidArgument, CheckReceiverFunction((char*)1, 1, 1, 1, 1));
+   ASSERT_EQ(result_code::eInvalidArgument, CheckReceiverFunction((char*)1, 1, 1, 5, 2));
+}
+
+/*
+ @about Check JitterBuffer created by the factory rejects frames of more fragments
+ than the default traits allow
+ */
+TEST_F(FixtureJitterBuffer, ReceivePacket_InvalidArgs_TooManyFragments)
+{
+   const int maxFragments = DefaultJitterBufferTraits::MaxFragmentsPerFrame;
+   JitterBufferPtr jitterBuffer = GetJB();
+   ASSERT_EQ(result_code::eInvalidArgument,
+         jitterBuffer->TryReceivePacket("a", 1, 0, 0, maxFragments + 1));
+   ASSERT_EQ(result_code::eInvalidArgument,
+         jitterBuffer->TryReceivePacket("a", 1, 0, maxFragments, maxFragments + 1));
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().invalidPackets);
+
+   ASSERT_EQ(result_code::sOk,
+         jitterBuffer->TryReceivePacket("a", 1, 0, maxFragments - 1, maxFragments));
+}
+
 /*
  @about Check that single frame chunked into pieces and delivered to the
  component in the normal (forward) order will be assembled properly
@@ -150,7 +366,7 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_SingleChunkedFrame_ForwardOrder)
       jitterBuffer->ReceivePacket(chunkedData[i].c_str(), chunkedData[i].length(), 0, i, chunkedData.size());
    }
 
-   boost::this_thread::sleep(boost::posix_time::seconds(5));
+   jitterBuffer->Flush();
    ASSERT_EQ(tempString, GetRenderer()->GetRenderedData());
 }
 
@@ -174,10 +390,40 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_SingleChunkedFrame_ReverseOrder)
             0, i, chunkedData.size());
    }
 
-   boost::this_thread::sleep(boost::posix_time::seconds(5));
+   jitterBuffer->Flush();
    ASSERT_EQ(tempString, GetRenderer()->GetRenderedData());
 }
 
+/*
+ @about Check that frames of more fragments than fragment metadata is allocated for
+ up front are assembled properly from in-order, reverse and interleaved fragments
+ */
+TEST_F(FixtureJitterBuffer, ReceivePacket_ManyFragments_MetadataGrows)
+{
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   // one byte fragments, about three times MaxInitialMetadataCapacity
+   const int frameSize = 3000;
+   std::string tempString = GenerateData(frameSize);
+   std::vector<std::string> chunkedData;
+   FragmentData(tempString, 1, chunkedData);
+   const int numFragments = (int)chunkedData.size();
+
+   for (int i = 0; i < numFragments; ++i)
+      jitterBuffer->ReceivePacket(chunkedData[i].c_str(), 1, 0, i, numFragments);
+   for (int i = numFragments - 1; i >= 0; --i)
+      jitterBuffer->ReceivePacket(chunkedData[i].c_str(), 1, 1, i, numFragments);
+   // even fragments ascending, then odd ones descending into the gaps
+   for (int i = 0; i < numFragments; i += 2)
+      jitterBuffer->ReceivePacket(chunkedData[i].c_str(), 1, 2, i, numFragments);
+   for (int i = numFragments - 1 - numFragments % 2; i > 0; i -= 2)
+      jitterBuffer->ReceivePacket(chunkedData[i].c_str(), 1, 2, i, numFragments);
+
+   jitterBuffer->Flush();
+   ASSERT_EQ(tempString + tempString + tempString, GetRenderer()->GetRenderedData());
+   ASSERT_EQ((boost::uint64_t)numFragments * 3, jitterBuffer->GetStatistics().receivedFragments);
+}
+
 /*
  @about Check that multiple frames, each of 1 fragment only, delivered to the
  component in the normal (forward) order, will be assembled properly
@@ -196,7 +442,7 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_MultipleFrames_NoChunks_ForwardOrder)
       resultingString += tempString;
    }
 
-   boost::this_thread::sleep(boost::posix_time::seconds(5));
+   jitterBuffer->Flush();
    ASSERT_EQ(resultingString, GetRenderer()->GetRenderedData());
 }
 
@@ -218,7 +464,7 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_MultipleFrames_NoChunks_ReverseOrder)
       resultingString += tempString;
    }
 
-   boost::this_thread::sleep(boost::posix_time::seconds(5));
+   jitterBuffer->Flush();
    ASSERT_EQ(resultingString, GetRenderer()->GetRenderedData());
 }
 
@@ -247,7 +493,7 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_MultipleFrames_Chunked_ForwardOrder)
       }
    }
 
-   boost::this_thread::sleep(boost::posix_time::seconds(5));
+   jitterBuffer->Flush();
    ASSERT_EQ(resultingString, GetRenderer()->GetRenderedData());
 }
 
@@ -276,11 +522,844 @@ TEST_F(FixtureJitterBuffer, ReceivePacket_MultipleFrames_Chunked_ReverseOrder)
       }
    }
 
-   boost::this_thread::sleep(boost::posix_time::seconds(5));
+   jitterBuffer->Flush();
+   ASSERT_EQ(resultingString, GetRenderer()->GetRenderedData());
+}
+
+/*
+ @about Check that frames large enough to be assembled bypassing the cache are
+ assembled properly both from in-order and out-of-order fragments of odd size
+ */
+TEST_F(FixtureJitterBuffer, ReceivePacket_LargeFrames_ForwardAndReverseOrder)
+{
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   const int chunkSize = 1399;
+   const int frameSize = 600 * 1024;
+   std::string tempString = GenerateData(frameSize);
+   std::vector<std::string> chunkedData;
+   FragmentData(tempString, chunkSize, chunkedData);
+
+   for (size_t k = 0; k < chunkedData.size(); ++k)
+   {
+      jitterBuffer->ReceivePacket(chunkedData[k].c_str(), chunkedData[k].length(),
+            0, k, chunkedData.size());
+   }
+   for (int k = chunkedData.size()-1; k >= 0; --k)
+   {
+      jitterBuffer->ReceivePacket(chunkedData[k].c_str(), chunkedData[k].length(),
+            1, k, chunkedData.size());
+   }
+
+   jitterBuffer->Flush();
+   ASSERT_EQ(tempString + tempString, GetRenderer()->GetRenderedData());
+}
+
+/*
+ @about Check Flush doesn't wait for frames stuck behind incomplete one and
+ renders them as soon as the gap is filled
+ */
+TEST_F(FixtureJitterBuffer, Flush_GapInSequence)
+{
+   JitterBufferPtr jitterBuffer = GetJB();
+   std::string tempString = GenerateData(10);
+
+   jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), 1, 0, 1);
+   jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), 2, 0, 1);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string(), GetRenderer()->GetRenderedData());
+
+   jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), 0, 0, 1);
+   jitterBuffer->Flush();
+   ASSERT_EQ(tempString + tempString + tempString, GetRenderer()->GetRenderedData());
+}
+
+/*
+ @about Check Drain reports timeout measured by JB clock if frame is still being
+ rendered, and succeeds once rendering is done
+ */
+TEST_F(FixtureJitterBuffer, Drain_TimeoutOnSimulatedClock)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   std::string tempString = GenerateData(10);
+   GetRenderer()->SetBlocked(true);
+   jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), 0, 0, 1);
+
+   volatile bool stopRequested = false;
+   boost::thread clockDriver(boost::bind(DriveClock, clock.get(), 1000, &stopRequested));
+   result_t code = jitterBuffer->Drain(10000);
+   stopRequested = true;
+   clockDriver.join();
+   ASSERT_EQ(result_code::eNotReady, code);
+
+   GetRenderer()->SetBlocked(false);
+   jitterBuffer->Flush();
+   ASSERT_EQ(result_code::sOk, jitterBuffer->Drain(0));
+   ASSERT_EQ(tempString, GetRenderer()->GetRenderedData());
+}
+
+/*
+ @about Check completed frames are rendered before JB destruction is finished
+ */
+TEST_F(FixtureJitterBuffer, Destructor_DrainsCompletedFrames)
+{
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   const int frameCount = MaxFrameNumber - 1;
+   std::string tempString = GenerateData(frameCount);
+   std::string resultingString;
+   for (int i = 0; i < frameCount; ++i)
+   {
+      jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), i, 0, 1);
+      resultingString += tempString;
+   }
+   // incomplete frame is purged
+   jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), frameCount, 0, 2);
+
+   jitterBuffer.reset();
+   ReleaseJB();
    ASSERT_EQ(resultingString, GetRenderer()->GetRenderedData());
 }
 
+/*
+ @about Check TryReceivePacket reports rejections by result code and counts them
+ */
+TEST_F(FixtureJitterBuffer, TryReceivePacket_RejectionsAreCounted)
+{
+   JitterBufferPtr jitterBuffer = GetJB();
+   std::string tempString = GenerateData(10);
+
+   ASSERT_EQ(result_code::eInvalidArgument, jitterBuffer->TryReceivePacket(0, 10, 0, 0, 1));
+   ASSERT_EQ(result_code::eInvalidArgument,
+         jitterBuffer->TryReceivePacket(tempString.c_str(), tempString.length(), 0, 0, 0));
+
+   // frame #0 is never completed, so every next frame stays in JB
+   for (int i = 0; i <= MaxFrameNumber; ++i)
+   {
+      ASSERT_EQ(result_code::sOk,
+            jitterBuffer->TryReceivePacket(tempString.c_str(), tempString.length(), i, 0, 2));
+   }
+   ASSERT_EQ(result_code::eOutOfSpace,
+         jitterBuffer->TryReceivePacket(tempString.c_str(), tempString.length(), MaxFrameNumber + 1, 0, 2));
+
+   // fragments of already stored frames are still accepted
+   ASSERT_EQ(result_code::sOk,
+         jitterBuffer->TryReceivePacket(tempString.c_str(), tempString.length(), 0, 0, 2));
+   ASSERT_EQ(result_code::sOk,
+         jitterBuffer->TryReceivePacket(tempString.c_str(), tempString.length(), 0, 1, 2));
+   jitterBuffer->Flush();
+   ASSERT_EQ(result_code::sOk,
+         jitterBuffer->TryReceivePacket(tempString.c_str(), tempString.length(), 0, 1, 2));
+
+   JitterBufferStatistics statistics = jitterBuffer->GetStatistics();
+   ASSERT_EQ(2u, statistics.invalidPackets);
+   ASSERT_EQ(1u, statistics.overflowPackets);
+   ASSERT_EQ(1u, statistics.duplicateFragments);
+   ASSERT_EQ(1u, statistics.lateFragments);
+   ASSERT_EQ((boost::uint64_t)MaxFrameNumber + 2, statistics.receivedFragments);
+   ASSERT_EQ(1u, statistics.renderedFrames);
+   ASSERT_EQ(0u, statistics.failedPackets);
+}
+
+/*
+ @about Check non-reference frames and reference chains up to the next key frame
+ are shed when decode queue is too deep
+ */
+TEST_F(FixtureJitterBuffer, Shedding_DropsToNextKeyFrame)
+{
+   JitterBufferOptions options;
+   options.sheddingQueueDepth = 2;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   FrameInfo keyFrame;
+   keyFrame.type = KeyFrame;
+   FrameInfo nonReferenceFrame;
+   nonReferenceFrame.type = NonReferenceFrame;
+
+   // hold decoder thread on rendering of the first frame
+   GetRenderer()->SetBlocked(true);
+   jitterBuffer->ReceivePacket("0", 1, 0, 0, 1, keyFrame);
+   GetRenderer()->WaitForBlockedCall();
+
+   jitterBuffer->ReceivePacket("1", 1, 1, 0, 1);
+   jitterBuffer->ReceivePacket("2", 1, 2, 0, 1, nonReferenceFrame);
+   jitterBuffer->ReceivePacket("3", 1, 3, 0, 1);
+   jitterBuffer->ReceivePacket("4", 1, 4, 0, 1, nonReferenceFrame);
+   jitterBuffer->ReceivePacket("5", 1, 5, 0, 1, keyFrame);
+   jitterBuffer->ReceivePacket("6", 1, 6, 0, 1, nonReferenceFrame);
+   while (jitterBuffer->GetStatistics().decodeQueueDepth < 6)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+   GetRenderer()->SetBlocked(false);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("056"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(4u, jitterBuffer->GetStatistics().shedFrames);
+}
+
+/*
+ @about Check the oldest frames are dropped once decode queue is over capacity
+ */
+TEST_F(FixtureJitterBuffer, DecodeQueue_DropOldest)
+{
+   JitterBufferOptions options;
+   options.decodeQueueCapacity = 2;
+   options.backpressurePolicy = DropOldest;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   GetRenderer()->SetBlocked(true);
+   jitterBuffer->ReceivePacket("0", 1, 0, 0, 1);
+   GetRenderer()->WaitForBlockedCall();
+
+   jitterBuffer->ReceivePacket("1", 1, 1, 0, 1);
+   jitterBuffer->ReceivePacket("2", 1, 2, 0, 1);
+   jitterBuffer->ReceivePacket("3", 1, 3, 0, 1);
+   jitterBuffer->ReceivePacket("4", 1, 4, 0, 1);
+   jitterBuffer->ReceivePacket("5", 1, 5, 0, 1);
+   while (jitterBuffer->GetStatistics().droppedFrames < 3)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().decodeQueueDepth);
+
+   GetRenderer()->SetBlocked(false);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("045"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(3u, jitterBuffer->GetStatistics().droppedFrames);
+}
+
+/*
+ @about Check new frames are rejected while decode queue lag is over latency target
+ and accepted again once decoder catches up
+ */
+TEST_F(FixtureJitterBuffer, DecodeQueue_LatencyTargetSignalsProducer)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   options.latencyTarget = 50000;
+   options.backpressurePolicy = SignalProducer;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   GetRenderer()->SetBlocked(true);
+   jitterBuffer->ReceivePacket("0", 1, 0, 0, 1);
+   GetRenderer()->WaitForBlockedCall();
+   jitterBuffer->ReceivePacket("1", 1, 1, 0, 1);
+   while (jitterBuffer->GetStatistics().decodeQueueDepth < 1)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+   clock->AdvanceTime(100000);
+   ASSERT_EQ(100000, jitterBuffer->GetStatistics().decodeQueueLag);
+   ASSERT_EQ(result_code::eOutOfSpace, jitterBuffer->TryReceivePacket("2", 1, 2, 0, 1));
+
+   GetRenderer()->SetBlocked(false);
+   jitterBuffer->Flush();
+   ASSERT_EQ(0, jitterBuffer->GetStatistics().decodeQueueLag);
+   ASSERT_EQ(result_code::sOk, jitterBuffer->TryReceivePacket("2", 1, 2, 0, 1));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("012"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(0u, jitterBuffer->GetStatistics().droppedFrames);
+}
+
+/*
+ @about Check render pacing releases a burst of frames at configured frame rate
+ measured by JB clock
+ */
+TEST_F(FixtureJitterBuffer, RenderPacing_FrameRate)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   options.renderFrameRate = 10;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   jitterBuffer->ReceivePacket("0", 1, 0, 0, 1);
+   jitterBuffer->ReceivePacket("1", 1, 1, 0, 1);
+   jitterBuffer->ReceivePacket("2", 1, 2, 0, 1);
+   ASSERT_TRUE(WaitForRenderedData(*GetRenderer(), "0"));
+
+   clock->AdvanceTime(99999);
+   ASSERT_EQ(result_code::eNotReady, jitterBuffer->Drain(0));
+   ASSERT_EQ(std::string("0"), GetRenderer()->GetRenderedData());
+
+   clock->AdvanceTime(1);
+   ASSERT_TRUE(WaitForRenderedData(*GetRenderer(), "01"));
+   clock->AdvanceTime(100000);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("012"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(0u, jitterBuffer->GetStatistics().skippedFrames);
+}
+
+/*
+ @about Check render pacing follows frame timestamps and skips frames which are
+ late by more than one frame interval
+ */
+TEST_F(FixtureJitterBuffer, RenderPacing_SkipsStaleFrames)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   options.renderFrameRate = 25;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   FrameInfo info;
+   info.timestamp = 0;
+   jitterBuffer->ReceivePacket("0", 1, 0, 0, 1, info);
+   ASSERT_TRUE(WaitForRenderedData(*GetRenderer(), "0"));
+
+   // frames are due at 100ms, 200ms and 300ms, the first two are stale by 350ms
+   clock->AdvanceTime(350000);
+   info.timestamp = 300000;
+   jitterBuffer->ReceivePacket("3", 1, 3, 0, 1, info);
+   info.timestamp = 200000;
+   jitterBuffer->ReceivePacket("2", 1, 2, 0, 1, info);
+   info.timestamp = 100000;
+   jitterBuffer->ReceivePacket("1", 1, 1, 0, 1, info);
+
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("03"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().skippedFrames);
+}
+
+/*
+ @about Check contiguous leading fragments are passed to streaming decoder before
+ the frame is complete, and out-of-order fragments wait for the gap to be filled
+ */
+TEST_F(FixtureJitterBuffer, StreamingDecode_ContiguousPrefix)
+{
+   StubStreamingDecoder decoder;
+   JitterBufferOptions options;
+   options.streamingDecode = true;
+   JitterBufferPtr jitterBuffer = CreateJitterBuffer(&decoder, GetRenderer().get(), options);
+
+   jitterBuffer->ReceivePacket("ab", 2, 0, 0, 4);
+   jitterBuffer->ReceivePacket("ef", 2, 0, 2, 4);
+   for (int i = 0; i < 5000 && decoder.GetFrameData() != "ab"; ++i)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+   ASSERT_EQ(std::string("ab"), decoder.GetFrameData());
+
+   jitterBuffer->ReceivePacket("cd", 2, 0, 1, 4);
+   for (int i = 0; i < 5000 && decoder.GetFrameData() != "abcdef"; ++i)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+   ASSERT_EQ(std::string("abcdef"), decoder.GetFrameData());
+   ASSERT_EQ(std::string(), GetRenderer()->GetRenderedData());
+
+   jitterBuffer->ReceivePacket("gh", 2, 0, 3, 4);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("abcdefgh"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(1u, jitterBuffer->GetStatistics().streamedFrames);
+   ASSERT_LE(2, decoder.GetPartCount());
+
+   // incomplete streamed frame is aborted on shutdown
+   jitterBuffer->ReceivePacket("ij", 2, 1, 0, 2);
+   for (int i = 0; i < 5000 && decoder.GetFrameData() != "ij"; ++i)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+   jitterBuffer.reset();
+   ASSERT_EQ(1, decoder.GetAbortCount());
+}
+
+/*
+ @about Check streaming decode requires decoder with streaming support
+ */
+TEST_F(FixtureJitterBuffer, StreamingDecode_RequiresStreamingDecoder)
+{
+   JitterBufferOptions options;
+   options.streamingDecode = true;
+   ASSERT_EQ(result_code::eInvalidArgument, CreateJB(options));
+}
+
+/*
+ @about Check complete independent frames waiting behind an incomplete frame are
+ decoded ahead and rendered in order once the gap is filled, and other frames
+ (key frames included) wait for their turn
+ */
+TEST_F(FixtureJitterBuffer, DecodeAhead_IndependentFramesRenderedInOrder)
+{
+   JitterBufferOptions options;
+   options.decodeAhead = true;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   FrameInfo keyFrame;
+   keyFrame.type = KeyFrame;
+   FrameInfo independentFrame;
+   independentFrame.type = KeyFrame;
+   independentFrame.independent = true;
+   jitterBuffer->ReceivePacket("a", 1, 0, 0, 2, independentFrame);
+   jitterBuffer->ReceivePacket("c", 1, 1, 0, 1, keyFrame);
+   jitterBuffer->ReceivePacket("d", 1, 2, 0, 1, independentFrame);
+   jitterBuffer->ReceivePacket("e", 1, 3, 0, 1);
+   jitterBuffer->ReceivePacket("f", 1, 4, 0, 1, independentFrame);
+   for (int i = 0; i < 5000 && jitterBuffer->GetStatistics().decodedAheadFrames < 2; ++i)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+   boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().decodedAheadFrames);
+   ASSERT_EQ(std::string(), GetRenderer()->GetRenderedData());
+
+   jitterBuffer->ReceivePacket("b", 1, 0, 1, 2, independentFrame);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("abcdef"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().decodedAheadFrames);
+}
+
+/*
+ @about Check incomplete frame is passed to concealing decoder at deadline together
+ with the map of received fragments
+ */
+TEST_F(FixtureJitterBuffer, FrameDeadline_ConcealsIncompleteFrame)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   StubConcealingDecoder decoder;
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   options.frameDeadline = 50000;
+   options.decodeIncompleteFrames = true;
+   JitterBufferPtr jitterBuffer = CreateJitterBuffer(&decoder, GetRenderer().get(), options);
+
+   jitterBuffer->ReceivePacket("ab", 2, 0, 0, 3);
+   jitterBuffer->ReceivePacket("ef", 2, 0, 2, 3);
+   jitterBuffer->ReceivePacket("g", 1, 1, 0, 1);
+   clock->AdvanceTime(49999);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string(), GetRenderer()->GetRenderedData());
+
+   clock->AdvanceTime(1);
+   ASSERT_TRUE(WaitForRenderedData(*GetRenderer(), "ab?efg"));
+   ASSERT_EQ(1u, jitterBuffer->GetStatistics().concealedFrames);
+   ASSERT_EQ(0u, jitterBuffer->GetStatistics().expiredFrames);
+}
+
+/*
+ @about Check missing and incomplete frames are skipped at deadline if decoder
+ can't conceal them
+ */
+TEST_F(FixtureJitterBuffer, FrameDeadline_SkipsMissingFrames)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   options.frameDeadline = 50000;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+
+   // frame #0 never arrives, frame #1 is incomplete
+   jitterBuffer->ReceivePacket("a", 1, 1, 0, 2);
+   jitterBuffer->ReceivePacket("c", 1, 2, 0, 1);
+   clock->AdvanceTime(50000);
+   ASSERT_TRUE(WaitForRenderedData(*GetRenderer(), "c"));
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().expiredFrames);
+
+   // fragments of skipped frames are late
+   jitterBuffer->ReceivePacket("b", 1, 1, 1, 2);
+   ASSERT_EQ(1u, jitterBuffer->GetStatistics().lateFragments);
+}
+
+/*
+ @about Check the first copy of every fragment received over redundant paths is
+ used and the late copy is dropped and counted with its lag
+ */
+TEST_F(FixtureJitterBuffer, RedundantIngest_FirstArrivalWins)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+   boost::shared_ptr<IIngestPath> pathA = jitterBuffer->CreateIngestPath();
+   boost::shared_ptr<IIngestPath> pathB = jitterBuffer->CreateIngestPath();
+
+   ASSERT_EQ(result_code::sOk, pathA->TryReceivePacket("ab", 2, 0, 0, 2));
+   clock->AdvanceTime(3000);
+   ASSERT_EQ(result_code::sOk, pathB->TryReceivePacket("xx", 2, 0, 0, 2));
+   // fragment #1 is lost on path A
+   ASSERT_EQ(result_code::sOk, pathB->TryReceivePacket("cd", 2, 0, 1, 2));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("abcd"), GetRenderer()->GetRenderedData());
+
+   IngestPathStatistics statisticsA = pathA->GetStatistics();
+   ASSERT_EQ(1u, statisticsA.firstArrivals);
+   ASSERT_EQ(0u, statisticsA.duplicatePackets);
+   ASSERT_EQ(1u, statisticsA.lostPackets);
+   ASSERT_EQ(0, statisticsA.averageLag);
+
+   IngestPathStatistics statisticsB = pathB->GetStatistics();
+   ASSERT_EQ(2u, statisticsB.receivedPackets);
+   ASSERT_EQ(1u, statisticsB.firstArrivals);
+   ASSERT_EQ(1u, statisticsB.duplicatePackets);
+   ASSERT_EQ(0u, statisticsB.lostPackets);
+   ASSERT_EQ(3000, statisticsB.averageLag);
+   ASSERT_EQ(3000, statisticsB.maxLag);
+
+   // redundant copies never reach JB
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().receivedFragments);
+   ASSERT_EQ(0u, jitterBuffer->GetStatistics().duplicateFragments);
+}
+
+/*
+ @about Check redundant ingest paths driven from their own threads from the very first
+ fragment launch worker threads once and deliver every frame
+ */
+TEST_F(FixtureJitterBuffer, RedundantIngest_ConcurrentPaths)
+{
+   const int frames = 20;
+   std::string expectedData;
+   for (int i = 0; i < frames; ++i)
+   {
+      expectedData += (char)('A' + i % 26);
+      expectedData += (char)('a' + i % 26);
+   }
+
+   for (int attempt = 0; attempt < 50; ++attempt)
+   {
+      StubRenderer renderer;
+      JitterBufferPtr jitterBuffer = CreateJitterBuffer(GetDecoder().get(), &renderer);
+      boost::shared_ptr<IIngestPath> pathA = jitterBuffer->CreateIngestPath();
+      boost::shared_ptr<IIngestPath> pathB = jitterBuffer->CreateIngestPath();
+
+      boost::barrier barrier(2);
+      boost::thread senderA(boost::bind(&SendFrames, pathA.get(), &barrier, frames));
+      boost::thread senderB(boost::bind(&SendFrames, pathB.get(), &barrier, frames));
+      senderA.join();
+      senderB.join();
+
+      jitterBuffer->Flush();
+      ASSERT_EQ(expectedData, renderer.GetRenderedData());
+      ASSERT_EQ((size_t)(frames * 2), jitterBuffer->GetStatistics().receivedFragments);
+   }
+}
+
+/*
+ @about Check fragments with mismatching checksum are dropped and counted, don't
+ shadow good redundant copies, and checksum trailer doesn't reach decoder
+ */
+TEST_F(FixtureJitterBuffer, FragmentChecksum_CorruptFragmentsDropped)
+{
+   // CRC32C check value
+   ASSERT_EQ(0xE3069283u, ComputeFragmentChecksum("123456789", 9));
+
+   JitterBufferOptions options;
+   options.verifyFragmentChecksum = true;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+   boost::shared_ptr<IIngestPath> pathA = jitterBuffer->CreateIngestPath();
+   boost::shared_ptr<IIngestPath> pathB = jitterBuffer->CreateIngestPath();
+
+   std::string corrupted = AppendChecksum("ab");
+   corrupted[0] ^= 1;
+   ASSERT_EQ(result_code::eInvalidArgument, pathA->TryReceivePacket(corrupted.c_str(),
+         (int)corrupted.length(), 0, 0, 2));
+   std::string fragment = AppendChecksum("ab");
+   ASSERT_EQ(result_code::sOk, pathB->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 0, 2));
+
+   corrupted = AppendChecksum("cd");
+   corrupted[2] ^= 0x80;
+   ASSERT_EQ(result_code::eInvalidArgument, pathA->TryReceivePacket(corrupted.c_str(),
+         (int)corrupted.length(), 0, 1, 2));
+   fragment = AppendChecksum("cd");
+   ASSERT_EQ(result_code::sOk, pathB->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 1, 2));
+
+   // too short to hold the trailer
+   ASSERT_EQ(result_code::eInvalidArgument, jitterBuffer->TryReceivePacket("abcd", 4, 1, 0, 1));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("abcd"), GetRenderer()->GetRenderedData());
+
+   JitterBufferStatistics statistics = jitterBuffer->GetStatistics();
+   ASSERT_EQ(2u, statistics.receivedFragments);
+   ASSERT_EQ(2u, statistics.corruptFragments);
+   ASSERT_EQ(1u, statistics.invalidPackets);
+}
+
+/*
+ @about Check fragments are decrypted into the frame, and the ones that fail
+ authentication are dropped and counted without shadowing good redundant copies
+ */
+TEST_F(FixtureJitterBuffer, Decryptor_FailedFragmentsDropped)
+{
+   PositionDecryptor decryptor;
+   JitterBufferOptions options;
+   options.decryptor = &decryptor;
+   options.verifyFragmentChecksum = true;
+   ASSERT_EQ(result_code::eInvalidArgument, CreateJB(options));
+   options.verifyFragmentChecksum = false;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+   boost::shared_ptr<IIngestPath> pathA = jitterBuffer->CreateIngestPath();
+   boost::shared_ptr<IIngestPath> pathB = jitterBuffer->CreateIngestPath();
+
+   // fragment replayed at another position
+   std::string fragment = std::string("cd") + PositionDecryptor::GetTag(0, 1);
+   ASSERT_EQ(result_code::eInvalidArgument, pathA->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 0, 2));
+   ASSERT_EQ(result_code::sOk, pathB->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 1, 2));
+   fragment = std::string("ab") + PositionDecryptor::GetTag(0, 1);
+   ASSERT_EQ(result_code::eInvalidArgument, pathA->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 0, 2));
+   fragment = std::string("ab") + PositionDecryptor::GetTag(0, 0);
+   ASSERT_EQ(result_code::sOk, pathB->TryReceivePacket(fragment.c_str(),
+         (int)fragment.length(), 0, 0, 2));
+
+   // too short to hold any payload
+   ASSERT_EQ(result_code::eInvalidArgument, jitterBuffer->TryReceivePacket("a", 1, 1, 0, 1));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("abcd"), GetRenderer()->GetRenderedData());
+
+   JitterBufferStatistics statistics = jitterBuffer->GetStatistics();
+   ASSERT_EQ(2u, statistics.receivedFragments);
+   ASSERT_EQ(2u, statistics.corruptFragments);
+   ASSERT_EQ(1u, statistics.invalidPackets);
+}
+
+/*
+ @about Check frames are processed the same way when worker threads spin instead
+ of blocking
+ */
+TEST_F(FixtureJitterBuffer, WaitStrategy_SpinningWorkers)
+{
+   const WaitStrategy strategies[] = { BusySpinWait, SpinThenParkWait };
+   for (size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); ++i)
+   {
+      StubRenderer renderer;
+      JitterBufferOptions options;
+      options.waitStrategy = strategies[i];
+      options.spinTime = 10;
+      JitterBufferPtr jitterBuffer = CreateJitterBuffer(GetDecoder().get(), &renderer, options);
+
+      jitterBuffer->ReceivePacket("b", 1, 1, 0, 1);
+      jitterBuffer->ReceivePacket("a", 1, 0, 0, 1);
+      // let spinning workers expire and park before the next frame
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(5));
+      jitterBuffer->ReceivePacket("c", 1, 2, 0, 1);
+      jitterBuffer->Flush();
+      ASSERT_EQ(std::string("abc"), renderer.GetRenderedData());
+   }
+}
+
+/*
+ @about Check frames move from reassembly through the decode queue to decoder,
+ and through render queue with render pacing, without allocations: a frame costs
+ its own storage only
+ */
+TEST_F(FixtureJitterBuffer, FrameOwnership_NoAllocationPerPipelineHop)
+{
+   // frame record, fragment metadata block and payload arena
+   const boost::uint64_t FrameStorageAllocations = 3;
+   const int FrameCount = 50;
+
+   /// renderer which keeps nothing, so that it doesn't allocate either
+   class NullRenderer : public ::video_engine::IRenderer
+   {
+   public:
+      virtual void RenderFrame(const char*, int) {}
+   } renderer;
+   std::string tempString = GenerateData(100);
+
+   const double renderFrameRates[] = { 0, 10000 };
+   for (size_t rate = 0; rate < sizeof(renderFrameRates) / sizeof(renderFrameRates[0]); ++rate)
+   {
+      JitterBufferOptions options;
+      options.renderFrameRate = renderFrameRates[rate];
+      JitterBufferPtr jitterBuffer = CreateJitterBuffer(GetDecoder().get(), &renderer, options);
+
+      // threads and decoder buffers are set up with the first frame
+      jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), 0, 0, 1);
+      jitterBuffer->Flush();
+
+      boost::uint64_t allocationCount = GetAllocationCount();
+      for (int i = 1; i <= FrameCount; ++i)
+         jitterBuffer->ReceivePacket(tempString.c_str(), tempString.length(), i, 0, 1);
+      jitterBuffer->Flush();
+      allocationCount = GetAllocationCount() - allocationCount;
+
+      // paced frames may be skipped if render thread falls behind
+      JitterBufferStatistics statistics = jitterBuffer->GetStatistics();
+      ASSERT_EQ((boost::uint64_t)FrameCount + 1,
+            statistics.renderedFrames + statistics.skippedFrames);
+      ASSERT_LE(allocationCount, FrameCount * FrameStorageAllocations) << "rate " <<
+            renderFrameRates[rate];
+   }
+}
+
+/*
+ @about Check JitterBuffer template works with decoder and renderer which do not
+ implement IDecoder and IRenderer, and honors compile-time limits of its traits
+ */
+TEST_F(FixtureJitterBuffer, Template_ConcreteDecoderAndRenderer)
+{
+   CopyDecoder decoder;
+   StringRenderer renderer;
+   {
+      JitterBuffer<CopyDecoder, StringRenderer, TwoFragmentTraits> jitterBuffer(&decoder, &renderer);
+      jitterBuffer.ReceivePacket("b", 1, 1, 0, 1);
+      jitterBuffer.ReceivePacket("a", 1, 0, 1, 2);
+      jitterBuffer.ReceivePacket("a", 1, 0, 0, 2);
+      ASSERT_EQ(result_code::eInvalidArgument, jitterBuffer.TryReceivePacket("c", 1, 2, 0, 3));
+      jitterBuffer.Flush();
+      ASSERT_EQ(1u, jitterBuffer.GetStatistics().invalidPackets);
+   }
+   ASSERT_EQ(std::string("aab"), renderer.data);
 
+   // optional decoder interfaces can't be queried from a non-polymorphic decoder
+   JitterBufferOptions options;
+   options.streamingDecode = true;
+   ASSERT_THROW((JitterBuffer<CopyDecoder, StringRenderer>(&decoder, &renderer, options)),
+         std::exception);
+}
 
+/*
+ @about Check JitterBuffer template launches worker threads through its threading
+ policy and creates frames through its storage policy
+ */
+TEST_F(FixtureJitterBuffer, Template_ThreadingAndStoragePolicies)
+{
+   CopyDecoder decoder;
+   StringRenderer renderer;
+   CountingThreadingPolicy::launchedThreads = 0;
+   CountingStoragePolicy::createdFrames = 0;
+   {
+      JitterBufferOptions options;
+      options.renderFrameRate = 10000;
+      JitterBuffer<CopyDecoder, StringRenderer, DefaultJitterBufferTraits,
+            CountingThreadingPolicy, CountingStoragePolicy> jitterBuffer(&decoder, &renderer, options);
+      jitterBuffer.ReceivePacket("a", 1, 0, 0, 2);
+      jitterBuffer.ReceivePacket("a", 1, 0, 1, 2);
+      jitterBuffer.ReceivePacket("b", 1, 1, 0, 1);
+      jitterBuffer.Flush();
+   }
+   ASSERT_EQ(std::string("aab"), renderer.data);
+   // recycler, decoder and render threads
+   ASSERT_EQ(3, CountingThreadingPolicy::launchedThreads.load());
+   ASSERT_EQ(2, CountingStoragePolicy::createdFrames);
 }
+
+#ifdef __linux__
+/*
+ @about Check worker threads are pinned to the requested CPU and report it in
+ statistics, and invalid CPU numbers are rejected
+ */
+TEST_F(FixtureJitterBuffer, ThreadPlacement_PinsWorkers)
+{
+   JitterBufferOptions options;
+   options.recyclerPlacement.cpus.push_back(-1);
+   ASSERT_EQ(result_code::eInvalidArgument, CreateJB(options));
+
+   // the CPU test runs on is certainly allowed for the process
+   const int cpu = ::sched_getcpu();
+   options.recyclerPlacement.cpus.assign(1, cpu);
+   options.decoderPlacement.cpus.assign(1, cpu);
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+   ASSERT_EQ(-1, jitterBuffer->GetStatistics().decoderCpu);
+
+   jitterBuffer->ReceivePacket("a", 1, 0, 0, 1);
+   jitterBuffer->ReceivePacket("b", 1, 1, 0, 1);
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("ab"), GetRenderer()->GetRenderedData());
+
+   JitterBufferStatistics statistics = jitterBuffer->GetStatistics();
+   ASSERT_EQ(cpu, statistics.recyclerCpu);
+   ASSERT_EQ(cpu, statistics.decoderCpu);
+   ASSERT_EQ(-1, statistics.renderCpu);
 }
+
+/*
+ @about Check frames are taken in pull mode on the calling thread one at a time, and
+ readiness descriptor is readable exactly while there is a frame to take
+ */
+TEST_F(FixtureJitterBuffer, PullMode_ReadinessDescriptor)
+{
+   JitterBufferOptions options;
+   options.pullMode = true;
+   options.renderFrameRate = 25;
+   ASSERT_EQ(result_code::eInvalidArgument, CreateJB(options));
+   options.renderFrameRate = 0;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+   const int descriptor = jitterBuffer->GetReadinessDescriptor();
+   ASSERT_LE(0, descriptor);
+   ASSERT_FALSE(IsReadable(descriptor));
+
+   // frame behind a gap is not ready
+   jitterBuffer->ReceivePacket("c", 1, 1, 0, 1);
+   ASSERT_FALSE(IsReadable(descriptor));
+   ASSERT_EQ(result_code::eNotReady, jitterBuffer->DecodeNext());
+   jitterBuffer->ReceivePacket("a", 1, 0, 0, 2);
+   ASSERT_FALSE(IsReadable(descriptor));
+   jitterBuffer->ReceivePacket("b", 1, 0, 1, 2);
+   ASSERT_TRUE(IsReadable(descriptor));
+
+   ASSERT_EQ(result_code::sOk, jitterBuffer->DecodeNext());
+   ASSERT_EQ(std::string("ab"), GetRenderer()->GetRenderedData());
+   ASSERT_TRUE(IsReadable(descriptor));
+   PulledFrame frame;
+   ASSERT_EQ(result_code::sOk, jitterBuffer->TryGetNextFrame(frame));
+   ASSERT_EQ(1, frame.frameNumber);
+   ASSERT_EQ(std::string("c"), std::string(frame.data.begin(), frame.data.end()));
+   ASSERT_EQ(result_code::eNotReady, jitterBuffer->TryGetNextFrame(frame));
+   ASSERT_FALSE(IsReadable(descriptor));
+
+   // Flush decodes on the calling thread as well
+   jitterBuffer->ReceivePacket("d", 1, 2, 0, 1);
+   ASSERT_TRUE(IsReadable(descriptor));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("abd"), GetRenderer()->GetRenderedData());
+   ASSERT_FALSE(IsReadable(descriptor));
+
+   JitterBufferStatistics statistics = jitterBuffer->GetStatistics();
+   ASSERT_EQ(2u, statistics.renderedFrames);
+   ASSERT_EQ(1u, statistics.pulledFrames);
+   ASSERT_EQ(-1, statistics.recyclerCpu);
+   ASSERT_EQ(-1, statistics.decoderCpu);
+
+   ASSERT_EQ(result_code::sOk, CreateJB(JitterBufferOptions()));
+   ASSERT_EQ(-1, GetJB()->GetReadinessDescriptor());
+   ASSERT_EQ(result_code::eUnexpected, GetJB()->DecodeNext());
+   ASSERT_EQ(result_code::eUnexpected, GetJB()->TryGetNextFrame(frame));
+}
+#endif
+
+/*
+ @about Check the owner loop in pull mode learns the frame deadline as its poll timeout,
+ and missing and incomplete frames are skipped when it expires
+ */
+TEST_F(FixtureJitterBuffer, PullMode_FrameDeadline)
+{
+   boost::shared_ptr<ISimulatedClock> clock = CreateSimulatedClock();
+   JitterBufferOptions options;
+   options.clock = clock.get();
+   options.frameDeadline = 50000;
+   options.pullMode = true;
+   ASSERT_EQ(result_code::sOk, CreateJB(options));
+   JitterBufferPtr jitterBuffer = GetJB();
+   ASSERT_GT(0, jitterBuffer->GetNextDeadline());
+
+   // frame #0 never arrives, frame #1 is incomplete
+   const TimeUs start = clock->GetTime();
+   jitterBuffer->ReceivePacket("a", 1, 1, 0, 2);
+   clock->AdvanceTime(10000);
+   jitterBuffer->ReceivePacket("c", 1, 2, 0, 1);
+   ASSERT_EQ(start + 50000, jitterBuffer->GetNextDeadline());
+
+   clock->AdvanceTime(39999);
+   ASSERT_EQ(result_code::eNotReady, jitterBuffer->DecodeNext());
+   ASSERT_EQ(std::string(), GetRenderer()->GetRenderedData());
+
+   clock->AdvanceTime(1);
+   ASSERT_EQ(result_code::sOk, jitterBuffer->DecodeNext());
+   ASSERT_EQ(std::string("c"), GetRenderer()->GetRenderedData());
+   ASSERT_EQ(result_code::eNotReady, jitterBuffer->DecodeNext());
+   ASSERT_EQ(2u, jitterBuffer->GetStatistics().expiredFrames);
+   ASSERT_GT(0, jitterBuffer->GetNextDeadline());
+}
+
+} // namespace test
+} // namespace video_coding
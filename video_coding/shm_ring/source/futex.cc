@@ -0,0 +1,66 @@
+/**
+ *  @file
+ *  \brief     Futex helpers
+ *  \details   Holds implementation of the futex helpers
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "futex.h"
+// third-party
+#include <limits.h>
+#include <boost/static_assert.hpp>
+#ifdef __linux__
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#else
+#include <boost/thread/thread.hpp>
+#endif
+
+#ifdef __linux__
+BOOST_STATIC_ASSERT_MSG(sizeof(video_coding::FutexWord) == sizeof(int),
+      "futex word must be a plain 32-bit integer");
+#else
+namespace
+{
+
+/// the longest single sleep while polling, where futex is not available (microseconds)
+const video_coding::TimeUs MaxPollInterval = 100;
+
+} // unnamed namespace
+#endif
+
+namespace video_coding
+{
+
+void FutexWait(FutexWord& word, const boost::uint32_t expected, const TimeUs timeout)
+{
+   if (timeout <= 0)
+      return;
+#ifdef __linux__
+   timespec relative;
+   relative.tv_sec = (time_t)(timeout / 1000000);
+   relative.tv_nsec = (long)(timeout % 1000000) * 1000;
+   // shared (not private) futex, so that the waker can be in another process
+   ::syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT, (int)expected, &relative, 0, 0);
+#else
+   if (word.load(boost::memory_order_acquire) == expected)
+   {
+      boost::this_thread::sleep_for(boost::chrono::microseconds(
+            timeout < MaxPollInterval ? timeout : MaxPollInterval));
+   }
+#endif
+}
+
+void FutexWakeAll(FutexWord& word)
+{
+#ifdef __linux__
+   ::syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE, INT_MAX, 0, 0, 0);
+#else
+   (void)word;
+#endif
+}
+
+} // namespace video_coding
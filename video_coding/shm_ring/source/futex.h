@@ -0,0 +1,42 @@
+/**
+ *  @file
+ *  \brief     Futex helpers
+ *  \details   Holds declaration of the functions to wait for a change of a 32-bit word
+ *             in shared memory, across processes
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_FUTEX_H
+#define VIDEO_CODING_FUTEX_H
+
+#include <video_coding/interface/clock.h>
+// third-party
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+
+namespace video_coding
+{
+
+/// futex word, must be placed in shared memory to be used across processes
+typedef boost::atomic<boost::uint32_t> FutexWord;
+
+/**
+ * Blocks the calling thread while the word equals the expected value, but no longer
+ * than timeout. May return spuriously, caller must recheck its condition. Based on
+ * futex on Linux, short sleep on other platforms
+ * @param word - word to wait on
+ * @param expected - value the word had when the caller checked its condition
+ * @param timeout - maximum time to wait (microseconds)
+ */
+void FutexWait(FutexWord& word, boost::uint32_t expected, TimeUs timeout);
+
+/**
+ * Wakes up all threads waiting on the word in any process
+ * @param word - word to wake up the waiters of
+ */
+void FutexWakeAll(FutexWord& word);
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_FUTEX_H
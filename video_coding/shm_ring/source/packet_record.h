@@ -0,0 +1,52 @@
+/**
+ *  @file
+ *  \brief     PacketRecord structure declaration
+ *  \details   Holds declaration of the fragment descriptor which precedes fragment
+ *             payload in the packet ring
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_PACKET_RECORD_H
+#define VIDEO_CODING_PACKET_RECORD_H
+
+// third-party
+#include <boost/cstdint.hpp>
+
+namespace video_coding
+{
+
+/**
+ * Bits of PacketRecord::flags
+ */
+enum PacketRecordFlags
+{
+   /// FrameInfo::independent
+   IndependentFrameFlag = 1
+};
+
+/**
+ * Fragment descriptor, the first bytes of every record of the packet ring. Payload
+ * follows it at PayloadOffset, so that the payload is aligned for the copy into the
+ * frame arena. Fields are fixed-size as the record is shared between processes,
+ * see IJitterBuffer::ReceivePacket for their meaning
+ */
+struct PacketRecord
+{
+   /// offset of the payload from the record start
+   static const int  PayloadOffset = 64;
+
+   boost::int32_t    frameNumber;
+   boost::int32_t    fragmentNumber;
+   boost::int32_t    numFragmentsInThisFrame;
+   /// FrameType value
+   boost::int32_t    frameType;
+   boost::int32_t    dependencyFrameNumber;
+   /// FrameInfo flags, see PacketRecordFlags
+   boost::int32_t    flags;
+   boost::int64_t    timestamp;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_PACKET_RECORD_H
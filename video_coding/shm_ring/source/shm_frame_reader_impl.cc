@@ -0,0 +1,42 @@
+/**
+ *  @file
+ *  \brief     ShmFrameReaderImpl class implementation
+ *  \details   Holds implementation of the IShmFrameReader interface
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "shm_frame_reader_impl.h"
+
+namespace video_coding
+{
+
+ShmFrameReaderImpl::ShmFrameReaderImpl(const std::string& name)
+   : m_region(name)
+   , m_ring(m_region.GetAddress(), m_region.GetSize(), FrameRingFormat)
+{}
+
+bool ShmFrameReaderImpl::TryAcquireFrame(ShmFrame& frame)
+{
+   return m_ring.Front(frame.data, frame.length, frame.sequence);
+}
+
+result_t ShmFrameReaderImpl::AcquireFrame(ShmFrame& frame, const TimeUs timeout)
+{
+   result_t result = m_ring.Wait(timeout);
+   if (result == result_code::sOk)
+      m_ring.Front(frame.data, frame.length, frame.sequence);
+   return result;
+}
+
+void ShmFrameReaderImpl::ReleaseFrame()
+{
+   m_ring.Pop();
+}
+
+ShmRingStatistics ShmFrameReaderImpl::GetStatistics() const
+{
+   return m_ring.GetStatistics();
+}
+
+} // namespace video_coding
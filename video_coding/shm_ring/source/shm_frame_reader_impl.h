@@ -0,0 +1,69 @@
+/**
+ *  @file
+ *  \brief     ShmFrameReaderImpl class declaration
+ *  \details   Holds declaration of the IShmFrameReader interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_SHM_FRAME_READER_IMPL_H
+#define VIDEO_CODING_SHM_FRAME_READER_IMPL_H
+
+#include <video_coding/interface/shm_ring.h>
+#include "shm_region.h"
+#include "slot_ring.h"
+// third-party
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * ShmFrameReaderImpl class
+ * Implements interface IShmFrameReader on the ring created by ShmRendererImpl
+ */
+class ShmFrameReaderImpl
+   : public IShmFrameReader
+   , boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. For more details see OpenShmFrameReader
+    */
+   explicit ShmFrameReaderImpl(const std::string& name);
+
+   /**
+    * IShmFrameReader interface method implementation. For more details see
+    * IShmFrameReader interface.
+    */
+   virtual bool TryAcquireFrame(ShmFrame& frame);
+
+   /**
+    * IShmFrameReader interface method implementation. Waits on the ring futex. For more
+    * details see IShmFrameReader interface.
+    */
+   virtual result_t AcquireFrame(ShmFrame& frame, TimeUs timeout);
+
+   /**
+    * IShmFrameReader interface method implementation. For more details see
+    * IShmFrameReader interface.
+    */
+   virtual void ReleaseFrame();
+
+   /**
+    * IShmFrameReader interface method implementation. For more details see
+    * IShmFrameReader interface.
+    */
+   virtual ShmRingStatistics GetStatistics() const;
+
+private:
+   /// shared memory holding the ring
+   ShmRegion         m_region;
+   /// the ring
+   SlotRing          m_ring;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_SHM_FRAME_READER_IMPL_H
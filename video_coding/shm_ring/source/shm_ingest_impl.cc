@@ -0,0 +1,107 @@
+/**
+ *  @file
+ *  \brief     ShmIngestImpl class implementation
+ *  \details   Holds implementation of the IShmIngest interface
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "shm_ingest_impl.h"
+#include "packet_record.h"
+#include <video_coding/interface/jitter_buffer.h>
+// third-party
+#include <boost/bind.hpp>
+#include <string.h>
+
+namespace
+{
+
+/// how often the ingest thread checks for the stop request while the ring is idle
+/// (microseconds)
+const video_coding::TimeUs StopCheckInterval = 10000;
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+ShmIngestImpl::ShmIngestImpl(const std::string& name, IJitterBuffer* jitterBuffer)
+   : m_region(name)
+   , m_ring(m_region.GetAddress(), m_region.GetSize(), PacketRingFormat)
+   , m_jitterBuffer(jitterBuffer)
+   , m_receivedPackets(0)
+   , m_rejectedPackets(0)
+   , m_stopRequested(false)
+   , m_thread(boost::bind(&ShmIngestImpl::ReceivePackets, this))
+{}
+
+ShmIngestImpl::~ShmIngestImpl()
+{
+   m_stopRequested.store(true, boost::memory_order_relaxed);
+   m_thread.join();
+}
+
+ShmIngestStatistics ShmIngestImpl::GetStatistics() const
+{
+   ShmRingStatistics ringStatistics = m_ring.GetStatistics();
+   ShmIngestStatistics statistics;
+   statistics.publishedPackets = ringStatistics.publishedFrames;
+   statistics.droppedPackets = ringStatistics.droppedFrames;
+   statistics.receivedPackets = m_receivedPackets.load(boost::memory_order_relaxed);
+   statistics.rejectedPackets = m_rejectedPackets.load(boost::memory_order_relaxed);
+   return statistics;
+}
+
+void ShmIngestImpl::ReceivePackets()
+{
+   while (!m_stopRequested.load(boost::memory_order_relaxed))
+   {
+      result_t result = m_ring.Wait(StopCheckInterval);
+      if (result == result_code::eNotReady)
+         continue;
+      if (result != result_code::sOk)
+         break;
+
+      const char* record;
+      int length;
+      boost::uint64_t sequence;
+      while (m_ring.Front(record, length, sequence))
+      {
+         // fragment is copied to the frame arena by JB, so the slot is released at once:
+         // holding it till the frame is complete would stall the writer behind a lost packet
+         if (!ReceivePacket(record, length))
+            m_rejectedPackets.fetch_add(1, boost::memory_order_relaxed);
+         m_receivedPackets.fetch_add(1, boost::memory_order_relaxed);
+         m_ring.Pop();
+      }
+   }
+}
+
+bool ShmIngestImpl::ReceivePacket(const char* record, const int length)
+{
+   // the other process is not trusted, JB validates the rest
+   if (length < PacketRecord::PayloadOffset)
+      return false;
+   // the writer may still change the record, so the descriptor is read once into a copy
+   // and only the copy is validated and used
+   PacketRecord packet;
+   ::memcpy(&packet, record, sizeof(packet));
+   if (packet.frameType < KeyFrame || packet.frameType > NonReferenceFrame)
+      return false;
+
+   FrameInfo info;
+   info.type = static_cast<FrameType>(packet.frameType);
+   info.dependencyFrameNumber = packet.dependencyFrameNumber;
+   info.timestamp = packet.timestamp;
+   info.independent = (packet.flags & IndependentFrameFlag) != 0;
+   // a full JB is not waited for: the fragments completing its frames are behind this one
+   return m_jitterBuffer->TryReceivePacket(
+      record + PacketRecord::PayloadOffset,
+      length - PacketRecord::PayloadOffset,
+      packet.frameNumber,
+      packet.fragmentNumber,
+      packet.numFragmentsInThisFrame,
+      info) == result_code::sOk;
+}
+
+} // namespace video_coding
@@ -0,0 +1,82 @@
+/**
+ *  @file
+ *  \brief     ShmIngestImpl class declaration
+ *  \details   Holds declaration of the IShmIngest interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_SHM_INGEST_IMPL_H
+#define VIDEO_CODING_SHM_INGEST_IMPL_H
+
+#include <video_coding/interface/shm_ring.h>
+#include "shm_region.h"
+#include "slot_ring.h"
+// third-party
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
+namespace video_coding
+{
+
+/**
+ * ShmIngestImpl class
+ * Implements interface IShmIngest on the ring created by ShmPacketWriterImpl
+ */
+class ShmIngestImpl
+   : public IShmIngest
+   , boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. For more details see CreateShmIngest
+    */
+   ShmIngestImpl(const std::string& name, IJitterBuffer* jitterBuffer);
+
+   /**
+    * Destructor. Stops the ingest thread
+    */
+   ~ShmIngestImpl();
+
+   /**
+    * IShmIngest interface method implementation. For more details see IShmIngest
+    * interface.
+    */
+   virtual ShmIngestStatistics GetStatistics() const;
+
+private:
+
+   /**
+    * Ingest thread routine. Passes packets to JB until stopped or the writer is gone
+    */
+   void ReceivePackets();
+
+   /**
+    * Helper function to pass the record to JB. Does not throw
+    * @param record - record in the ring slot
+    * @param length - record length
+    * @returns - true if JB accepted the packet
+    */
+   bool ReceivePacket(const char* record, int length);
+
+   /// shared memory holding the ring
+   ShmRegion               m_region;
+   /// the ring
+   SlotRing                m_ring;
+   /// JB receiving the packets
+   IJitterBuffer*          m_jitterBuffer;
+   /// packets taken from the ring
+   boost::atomic<boost::uint64_t> m_receivedPackets;
+   /// packets rejected by JB or malformed
+   boost::atomic<boost::uint64_t> m_rejectedPackets;
+   /// flag to stop the ingest thread
+   boost::atomic<bool>     m_stopRequested;
+   /// the ingest thread, started last
+   boost::thread           m_thread;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_SHM_INGEST_IMPL_H
@@ -0,0 +1,98 @@
+/**
+ *  @file
+ *  \brief     ShmPacketWriterImpl class implementation
+ *  \details   Holds implementation of the IShmPacketWriter interface
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "shm_packet_writer_impl.h"
+#include "packet_record.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#include <string.h>
+#include <limits.h>
+
+namespace video_coding
+{
+
+ShmPacketWriterImpl::ShmPacketWriterImpl(
+   const std::string& name,
+   const int slotCount,
+   const int maxPacketSize)
+   : m_region(name, SlotRing::GetRegionSize(slotCount, GetSlotSize(maxPacketSize)))
+   , m_ring(m_region.GetAddress(), PacketRingFormat, slotCount, GetSlotSize(maxPacketSize))
+{}
+
+ShmPacketWriterImpl::~ShmPacketWriterImpl()
+{
+   m_ring.Close();
+}
+
+char* ShmPacketWriterImpl::GetPacketBuffer()
+{
+   char* slot = m_ring.GetFreeSlot();
+   return slot ? slot + PacketRecord::PayloadOffset : 0;
+}
+
+int ShmPacketWriterImpl::GetMaxPacketSize() const
+{
+   return m_ring.GetSlotSize() - PacketRecord::PayloadOffset;
+}
+
+result_t ShmPacketWriterImpl::WritePacket(
+   const char* buffer,
+   const int length,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame,
+   const FrameInfo& info)
+{
+   // the rest is validated by JB
+   if (length < 0 || length > GetMaxPacketSize())
+      return result_code::eInvalidArgument;
+
+   char* slot = m_ring.GetFreeSlot();
+   if (!slot)
+   {
+      m_ring.CountDropped();
+      return result_code::eOutOfSpace;
+   }
+
+   PacketRecord* record = reinterpret_cast<PacketRecord*>(slot);
+   record->frameNumber = frameNumber;
+   record->fragmentNumber = fragmentNumber;
+   record->numFragmentsInThisFrame = numFragmentsInThisFrame;
+   record->frameType = info.type;
+   record->dependencyFrameNumber = info.dependencyFrameNumber;
+   record->flags = info.independent ? IndependentFrameFlag : 0;
+   record->timestamp = info.timestamp;
+
+   char* payload = slot + PacketRecord::PayloadOffset;
+   if (buffer != payload && length)
+   {
+      ::memcpy(payload, buffer, length);
+      m_ring.CountCopied();
+   }
+   m_ring.Publish(PacketRecord::PayloadOffset + length);
+   return result_code::sOk;
+}
+
+ShmIngestStatistics ShmPacketWriterImpl::GetStatistics() const
+{
+   ShmRingStatistics ringStatistics = m_ring.GetStatistics();
+   ShmIngestStatistics statistics;
+   statistics.publishedPackets = ringStatistics.publishedFrames;
+   statistics.droppedPackets = ringStatistics.droppedFrames;
+   statistics.receivedPackets = ringStatistics.releasedFrames;
+   return statistics;
+}
+
+int ShmPacketWriterImpl::GetSlotSize(const int maxPacketSize)
+{
+   CHECK_ARGUMENT(maxPacketSize > 0 && maxPacketSize <= INT_MAX - PacketRecord::PayloadOffset,
+         "Invalid packet size " << maxPacketSize);
+   return PacketRecord::PayloadOffset + maxPacketSize;
+}
+
+} // namespace video_coding
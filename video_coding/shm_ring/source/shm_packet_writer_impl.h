@@ -0,0 +1,90 @@
+/**
+ *  @file
+ *  \brief     ShmPacketWriterImpl class declaration
+ *  \details   Holds declaration of the IShmPacketWriter interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_SHM_PACKET_WRITER_IMPL_H
+#define VIDEO_CODING_SHM_PACKET_WRITER_IMPL_H
+
+#include <video_coding/interface/shm_ring.h>
+#include "shm_region.h"
+#include "slot_ring.h"
+// third-party
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * ShmPacketWriterImpl class
+ * Implements interface IShmPacketWriter. Creates the packet ring and publishes every
+ * packet as PacketRecord followed by the payload
+ */
+class ShmPacketWriterImpl
+   : public IShmPacketWriter
+   , boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. For more details see CreateShmPacketWriter
+    */
+   ShmPacketWriterImpl(const std::string& name, int slotCount, int maxPacketSize);
+
+   /**
+    * Destructor. Lets the ingest know no more packets will come
+    */
+   ~ShmPacketWriterImpl();
+
+   /**
+    * IShmPacketWriter interface method implementation. For more details see
+    * IShmPacketWriter interface.
+    */
+   virtual char* GetPacketBuffer();
+
+   /**
+    * IShmPacketWriter interface method implementation. For more details see
+    * IShmPacketWriter interface.
+    */
+   virtual int GetMaxPacketSize() const;
+
+   /**
+    * IShmPacketWriter interface method implementation. For more details see
+    * IShmPacketWriter interface.
+    */
+   virtual result_t WritePacket(
+      const char* buffer,
+      int length,
+      int frameNumber,
+      int fragmentNumber,
+      int numFragmentsInThisFrame,
+      const FrameInfo& info);
+
+   /**
+    * IShmPacketWriter interface method implementation. Packets rejected by JB are not
+    * known to the writer. For more details see IShmPacketWriter interface.
+    */
+   virtual ShmIngestStatistics GetStatistics() const;
+
+private:
+
+   /**
+    * Helper function to get the slot size of the ring. Throws std::exception in case
+    * of invalid packet size
+    * @param maxPacketSize - maximum payload size
+    * @returns - record size
+    */
+   static int GetSlotSize(int maxPacketSize);
+
+   /// shared memory holding the ring
+   ShmRegion         m_region;
+   /// the ring
+   SlotRing          m_ring;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_SHM_PACKET_WRITER_IMPL_H
@@ -0,0 +1,108 @@
+/**
+ *  @file
+ *  \brief     ShmRegion class implementation
+ *  \details   Holds implementation of the ShmRegion class based on shm_open and mmap
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "shm_region.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace video_coding
+{
+
+ShmRegion::ShmRegion(const std::string& name, const size_t size)
+   : m_name(name)
+   , m_owner(true)
+   , m_address(0)
+   , m_size(size)
+{
+   CHECK_ARGUMENT(size > 0, "Invalid shared memory size " << size);
+
+   // stale object of a crashed owner is replaced, so readers never see its content
+   ::shm_unlink(name.c_str());
+   int descriptor = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+   if (descriptor < 0)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to create shared memory "
+            << name << ", error " << errno;
+
+   if (::ftruncate(descriptor, (off_t)size) != 0)
+   {
+      int error = errno;
+      ::close(descriptor);
+      ::shm_unlink(name.c_str());
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to resize shared memory "
+            << name << " to " << size << " bytes, error " << error;
+   }
+
+   try
+   {
+      Map(descriptor);
+   }
+   catch (const std::exception&)
+   {
+      ::shm_unlink(name.c_str());
+      throw;
+   }
+}
+
+ShmRegion::ShmRegion(const std::string& name)
+   : m_name(name)
+   , m_owner(false)
+   , m_address(0)
+   , m_size(0)
+{
+   int descriptor = ::shm_open(name.c_str(), O_RDWR, 0);
+   if (descriptor < 0)
+      THROW_BASIC_EXCEPTION(result_code::eNotFound) << "Unable to open shared memory "
+            << name << ", error " << errno;
+
+   struct stat status;
+   if (::fstat(descriptor, &status) != 0 || status.st_size <= 0)
+   {
+      ::close(descriptor);
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Shared memory " << name << " is empty";
+   }
+
+   m_size = (size_t)status.st_size;
+   Map(descriptor);
+}
+
+ShmRegion::~ShmRegion()
+{
+   ::munmap(m_address, m_size);
+   if (m_owner)
+      ::shm_unlink(m_name.c_str());
+}
+
+char* ShmRegion::GetAddress() const
+{
+   return m_address;
+}
+
+size_t ShmRegion::GetSize() const
+{
+   return m_size;
+}
+
+void ShmRegion::Map(const int descriptor)
+{
+   void* address = ::mmap(0, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+   int error = errno;
+   // mapping keeps the object referenced
+   ::close(descriptor);
+   if (address == MAP_FAILED)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to map shared memory "
+            << m_name << ", error " << error;
+
+   m_address = static_cast<char*>(address);
+}
+
+} // namespace video_coding
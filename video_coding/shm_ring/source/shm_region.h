@@ -0,0 +1,82 @@
+/**
+ *  @file
+ *  \brief     ShmRegion class declaration
+ *  \details   Holds declaration of the ShmRegion class - mapping of a named POSIX
+ *             shared memory object
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_SHM_REGION_H
+#define VIDEO_CODING_SHM_REGION_H
+
+// third-party
+#include <stddef.h>
+#include <string>
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * ShmRegion class maps named POSIX shared memory object into the process. The owner
+ * creates the object and removes its name on destruction, other processes open it
+ * by name. Memory of a new object is zero-filled
+ */
+class ShmRegion : boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. Creates new object of the given size, existing object with the same
+    * name is replaced. Throws std::exception on system error
+    * @param name - object name, must start with '/'
+    * @param size - object size
+    */
+   ShmRegion(const std::string& name, size_t size);
+
+   /**
+    * Constructor. Opens existing object, the whole object is mapped. Throws
+    * std::exception if the object does not exist
+    * @param name - object name, must start with '/'
+    */
+   explicit ShmRegion(const std::string& name);
+
+   /**
+    * Destructor. Unmaps the object, the owner also removes its name
+    */
+   ~ShmRegion();
+
+   /**
+    * Accessor to get the mapping address
+    * @returns - address of the first byte of the object
+    */
+   char* GetAddress() const;
+
+   /**
+    * Accessor to get the mapping size
+    * @returns - object size
+    */
+   size_t GetSize() const;
+
+private:
+
+   /**
+    * Maps the object and closes its descriptor. Throws std::exception on system error
+    * @param descriptor - descriptor of the opened object
+    */
+   void Map(int descriptor);
+
+   /// object name
+   const std::string m_name;
+   /// flag, indicates the object is created by this instance
+   const bool        m_owner;
+   /// mapping address
+   char*             m_address;
+   /// mapping size
+   size_t            m_size;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_SHM_REGION_H
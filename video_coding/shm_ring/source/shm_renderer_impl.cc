@@ -0,0 +1,57 @@
+/**
+ *  @file
+ *  \brief     ShmRendererImpl class implementation
+ *  \details   Holds implementation of the IShmRenderer interface
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "shm_renderer_impl.h"
+#include <logger/logger.h>
+// third-party
+#include <string.h>
+
+namespace video_coding
+{
+
+ShmRendererImpl::ShmRendererImpl(const std::string& name, const int slotCount, const int slotSize)
+   : m_region(name, SlotRing::GetRegionSize(slotCount, slotSize))
+   , m_ring(m_region.GetAddress(), FrameRingFormat, slotCount, slotSize)
+{}
+
+ShmRendererImpl::~ShmRendererImpl()
+{
+   m_ring.Close();
+}
+
+char* ShmRendererImpl::GetFrameBuffer(const int size)
+{
+   if (size > m_ring.GetSlotSize())
+      return 0;
+   return m_ring.GetFreeSlot();
+}
+
+void ShmRendererImpl::RenderFrame(const char* buffer, const int length)
+{
+   char* slot = m_ring.GetFreeSlot();
+   if (!slot || length > m_ring.GetSlotSize())
+   {
+      LOGDBG << "Frame of " << length << " bytes is dropped by shared memory renderer";
+      m_ring.CountDropped();
+      return;
+   }
+
+   if (buffer != slot)
+   {
+      ::memcpy(slot, buffer, length);
+      m_ring.CountCopied();
+   }
+   m_ring.Publish(length);
+}
+
+ShmRingStatistics ShmRendererImpl::GetStatistics() const
+{
+   return m_ring.GetStatistics();
+}
+
+} // namespace video_coding
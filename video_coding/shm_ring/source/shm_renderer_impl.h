@@ -0,0 +1,70 @@
+/**
+ *  @file
+ *  \brief     ShmRendererImpl class declaration
+ *  \details   Holds declaration of the IShmRenderer interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_SHM_RENDERER_IMPL_H
+#define VIDEO_CODING_SHM_RENDERER_IMPL_H
+
+#include <video_coding/interface/shm_ring.h>
+#include "shm_region.h"
+#include "slot_ring.h"
+// third-party
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * ShmRendererImpl class
+ * Implements interface IShmRenderer. Creates the ring and publishes every rendered
+ * frame to it
+ */
+class ShmRendererImpl
+   : public IShmRenderer
+   , boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. For more details see CreateShmRenderer
+    */
+   ShmRendererImpl(const std::string& name, int slotCount, int slotSize);
+
+   /**
+    * Destructor. Lets the reader know no more frames will come
+    */
+   ~ShmRendererImpl();
+
+   /**
+    * IBufferedRenderer interface method implementation. Provides the free slot of the
+    * ring. For more details see IBufferedRenderer interface.
+    */
+   virtual char* GetFrameBuffer(int size);
+
+   /**
+    * IRenderer interface method implementation. Publishes the frame, it is copied
+    * unless it is in the slot provided by GetFrameBuffer. For more details see IRenderer
+    * interface.
+    */
+   virtual void RenderFrame(const char* buffer, int length);
+
+   /**
+    * IShmRenderer interface method implementation. For more details see IShmRenderer
+    * interface.
+    */
+   virtual ShmRingStatistics GetStatistics() const;
+
+private:
+   /// shared memory holding the ring
+   ShmRegion         m_region;
+   /// the ring
+   SlotRing          m_ring;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_SHM_RENDERER_IMPL_H
@@ -0,0 +1,69 @@
+/**
+ *  @file
+ *  \brief     Shared-memory ring factories implementation
+ *  \details   Holds implementation of factory methods that can be used to create
+ *             both sides of the shared-memory frame and packet rings
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/interface/shm_ring.h>
+#include "shm_renderer_impl.h"
+#include "shm_frame_reader_impl.h"
+#include "shm_packet_writer_impl.h"
+#include "shm_ingest_impl.h"
+#include <common/exception_dispatcher.h>
+
+namespace video_coding
+{
+
+ShmRingStatistics::ShmRingStatistics()
+   : publishedFrames(0)
+   , copiedFrames(0)
+   , droppedFrames(0)
+   , releasedFrames(0)
+{}
+
+boost::shared_ptr<IShmRenderer> CreateShmRenderer(
+   const std::string& name,
+   const int slotCount,
+   const int slotSize)
+{
+   boost::shared_ptr<IShmRenderer> renderer;
+   renderer.reset( new ShmRendererImpl(name, slotCount, slotSize) );
+   return renderer;
+}
+
+boost::shared_ptr<IShmFrameReader> OpenShmFrameReader(const std::string& name)
+{
+   boost::shared_ptr<IShmFrameReader> reader;
+   reader.reset( new ShmFrameReaderImpl(name) );
+   return reader;
+}
+
+ShmIngestStatistics::ShmIngestStatistics()
+   : publishedPackets(0)
+   , droppedPackets(0)
+   , receivedPackets(0)
+   , rejectedPackets(0)
+{}
+
+boost::shared_ptr<IShmPacketWriter> CreateShmPacketWriter(
+   const std::string& name,
+   const int slotCount,
+   const int maxPacketSize)
+{
+   boost::shared_ptr<IShmPacketWriter> writer;
+   writer.reset( new ShmPacketWriterImpl(name, slotCount, maxPacketSize) );
+   return writer;
+}
+
+boost::shared_ptr<IShmIngest> CreateShmIngest(const std::string& name, IJitterBuffer* jitterBuffer)
+{
+   CHECK_ARGUMENT(jitterBuffer != 0, "Jitter buffer is zero!");
+   boost::shared_ptr<IShmIngest> ingest;
+   ingest.reset( new ShmIngestImpl(name, jitterBuffer) );
+   return ingest;
+}
+
+} // namespace video_coding
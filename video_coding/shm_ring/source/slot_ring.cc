@@ -0,0 +1,203 @@
+/**
+ *  @file
+ *  \brief     SlotRing class implementation
+ *  \details   Holds implementation of the SlotRing class
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "slot_ring.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#include <new>
+#include <boost/chrono.hpp>
+#include <boost/static_assert.hpp>
+
+// both processes access the ring atomics directly, without any process-local state
+BOOST_STATIC_ASSERT_MSG(BOOST_ATOMIC_INT64_LOCK_FREE == 2 && BOOST_ATOMIC_INT32_LOCK_FREE == 2,
+      "shared memory ring requires lock-free atomics");
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/// signature of an initialized ring
+const boost::uint32_t Magic = 0x52534A56; // "VJSR"
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+size_t SlotRing::GetRegionSize(const int slotCount, const int slotSize)
+{
+   CHECK_ARGUMENT(slotCount > 0, "Invalid slot count " << slotCount);
+   CHECK_ARGUMENT(slotSize > 0, "Invalid slot size " << slotSize);
+   return sizeof(Header) + (size_t)slotCount * GetSlotStride(slotSize);
+}
+
+SlotRing::SlotRing(
+   char* memory,
+   const boost::uint32_t format,
+   const int slotCount,
+   const int slotSize)
+   : m_header(0)
+   , m_slots(0)
+   , m_slotCount((boost::uint32_t)slotCount)
+   , m_slotSize(slotSize)
+   , m_slotStride(GetSlotStride(slotSize))
+{
+   BOOST_STATIC_ASSERT(sizeof(Header) == 3 * CacheLine && sizeof(SlotHeader) == CacheLine);
+   CHECK_ARGUMENT(memory != 0, "Memory is zero!");
+   CHECK_ARGUMENT(slotCount > 0, "Invalid slot count " << slotCount);
+   CHECK_ARGUMENT(slotSize > 0, "Invalid slot size " << slotSize);
+
+   m_header = new (memory) Header();
+   m_slots = memory + sizeof(Header);
+   m_header->format = format;
+   m_header->slotCount = m_slotCount;
+   m_header->slotSize = (boost::uint32_t)slotSize;
+   m_header->writePosition.store(0, boost::memory_order_relaxed);
+   m_header->copiedCount.store(0, boost::memory_order_relaxed);
+   m_header->droppedCount.store(0, boost::memory_order_relaxed);
+   m_header->publishSequence.store(0, boost::memory_order_relaxed);
+   m_header->closed.store(0, boost::memory_order_relaxed);
+   m_header->readPosition.store(0, boost::memory_order_relaxed);
+   m_header->consumerWaiting.store(0, boost::memory_order_relaxed);
+   m_header->magic.store(Magic, boost::memory_order_release);
+}
+
+SlotRing::SlotRing(char* memory, const size_t size, const boost::uint32_t format)
+   : m_header(reinterpret_cast<Header*>(memory))
+   , m_slots(memory + sizeof(Header))
+   , m_slotCount(0)
+   , m_slotSize(0)
+   , m_slotStride(0)
+{
+   CHECK_ARGUMENT(memory != 0 && size >= sizeof(Header), "Memory does not hold a ring!");
+   CHECK_ARGUMENT(m_header->magic.load(boost::memory_order_acquire) == Magic,
+         "Memory does not hold an initialized ring!");
+   CHECK_ARGUMENT(m_header->format == format, "Ring format " << m_header->format
+         << " does not match expected " << format);
+
+   m_slotCount = m_header->slotCount;
+   m_slotSize = (int)m_header->slotSize;
+   CHECK_ARGUMENT(m_slotCount > 0 && m_slotSize > 0 &&
+         size >= GetRegionSize((int)m_slotCount, m_slotSize), "Ring is truncated!");
+   m_slotStride = GetSlotStride(m_slotSize);
+}
+
+int SlotRing::GetSlotSize() const
+{
+   return m_slotSize;
+}
+
+char* SlotRing::GetFreeSlot()
+{
+   boost::uint64_t position = m_header->writePosition.load(boost::memory_order_relaxed);
+   // acquire pairs with Pop, so the consumer is done with the slot
+   if (position - m_header->readPosition.load(boost::memory_order_acquire) >= m_slotCount)
+      return 0;
+   return reinterpret_cast<char*>(GetSlot(position) + 1);
+}
+
+void SlotRing::Publish(const int length)
+{
+   boost::uint64_t position = m_header->writePosition.load(boost::memory_order_relaxed);
+   GetSlot(position)->length = length;
+   m_header->writePosition.store(position + 1, boost::memory_order_release);
+
+   // pairs with Wait: either consumer sees the new sequence, or producer sees it waiting
+   m_header->publishSequence.fetch_add(1, boost::memory_order_seq_cst);
+   if (m_header->consumerWaiting.load(boost::memory_order_seq_cst))
+      FutexWakeAll(m_header->publishSequence);
+}
+
+void SlotRing::CountCopied()
+{
+   m_header->copiedCount.fetch_add(1, boost::memory_order_relaxed);
+}
+
+void SlotRing::CountDropped()
+{
+   m_header->droppedCount.fetch_add(1, boost::memory_order_relaxed);
+}
+
+void SlotRing::Close()
+{
+   m_header->closed.store(1, boost::memory_order_release);
+   m_header->publishSequence.fetch_add(1, boost::memory_order_seq_cst);
+   FutexWakeAll(m_header->publishSequence);
+}
+
+bool SlotRing::Front(const char*& data, int& length, boost::uint64_t& sequence) const
+{
+   boost::uint64_t position = m_header->readPosition.load(boost::memory_order_relaxed);
+   if (position == m_header->writePosition.load(boost::memory_order_acquire))
+      return false;
+
+   const SlotHeader* slot = GetSlot(position);
+   data = reinterpret_cast<const char*>(slot + 1);
+   length = slot->length;
+   // the other process is not trusted to stay within the slot
+   if (length < 0 || length > m_slotSize)
+      length = 0;
+   sequence = position;
+   return true;
+}
+
+void SlotRing::Pop()
+{
+   boost::uint64_t position = m_header->readPosition.load(boost::memory_order_relaxed);
+   if (position != m_header->writePosition.load(boost::memory_order_acquire))
+      m_header->readPosition.store(position + 1, boost::memory_order_release);
+}
+
+result_t SlotRing::Wait(const TimeUs timeout)
+{
+   const Clock::time_point deadline = Clock::now() + boost::chrono::microseconds(timeout);
+   const char* data;
+   int length;
+   boost::uint64_t sequence;
+   for (;;)
+   {
+      boost::uint32_t published = m_header->publishSequence.load(boost::memory_order_seq_cst);
+      if (Front(data, length, sequence))
+         return result_code::sOk;
+      if (m_header->closed.load(boost::memory_order_acquire))
+         return result_code::eFail;
+
+      TimeUs remaining = (TimeUs)boost::chrono::duration_cast<boost::chrono::microseconds>(
+            deadline - Clock::now()).count();
+      if (remaining <= 0)
+         return result_code::eNotReady;
+
+      m_header->consumerWaiting.store(1, boost::memory_order_seq_cst);
+      // kernel rechecks the sequence, so publication after the load above is not missed
+      FutexWait(m_header->publishSequence, published, remaining);
+      m_header->consumerWaiting.store(0, boost::memory_order_relaxed);
+   }
+}
+
+ShmRingStatistics SlotRing::GetStatistics() const
+{
+   ShmRingStatistics statistics;
+   statistics.publishedFrames = m_header->writePosition.load(boost::memory_order_relaxed);
+   statistics.copiedFrames = m_header->copiedCount.load(boost::memory_order_relaxed);
+   statistics.droppedFrames = m_header->droppedCount.load(boost::memory_order_relaxed);
+   statistics.releasedFrames = m_header->readPosition.load(boost::memory_order_relaxed);
+   return statistics;
+}
+
+size_t SlotRing::GetSlotStride(const int slotSize)
+{
+   return sizeof(SlotHeader) + ((size_t)slotSize + CacheLine - 1) / CacheLine * CacheLine;
+}
+
+SlotRing::SlotHeader* SlotRing::GetSlot(const boost::uint64_t position) const
+{
+   return reinterpret_cast<SlotHeader*>(m_slots + (position % m_slotCount) * m_slotStride);
+}
+
+} // namespace video_coding
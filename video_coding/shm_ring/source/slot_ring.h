@@ -0,0 +1,211 @@
+/**
+ *  @file
+ *  \brief     SlotRing class declaration
+ *  \details   Holds declaration of the SlotRing class - single-producer/single-consumer
+ *             ring of fixed-size slots placed in shared memory
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_SLOT_RING_H
+#define VIDEO_CODING_SLOT_RING_H
+
+#include "futex.h"
+#include <video_coding/interface/shm_ring.h>
+#include <common/result_code.h>
+// third-party
+#include <stddef.h>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace video_coding
+{
+
+/**
+ * Identifiers of the record formats, so that the consumer never attaches to a ring
+ * of another kind, see SlotRing
+ */
+enum RingFormat
+{
+   /// decoded frames, see IShmRenderer
+   FrameRingFormat = 1,
+   /// fragments with their descriptors, see IShmPacketWriter and PacketRecord
+   PacketRingFormat = 2
+};
+
+/**
+ * SlotRing class. Operates on the ring placed in memory shared by the producer and the
+ * consumer processes, the instance itself is process-local. Layout: header followed by
+ * slotCount slots, each slot is a cache-line sized slot header and slotSize bytes of
+ * data aligned to cache line.
+ * Producer writes the slot at write position and publishes it by advancing the
+ * position, consumer reads the slot at read position and returns it by advancing
+ * its own position. Both positions only grow, so the slot is reclaimed without locks
+ * and the producer never waits: it sees the ring full and drops the record instead.
+ * Consumer waits for records on a futex word, producer wakes it only if it announced
+ * that it waits, so publishing costs no system call while consumer keeps up
+ */
+class SlotRing : boost::noncopyable
+{
+public:
+
+   /**
+    * Helper function to calculate the memory size of the ring
+    * @param slotCount - number of slots
+    * @param slotSize - maximum record size
+    * @returns - size of the shared memory to hold the ring
+    */
+   static size_t GetRegionSize(int slotCount, int slotSize);
+
+   /**
+    * Constructor. Initializes new ring in zero-filled memory. Throws std::exception
+    * in case of invalid arguments
+    * @param memory - shared memory of GetRegionSize bytes, aligned to cache line
+    * @param format - ring format identifier, must match on both sides
+    * @param slotCount - number of slots
+    * @param slotSize - maximum record size
+    */
+   SlotRing(char* memory, boost::uint32_t format, int slotCount, int slotSize);
+
+   /**
+    * Constructor. Attaches to the ring initialized by another process. Throws
+    * std::exception if the memory does not hold the ring of the given format
+    * @param memory - shared memory
+    * @param size - size of the shared memory
+    * @param format - ring format identifier, must match on both sides
+    */
+   SlotRing(char* memory, size_t size, boost::uint32_t format);
+
+   /**
+    * Accessor to get the maximum record size
+    * @returns - size of the slot data
+    */
+   int GetSlotSize() const;
+
+   /**
+    * Producer side. Gives access to the slot at write position
+    * @returns - slot data, zero if the ring is full
+    */
+   char* GetFreeSlot();
+
+   /**
+    * Producer side. Publishes the slot returned by GetFreeSlot and wakes the consumer
+    * up if it waits
+    * @param length - record length
+    */
+   void Publish(int length);
+
+   /**
+    * Producer side. Counts the record copied into the ring, see ShmRingStatistics
+    */
+   void CountCopied();
+
+   /**
+    * Producer side. Counts the record dropped, see ShmRingStatistics
+    */
+   void CountDropped();
+
+   /**
+    * Producer side. Lets the consumer know that no more records will be published
+    */
+   void Close();
+
+   /**
+    * Consumer side. Gives access to the oldest published record without removing it
+    * @param data - out parameter, record data
+    * @param length - out parameter, record length
+    * @param sequence - out parameter, sequence number of the record
+    * @returns - false if there is no published record
+    */
+   bool Front(const char*& data, int& length, boost::uint64_t& sequence) const;
+
+   /**
+    * Consumer side. Returns the slot of the record returned by Front to the producer
+    */
+   void Pop();
+
+   /**
+    * Consumer side. Waits until a record is published or the producer closes the ring
+    * @param timeout - maximum time to wait (microseconds)
+    * @returns - sOk if there is a record, eNotReady if timeout expired earlier, eFail
+    *            if the ring is closed and empty
+    */
+   result_t Wait(TimeUs timeout);
+
+   /**
+    * Accessor to get current values of the ring counters
+    * @returns - snapshot of the counters
+    */
+   ShmRingStatistics GetStatistics() const;
+
+private:
+   typedef boost::atomic<boost::uint64_t> Position;
+
+   /// granularity of the layout, keeps producer and consumer data in separate lines
+   static const size_t CacheLine = 64;
+
+   /**
+    * Ring header, the first bytes of the shared memory
+    */
+   struct Header
+   {
+      /// ring signature, written the last when ring is initialized
+      boost::atomic<boost::uint32_t>   magic;
+      boost::uint32_t                  format;
+      boost::uint32_t                  slotCount;
+      boost::uint32_t                  slotSize;
+      char                             layoutPadding[CacheLine - 16];
+
+      /// written by producer
+      Position                         writePosition;
+      Position                         copiedCount;
+      Position                         droppedCount;
+      /// incremented on every publication, consumer waits on it
+      FutexWord                        publishSequence;
+      FutexWord                        closed;
+      char                             producerPadding[CacheLine - 32];
+
+      /// written by consumer
+      Position                         readPosition;
+      /// non-zero while consumer is going to wait on publishSequence
+      FutexWord                        consumerWaiting;
+      char                             consumerPadding[CacheLine - 12];
+   };
+
+   /**
+    * Slot header, precedes slot data
+    */
+   struct SlotHeader
+   {
+      boost::int32_t                   length;
+      char                             padding[CacheLine - 4];
+   };
+
+   /**
+    * Helper function to get the distance between neighbour slots
+    * @param slotSize - maximum record size
+    * @returns - slot header and data size rounded up to cache line
+    */
+   static size_t GetSlotStride(int slotSize);
+
+   /**
+    * Accessor to get the slot by position
+    * @param position - write or read position
+    * @returns - slot header, followed by its data
+    */
+   SlotHeader* GetSlot(boost::uint64_t position) const;
+
+   /// ring header in shared memory
+   Header*           m_header;
+   /// first slot in shared memory
+   char*             m_slots;
+   /// cached header values, the shared ones can be corrupted by the other side
+   boost::uint32_t   m_slotCount;
+   int               m_slotSize;
+   size_t            m_slotStride;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_SLOT_RING_H
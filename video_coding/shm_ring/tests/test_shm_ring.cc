@@ -0,0 +1,296 @@
+#include <video_coding/interface/shm_ring.h>
+#include <video_coding/interface/jitter_buffer.h>
+#include <video_coding/jitter_buffer/tests/stubs/stub_decoder.h>
+#include <logger/logger.h>
+// third-party
+#include <string>
+#include <sstream>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+namespace
+{
+
+/// wait limit which is never reached in a passing test (microseconds)
+const video_coding::TimeUs LongTimeout = 5000000;
+
+/**
+ * Helper routine to make ring name unique for the test process, so that parallel
+ * runs do not interfere
+ * @param suffix - name of the ring within the test
+ * @returns - shared memory object name
+ */
+std::string MakeRingName(const char* suffix)
+{
+   std::ostringstream name;
+   name << "/shm_ring_test_" << ::getpid() << "_" << suffix;
+   return name.str();
+}
+
+/**
+ * Helper routine to read the next frame as a string
+ * @param reader - reader to read from
+ * @returns - frame data, empty string if no frame arrived in time
+ */
+std::string ReadFrame(video_coding::IShmFrameReader& reader)
+{
+   video_coding::ShmFrame frame;
+   if (reader.AcquireFrame(frame, LongTimeout) != result_code::sOk)
+      return std::string();
+   std::string data(frame.data, frame.length);
+   reader.ReleaseFrame();
+   return data;
+}
+
+/**
+ * Helper routine to be run in a separate thread: waits for the frame
+ * @param reader - reader to wait on
+ * @param result - out parameter, result of the wait
+ */
+void WaitForFrame(video_coding::IShmFrameReader* reader, result_t* result)
+{
+   video_coding::ShmFrame frame;
+   *result = reader->AcquireFrame(frame, LongTimeout);
+}
+
+/**
+ * Helper routine to wait until the ingest passes given number of packets to JB
+ * @param ingest - ingest to wait on
+ * @param count - number of packets
+ * @returns - true if packets are received in time
+ */
+bool WaitForPackets(video_coding::IShmIngest& ingest, const boost::uint64_t count)
+{
+   for (video_coding::TimeUs waited = 0; waited < LongTimeout; waited += 1000)
+   {
+      if (ingest.GetStatistics().receivedPackets >= count)
+         return true;
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+   }
+   return false;
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+namespace test
+{
+
+/*
+ @about Check JitterBuffer decodes frames right into ring slots and the reader maps
+ them in order
+ */
+TEST(ShmRing, JitterBuffer_DecodesIntoRing)
+{
+   logger::Log::SetLogLevel(logger::Warning);
+   boost::shared_ptr<IShmRenderer> renderer =
+         CreateShmRenderer(MakeRingName("decode"), 4, DecoderMaxOutputSize);
+   boost::shared_ptr<IShmFrameReader> reader = OpenShmFrameReader(MakeRingName("decode"));
+   StubDecoder decoder;
+   {
+      boost::shared_ptr<IJitterBuffer> jitterBuffer = CreateJitterBuffer(&decoder, renderer.get());
+      jitterBuffer->ReceivePacket("frame1", 6, 1, 0, 1);
+      jitterBuffer->ReceivePacket("fra", 3, 0, 0, 2);
+      jitterBuffer->ReceivePacket("me0", 3, 0, 1, 2);
+      jitterBuffer->Flush();
+   }
+
+   ShmFrame frame;
+   ASSERT_TRUE(reader->TryAcquireFrame(frame));
+   ASSERT_EQ(std::string("frame0"), std::string(frame.data, frame.length));
+   ASSERT_EQ(0u, frame.sequence);
+   reader->ReleaseFrame();
+   ASSERT_EQ(std::string("frame1"), ReadFrame(*reader));
+
+   ShmRingStatistics statistics = reader->GetStatistics();
+   ASSERT_EQ(2u, statistics.publishedFrames);
+   ASSERT_EQ(0u, statistics.copiedFrames);
+   ASSERT_EQ(2u, statistics.releasedFrames);
+}
+
+/*
+ @about Check frames are copied if they are rendered from a foreign buffer, and
+ dropped without blocking if the ring is full or the frame doesn't fit the slot
+ */
+TEST(ShmRing, RenderFrame_CopiesAndDropsWhenFull)
+{
+   boost::shared_ptr<IShmRenderer> renderer = CreateShmRenderer(MakeRingName("full"), 2, 4);
+   boost::shared_ptr<IShmFrameReader> reader = OpenShmFrameReader(MakeRingName("full"));
+
+   ASSERT_EQ(0, renderer->GetFrameBuffer(5));
+   renderer->RenderFrame("a", 1);
+   renderer->RenderFrame("toolong", 7);
+   renderer->RenderFrame("b", 1);
+   ASSERT_EQ(0, renderer->GetFrameBuffer(1));
+   renderer->RenderFrame("c", 1);
+
+   ASSERT_EQ(std::string("a"), ReadFrame(*reader));
+   renderer->RenderFrame("d", 1);
+   ASSERT_EQ(std::string("b"), ReadFrame(*reader));
+   ASSERT_EQ(std::string("d"), ReadFrame(*reader));
+
+   ShmRingStatistics statistics = renderer->GetStatistics();
+   ASSERT_EQ(3u, statistics.publishedFrames);
+   ASSERT_EQ(3u, statistics.copiedFrames);
+   ASSERT_EQ(2u, statistics.droppedFrames);
+
+   ASSERT_THROW(CreateShmRenderer(MakeRingName("invalid"), 0, 4), std::exception);
+   ASSERT_THROW(OpenShmFrameReader(MakeRingName("missing")), std::exception);
+}
+
+/*
+ @about Check waiting reader is woken up by the frame and by renderer destruction,
+ and gives up on timeout
+ */
+TEST(ShmRing, AcquireFrame_WakesUpOnPublish)
+{
+   boost::shared_ptr<IShmRenderer> renderer = CreateShmRenderer(MakeRingName("wait"), 2, 16);
+   boost::shared_ptr<IShmFrameReader> reader = OpenShmFrameReader(MakeRingName("wait"));
+
+   ShmFrame frame;
+   ASSERT_EQ(result_code::eNotReady, reader->AcquireFrame(frame, 1000));
+
+   result_t result = result_code::eUnexpected;
+   boost::thread waiter(boost::bind(&WaitForFrame, reader.get(), &result));
+   boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+   renderer->RenderFrame("x", 1);
+   waiter.join();
+   ASSERT_EQ(result_code::sOk, result);
+   reader->ReleaseFrame();
+
+   boost::thread closeWaiter(boost::bind(&WaitForFrame, reader.get(), &result));
+   boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+   renderer.reset();
+   closeWaiter.join();
+   ASSERT_EQ(result_code::eFail, result);
+}
+
+/*
+ @about Check frames pass to the reader in another process
+ */
+TEST(ShmRing, Reader_InAnotherProcess)
+{
+   const int FrameCount = 100;
+   // name is made by the parent, as it depends on process id
+   const std::string name = MakeRingName("process");
+   boost::shared_ptr<IShmRenderer> renderer = CreateShmRenderer(name, 8, 64);
+
+   pid_t child = ::fork();
+   ASSERT_NE(-1, child);
+   if (child == 0)
+   {
+      // reader process: checks every frame arrives intact and in order
+      int status = 0;
+      try
+      {
+         boost::shared_ptr<IShmFrameReader> reader = OpenShmFrameReader(name);
+         for (int i = 0; i < FrameCount && status == 0; ++i)
+         {
+            std::ostringstream expected;
+            expected << "frame" << i;
+            if (ReadFrame(*reader) != expected.str())
+               status = 1;
+         }
+      }
+      catch (const std::exception&)
+      {
+         status = 2;
+      }
+      ::_exit(status);
+   }
+
+   int status = -1;
+   pid_t finished = 0;
+   for (int i = 0; i < FrameCount && !finished; ++i)
+   {
+      std::ostringstream data;
+      data << "frame" << i;
+      // the ring is small, wait for the reader to keep up instead of dropping
+      while (!renderer->GetFrameBuffer(64) && !(finished = ::waitpid(child, &status, WNOHANG)))
+         boost::this_thread::sleep_for(boost::chrono::microseconds(100));
+      renderer->RenderFrame(data.str().c_str(), (int)data.str().size());
+   }
+
+   if (!finished)
+      finished = ::waitpid(child, &status, 0);
+   ASSERT_EQ(child, finished);
+   ASSERT_TRUE(WIFEXITED(status));
+   ASSERT_EQ(0, WEXITSTATUS(status));
+   ASSERT_EQ((boost::uint64_t)FrameCount, renderer->GetStatistics().releasedFrames);
+}
+
+/*
+ @about Check packets written to the packet ring reach JitterBuffer in another thread,
+ both copied and received right into the slot, and malformed ones are rejected
+ */
+TEST(ShmRing, Ingest_PassesPacketsToJitterBuffer)
+{
+   boost::shared_ptr<IShmPacketWriter> writer =
+         CreateShmPacketWriter(MakeRingName("ingest"), 8, 64);
+   boost::shared_ptr<IShmRenderer> renderer =
+         CreateShmRenderer(MakeRingName("ingest_output"), 4, DecoderMaxOutputSize);
+   boost::shared_ptr<IShmFrameReader> reader = OpenShmFrameReader(MakeRingName("ingest_output"));
+   StubDecoder decoder;
+   boost::shared_ptr<IJitterBuffer> jitterBuffer = CreateJitterBuffer(&decoder, renderer.get());
+   boost::shared_ptr<IShmIngest> ingest = CreateShmIngest(MakeRingName("ingest"), jitterBuffer.get());
+
+   FrameInfo info;
+   info.type = KeyFrame;
+   ASSERT_EQ(result_code::sOk, writer->WritePacket("fra", 3, 0, 0, 2, info));
+   char* buffer = writer->GetPacketBuffer();
+   ASSERT_TRUE(buffer != 0);
+   ::memcpy(buffer, "me0", 3);
+   ASSERT_EQ(result_code::sOk, writer->WritePacket(buffer, 3, 0, 1, 2, info));
+   // fragment number out of the frame is rejected by JB
+   ASSERT_EQ(result_code::sOk, writer->WritePacket("bad", 3, 1, 2, 2, FrameInfo()));
+   FrameInfo invalidInfo;
+   invalidInfo.type = static_cast<FrameType>(7);
+   ASSERT_EQ(result_code::sOk, writer->WritePacket("bad", 3, 1, 0, 1, invalidInfo));
+   ASSERT_EQ(result_code::sOk, writer->WritePacket("frame1", 6, 1, 0, 1, FrameInfo()));
+
+   ASSERT_EQ(std::string("frame0"), ReadFrame(*reader));
+   ASSERT_EQ(std::string("frame1"), ReadFrame(*reader));
+   ASSERT_TRUE(WaitForPackets(*ingest, 5));
+
+   ShmIngestStatistics statistics = ingest->GetStatistics();
+   ASSERT_EQ(5u, statistics.publishedPackets);
+   ASSERT_EQ(0u, statistics.droppedPackets);
+   ASSERT_EQ(2u, statistics.rejectedPackets);
+   ASSERT_EQ(5u, writer->GetStatistics().receivedPackets);
+}
+
+/*
+ @about Check writer drops packets without blocking if the ring is full, rejects
+ packets which don't fit the slot, and ingest can't be attached to a wrong ring
+ */
+TEST(ShmRing, PacketWriter_DropsWhenFull)
+{
+   boost::shared_ptr<IShmPacketWriter> writer = CreateShmPacketWriter(MakeRingName("packets"), 2, 4);
+   ASSERT_EQ(4, writer->GetMaxPacketSize());
+
+   ASSERT_EQ(result_code::eInvalidArgument, writer->WritePacket("toolong", 7, 0, 0, 1, FrameInfo()));
+   ASSERT_EQ(result_code::sOk, writer->WritePacket("a", 1, 0, 0, 1, FrameInfo()));
+   ASSERT_EQ(result_code::sOk, writer->WritePacket("b", 1, 1, 0, 1, FrameInfo()));
+   ASSERT_EQ(0, writer->GetPacketBuffer());
+   ASSERT_EQ(result_code::eOutOfSpace, writer->WritePacket("c", 1, 2, 0, 1, FrameInfo()));
+
+   ShmIngestStatistics statistics = writer->GetStatistics();
+   ASSERT_EQ(2u, statistics.publishedPackets);
+   ASSERT_EQ(1u, statistics.droppedPackets);
+   ASSERT_EQ(0u, statistics.receivedPackets);
+
+   StubDecoder decoder;
+   boost::shared_ptr<IShmRenderer> renderer = CreateShmRenderer(MakeRingName("frames"), 2, 4);
+   boost::shared_ptr<IJitterBuffer> jitterBuffer = CreateJitterBuffer(&decoder, renderer.get());
+   ASSERT_THROW(CreateShmPacketWriter(MakeRingName("invalid"), 2, 0), std::exception);
+   ASSERT_THROW(CreateShmIngest(MakeRingName("packets"), 0), std::exception);
+   ASSERT_THROW(CreateShmIngest(MakeRingName("frames"), jitterBuffer.get()), std::exception);
+}
+
+} // namespace test
+} // namespace video_coding
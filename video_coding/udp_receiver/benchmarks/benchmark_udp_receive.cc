@@ -0,0 +1,286 @@
+/**
+ *  @file
+ *  \brief     UDP receive benchmark
+ *  \details   Compares packet rate of the UDP receive frontend, which takes datagrams in
+ *             batches, with a loop receiving one datagram per system call. Both feed
+ *             JitterBuffer from their own thread. Datagrams are sent over loopback in
+ *             bursts which fit the socket buffer, the next burst is sent once the
+ *             previous one is received and decoded, so nothing is lost on the way
+ *             and JB never gets full.
+ *             Usage: benchmark_udp_receive [<datagrams> [<payload size> [<burst>]]]
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/interface/udp_receiver.h>
+#include <video_coding/interface/jitter_buffer.h>
+#include <video_engine/interface/decoder.h>
+#include <video_engine/interface/renderer.h>
+#include <logger/logger.h>
+// third-party
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+namespace
+{
+
+typedef boost::chrono::steady_clock Clock;
+
+/// time without progress after which the rest of a burst is considered lost
+const boost::chrono::milliseconds LossTimeout(500);
+
+/**
+ * Decoder which produces nothing, so that JB cost stays small
+ */
+class NullDecoder : public video_engine::IDecoder
+{
+public:
+   virtual int DecodeFrame(const char*, int, char*)
+   {
+      return 0;
+   }
+};
+
+/**
+ * Renderer which drops frames
+ */
+class NullRenderer : public video_engine::IRenderer
+{
+public:
+   virtual void RenderFrame(const char*, int)
+   {}
+};
+
+/**
+ * Helper routine to create socket bound to a free loopback port
+ * @param port - out parameter, the port
+ * @returns - socket descriptor
+ */
+int BindLoopback(int& port)
+{
+   int descriptor = ::socket(AF_INET, SOCK_DGRAM, 0);
+   sockaddr_in local;
+   ::memset(&local, 0, sizeof(local));
+   local.sin_family = AF_INET;
+   local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   ::bind(descriptor, reinterpret_cast<sockaddr*>(&local), sizeof(local));
+   socklen_t length = sizeof(local);
+   ::getsockname(descriptor, reinterpret_cast<sockaddr*>(&local), &length);
+   port = ntohs(local.sin_port);
+   return descriptor;
+}
+
+/**
+ * Receive loop doing what most integrations do: one system call per datagram
+ */
+class PerPacketReceiver
+{
+public:
+   PerPacketReceiver(video_coding::IJitterBuffer* jitterBuffer, int maxDatagramSize)
+      : m_jitterBuffer(jitterBuffer)
+      , m_descriptor(BindLoopback(m_port))
+      , m_buffer(maxDatagramSize)
+      , m_datagrams(0)
+      , m_rejectedDatagrams(0)
+      , m_stopRequested(false)
+   {
+      m_thread = boost::thread(boost::bind(&PerPacketReceiver::Receive, this));
+   }
+
+   ~PerPacketReceiver()
+   {
+      m_stopRequested = true;
+      m_thread.join();
+      ::close(m_descriptor);
+   }
+
+   int GetPort() const
+   {
+      return m_port;
+   }
+
+   boost::uint64_t GetDatagrams() const
+   {
+      return m_datagrams.load(boost::memory_order_relaxed);
+   }
+
+   boost::uint64_t GetRejectedDatagrams() const
+   {
+      return m_rejectedDatagrams.load(boost::memory_order_relaxed);
+   }
+
+private:
+   void Receive()
+   {
+      pollfd descriptor;
+      descriptor.fd = m_descriptor;
+      descriptor.events = POLLIN;
+      while (!m_stopRequested)
+      {
+         if (::poll(&descriptor, 1, 10) <= 0)
+            continue;
+         ssize_t length;
+         while ((length = ::recvfrom(m_descriptor, &m_buffer[0], m_buffer.size(), MSG_DONTWAIT, 0, 0)) >=
+                video_coding::UdpFragmentHeaderSize)
+         {
+            const unsigned char* header = reinterpret_cast<const unsigned char*>(&m_buffer[0]);
+            result_t result = m_jitterBuffer->TryReceivePacket(
+               &m_buffer[video_coding::UdpFragmentHeaderSize],
+               (int)length - video_coding::UdpFragmentHeaderSize,
+               (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3],
+               (header[4] << 8) | header[5],
+               (header[6] << 8) | header[7]);
+            if (result != result_code::sOk)
+               m_rejectedDatagrams.fetch_add(1, boost::memory_order_relaxed);
+            m_datagrams.fetch_add(1, boost::memory_order_relaxed);
+         }
+      }
+   }
+
+   video_coding::IJitterBuffer*     m_jitterBuffer;
+   int                              m_port;
+   int                              m_descriptor;
+   std::vector<char>                m_buffer;
+   boost::atomic<boost::uint64_t>   m_datagrams;
+   boost::atomic<boost::uint64_t>   m_rejectedDatagrams;
+   boost::atomic<bool>              m_stopRequested;
+   boost::thread                    m_thread;
+};
+
+boost::uint64_t GetFrontendDatagrams(const video_coding::IUdpReceiver* receiver)
+{
+   return receiver->GetStatistics().datagrams;
+}
+
+/**
+ * Sends datagrams to the receiver and prints results
+ * @param name - variant name to print
+ * @param jitterBuffer - JB fed by the receiver
+ * @param port - receiver port
+ * @param received - returns number of datagrams taken by the receiver so far
+ * @param datagramCount - number of datagrams to send
+ * @param payloadSize - payload size of every datagram
+ * @param burst - number of datagrams sent without waiting for the receiver, must not
+ *        exceed JB capacity
+ */
+void Run(
+   const char* name,
+   video_coding::IJitterBuffer& jitterBuffer,
+   const int port,
+   const boost::function<boost::uint64_t ()>& received,
+   const int datagramCount,
+   const int payloadSize,
+   const int burst)
+{
+   int sourcePort;
+   int descriptor = BindLoopback(sourcePort);
+   sockaddr_in remote;
+   ::memset(&remote, 0, sizeof(remote));
+   remote.sin_family = AF_INET;
+   remote.sin_port = htons((unsigned short)port);
+   remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   ::connect(descriptor, reinterpret_cast<sockaddr*>(&remote), sizeof(remote));
+
+   std::vector<char> datagram(video_coding::UdpFragmentHeaderSize + payloadSize, 'x');
+   boost::uint64_t sent = 0;
+   boost::uint64_t lost = 0;
+   Clock::time_point start = Clock::now();
+   for (int frameNumber = 0; frameNumber < datagramCount; )
+   {
+      for (int i = 0; i < burst && frameNumber < datagramCount; ++i, ++frameNumber, ++sent)
+      {
+         video_coding::WriteUdpFragmentHeader(&datagram[0], frameNumber, 0, 1);
+         ::send(descriptor, &datagram[0], datagram.size(), 0);
+      }
+
+      boost::uint64_t last = received();
+      Clock::time_point progress = Clock::now();
+      while (last + lost < sent)
+      {
+         boost::this_thread::yield();
+         boost::uint64_t current = received();
+         if (current != last)
+         {
+            last = current;
+            progress = Clock::now();
+         }
+         else if (Clock::now() - progress > LossTimeout)
+            lost = sent - last;
+      }
+      jitterBuffer.Flush();
+   }
+   const double elapsed =
+         boost::chrono::duration<double, boost::nano>(Clock::now() - start).count();
+   ::close(descriptor);
+
+   std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+         << std::setprecision(1)
+         << std::setw(16) << elapsed / datagramCount
+         << std::setw(16) << datagramCount / elapsed * 1e9
+         << std::setw(12) << lost;
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+   const int datagramCount = argc > 1 ? ::atoi(argv[1]) : 200000;
+   const int payloadSize = argc > 2 ? ::atoi(argv[2]) : 1200;
+   const int burst = argc > 3 ? ::atoi(argv[3]) : 64;
+   if (datagramCount <= 0 || payloadSize <= 0 || payloadSize > 2000 || burst <= 0 || burst > 100)
+   {
+      std::cerr << "Usage: " << argv[0] << " [<datagrams> [<payload size> [<burst>]]]" << std::endl;
+      return 1;
+   }
+
+   // debug records of every fragment would dominate the measurement
+   logger::Log::SetLogLevel(logger::Warning);
+
+   std::cout << datagramCount << " datagrams of " << payloadSize << " bytes, bursts of "
+         << burst << std::endl;
+   std::cout << std::left << std::setw(12) << "receive" << std::right
+         << std::setw(16) << "ns/datagram" << std::setw(16) << "datagrams/s"
+         << std::setw(12) << "lost" << std::setw(12) << "rejected" << std::endl;
+
+   video_coding::UdpReceiverOptions options;
+   options.address = "127.0.0.1";
+   {
+      NullDecoder decoder;
+      NullRenderer renderer;
+      boost::shared_ptr<video_coding::IJitterBuffer> jitterBuffer =
+            video_coding::CreateJitterBuffer(&decoder, &renderer);
+      PerPacketReceiver receiver(jitterBuffer.get(), options.maxDatagramSize);
+      Run("recvfrom", *jitterBuffer, receiver.GetPort(),
+            boost::bind(&PerPacketReceiver::GetDatagrams, &receiver),
+            datagramCount, payloadSize, burst);
+      std::cout << std::setw(12) << receiver.GetRejectedDatagrams() << std::endl;
+   }
+   {
+      NullDecoder decoder;
+      NullRenderer renderer;
+      boost::shared_ptr<video_coding::IJitterBuffer> jitterBuffer =
+            video_coding::CreateJitterBuffer(&decoder, &renderer);
+      boost::shared_ptr<video_coding::IUdpReceiver> receiver =
+            video_coding::CreateUdpReceiver(jitterBuffer.get(), options);
+      Run("recvmmsg", *jitterBuffer, receiver->GetPort(), boost::bind(&GetFrontendDatagrams, receiver.get()),
+            datagramCount, payloadSize, burst);
+      video_coding::UdpReceiverStatistics statistics = receiver->GetStatistics();
+      std::cout << std::setw(12) << statistics.rejectedDatagrams << std::endl;
+      std::cout << "frontend took " << statistics.datagrams << " datagrams by "
+            << statistics.batches << " receive calls" << std::endl;
+   }
+   return 0;
+}
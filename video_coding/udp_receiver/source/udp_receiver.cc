@@ -0,0 +1,60 @@
+/**
+ *  @file
+ *  \brief     UDP receive frontend factory implementation
+ *  \details   Holds implementation of the factory method and helpers of the UDP receive
+ *             frontend
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include <video_coding/interface/udp_receiver.h>
+#include "udp_receiver_impl.h"
+#include <common/exception_dispatcher.h>
+
+namespace video_coding
+{
+
+void WriteUdpFragmentHeader(
+   char* buffer,
+   const int frameNumber,
+   const int fragmentNumber,
+   const int numFragmentsInThisFrame)
+{
+   buffer[0] = (char)(frameNumber >> 24);
+   buffer[1] = (char)(frameNumber >> 16);
+   buffer[2] = (char)(frameNumber >> 8);
+   buffer[3] = (char)frameNumber;
+   buffer[4] = (char)(fragmentNumber >> 8);
+   buffer[5] = (char)fragmentNumber;
+   buffer[6] = (char)(numFragmentsInThisFrame >> 8);
+   buffer[7] = (char)numFragmentsInThisFrame;
+}
+
+UdpReceiverOptions::UdpReceiverOptions()
+   : address("0.0.0.0")
+   , port(0)
+   , batchSize(32)
+   , maxDatagramSize(2048)
+   , enableGro(true)
+   , receiveBufferSize(0)
+{}
+
+UdpReceiverStatistics::UdpReceiverStatistics()
+   : datagrams(0)
+   , batches(0)
+   , coalescedDatagrams(0)
+   , malformedDatagrams(0)
+   , rejectedDatagrams(0)
+{}
+
+boost::shared_ptr<IUdpReceiver> CreateUdpReceiver(
+   IJitterBuffer* jitterBuffer,
+   const UdpReceiverOptions& options)
+{
+   CHECK_ARGUMENT(jitterBuffer != 0, "Jitter buffer is zero!");
+   boost::shared_ptr<IUdpReceiver> receiver;
+   receiver.reset( new UdpReceiverImpl(jitterBuffer, options) );
+   return receiver;
+}
+
+} // namespace video_coding
@@ -0,0 +1,224 @@
+/**
+ *  @file
+ *  \brief     UdpReceiverImpl class implementation
+ *  \details   Holds implementation of the IUdpReceiver interface
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "udp_receiver_impl.h"
+#include <video_coding/interface/jitter_buffer.h>
+#include <common/exception_dispatcher.h>
+// third-party
+#include <string.h>
+#include <poll.h>
+#include <algorithm>
+#include <boost/bind.hpp>
+
+namespace
+{
+
+/// how often the receive thread checks for the stop request while the socket is idle
+/// (milliseconds)
+const int StopCheckInterval = 10;
+
+/// the largest buffer the kernel fills with coalesced datagrams
+const int MaxCoalescedSize = 65535;
+
+#ifdef __linux__
+/// size of the control buffer which receives the GRO segment size
+const size_t ControlSize = CMSG_SPACE(sizeof(int));
+#endif
+
+/**
+ * Helper routine to read big-endian value from the fragment header
+ * @param data - first byte of the value
+ * @param size - value size (bytes)
+ * @returns - the value
+ */
+boost::uint32_t ReadBigEndian(const char* data, const int size)
+{
+   boost::uint32_t value = 0;
+   for (int i = 0; i < size; ++i)
+      value = (value << 8) | (unsigned char)data[i];
+   return value;
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+
+UdpReceiverImpl::UdpReceiverImpl(IJitterBuffer* jitterBuffer, const UdpReceiverOptions& options)
+   : m_jitterBuffer(jitterBuffer)
+   , m_socket(options.address, options.port, options.receiveBufferSize)
+   , m_groEnabled(options.enableGro && m_socket.EnableGro())
+   , m_batchSize(options.batchSize)
+   , m_bufferSize(m_groEnabled ? MaxCoalescedSize : options.maxDatagramSize)
+   , m_datagrams(0)
+   , m_batches(0)
+   , m_coalescedDatagrams(0)
+   , m_malformedDatagrams(0)
+   , m_rejectedDatagrams(0)
+   , m_stopRequested(false)
+{
+   CHECK_ARGUMENT(options.batchSize > 0, "Invalid batch size " << options.batchSize);
+   CHECK_ARGUMENT(options.maxDatagramSize > UdpFragmentHeaderSize &&
+         options.maxDatagramSize <= MaxCoalescedSize,
+         "Invalid datagram size " << options.maxDatagramSize);
+
+   m_buffers.reset(new char[(size_t)m_batchSize * m_bufferSize]);
+#ifdef __linux__
+   m_messages.resize(m_batchSize);
+   m_vectors.resize(m_batchSize);
+   m_control.reset(new char[m_batchSize * ControlSize]);
+   ::memset(&m_messages[0], 0, m_messages.size() * sizeof(mmsghdr));
+   for (int i = 0; i < m_batchSize; ++i)
+   {
+      m_vectors[i].iov_base = m_buffers.get() + (size_t)i * m_bufferSize;
+      m_vectors[i].iov_len = m_bufferSize;
+      m_messages[i].msg_hdr.msg_iov = &m_vectors[i];
+      m_messages[i].msg_hdr.msg_iovlen = 1;
+      if (m_groEnabled)
+         m_messages[i].msg_hdr.msg_control = m_control.get() + i * ControlSize;
+   }
+#endif
+
+   // started once the buffers are set up
+   m_thread = boost::thread(boost::bind(&UdpReceiverImpl::ReceiveDatagrams, this));
+}
+
+UdpReceiverImpl::~UdpReceiverImpl()
+{
+   m_stopRequested.store(true, boost::memory_order_relaxed);
+   m_thread.join();
+}
+
+int UdpReceiverImpl::GetPort() const
+{
+   return m_socket.GetPort();
+}
+
+bool UdpReceiverImpl::IsGroEnabled() const
+{
+   return m_groEnabled;
+}
+
+UdpReceiverStatistics UdpReceiverImpl::GetStatistics() const
+{
+   UdpReceiverStatistics statistics;
+   statistics.datagrams = m_datagrams.load(boost::memory_order_relaxed);
+   statistics.batches = m_batches.load(boost::memory_order_relaxed);
+   statistics.coalescedDatagrams = m_coalescedDatagrams.load(boost::memory_order_relaxed);
+   statistics.malformedDatagrams = m_malformedDatagrams.load(boost::memory_order_relaxed);
+   statistics.rejectedDatagrams = m_rejectedDatagrams.load(boost::memory_order_relaxed);
+   return statistics;
+}
+
+void UdpReceiverImpl::ReceiveDatagrams()
+{
+   pollfd descriptor;
+   descriptor.fd = m_socket.GetDescriptor();
+   descriptor.events = POLLIN;
+   while (!m_stopRequested.load(boost::memory_order_relaxed))
+   {
+      descriptor.revents = 0;
+      if (::poll(&descriptor, 1, StopCheckInterval) <= 0)
+         continue;
+      // a full batch means more datagrams may be pending
+      while (ReceiveBatch() == m_batchSize)
+         ;
+   }
+}
+
+#ifdef __linux__
+int UdpReceiverImpl::ReceiveBatch()
+{
+   if (m_groEnabled)
+   {
+      // kernel overwrites the control length with the length it used
+      for (int i = 0; i < m_batchSize; ++i)
+         m_messages[i].msg_hdr.msg_controllen = ControlSize;
+   }
+
+   int count = ::recvmmsg(m_socket.GetDescriptor(), &m_messages[0], m_batchSize, MSG_DONTWAIT, 0);
+   if (count <= 0)
+      return 0;
+   m_batches.fetch_add(1, boost::memory_order_relaxed);
+
+   for (int i = 0; i < count; ++i)
+   {
+      msghdr& message = m_messages[i].msg_hdr;
+      if (message.msg_flags & MSG_TRUNC)
+      {
+         m_datagrams.fetch_add(1, boost::memory_order_relaxed);
+         m_malformedDatagrams.fetch_add(1, boost::memory_order_relaxed);
+         continue;
+      }
+
+      int segmentSize = 0;
+      for (cmsghdr* control = m_groEnabled ? CMSG_FIRSTHDR(&message) : 0; control;
+           control = CMSG_NXTHDR(&message, control))
+      {
+         if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO)
+            ::memcpy(&segmentSize, CMSG_DATA(control), sizeof(segmentSize));
+      }
+      ProcessBuffer(static_cast<const char*>(m_vectors[i].iov_base),
+            (int)m_messages[i].msg_len, segmentSize);
+   }
+   return count;
+}
+#else
+int UdpReceiverImpl::ReceiveBatch()
+{
+   // no batch receive call, the batch is taken datagram by datagram
+   int count = 0;
+   for (; count < m_batchSize; ++count)
+   {
+      char* buffer = m_buffers.get() + (size_t)count * m_bufferSize;
+      ssize_t length = ::recv(m_socket.GetDescriptor(), buffer, m_bufferSize, MSG_DONTWAIT);
+      if (length < 0)
+         break;
+      ProcessBuffer(buffer, (int)length, 0);
+   }
+   if (count)
+      m_batches.fetch_add(1, boost::memory_order_relaxed);
+   return count;
+}
+#endif
+
+void UdpReceiverImpl::ProcessBuffer(const char* buffer, const int length, const int segmentSize)
+{
+   if (segmentSize <= 0 || segmentSize >= length)
+   {
+      ProcessDatagram(buffer, length);
+      return;
+   }
+
+   int count = 0;
+   for (int offset = 0; offset < length; offset += segmentSize, ++count)
+      ProcessDatagram(buffer + offset, std::min(segmentSize, length - offset));
+   m_coalescedDatagrams.fetch_add(count, boost::memory_order_relaxed);
+}
+
+void UdpReceiverImpl::ProcessDatagram(const char* datagram, const int length)
+{
+   m_datagrams.fetch_add(1, boost::memory_order_relaxed);
+   if (length < UdpFragmentHeaderSize)
+   {
+      m_malformedDatagrams.fetch_add(1, boost::memory_order_relaxed);
+      return;
+   }
+
+   // out of range values are rejected by JB
+   result_t result = m_jitterBuffer->TryReceivePacket(
+      datagram + UdpFragmentHeaderSize,
+      length - UdpFragmentHeaderSize,
+      (int)ReadBigEndian(datagram, 4),
+      (int)ReadBigEndian(datagram + 4, 2),
+      (int)ReadBigEndian(datagram + 6, 2));
+   if (result != result_code::sOk)
+      m_rejectedDatagrams.fetch_add(1, boost::memory_order_relaxed);
+}
+
+} // namespace video_coding
@@ -0,0 +1,135 @@
+/**
+ *  @file
+ *  \brief     UdpReceiverImpl class declaration
+ *  \details   Holds declaration of the IUdpReceiver interface implementation
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_UDP_RECEIVER_IMPL_H
+#define VIDEO_CODING_UDP_RECEIVER_IMPL_H
+
+#include <video_coding/interface/udp_receiver.h>
+#include "udp_socket.h"
+// third-party
+#include <vector>
+#include <sys/socket.h>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
+namespace video_coding
+{
+
+/**
+ * UdpReceiverImpl class
+ * Implements interface IUdpReceiver. Datagrams are received into a pool of buffers
+ * allocated once, one buffer per datagram of the batch, and JB copies the payload to
+ * the frame arena, so no allocation happens on the receive path
+ */
+class UdpReceiverImpl
+   : public IUdpReceiver
+   , boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. For more details see CreateUdpReceiver
+    */
+   UdpReceiverImpl(IJitterBuffer* jitterBuffer, const UdpReceiverOptions& options);
+
+   /**
+    * Destructor. Stops the receive thread
+    */
+   ~UdpReceiverImpl();
+
+   /**
+    * IUdpReceiver interface method implementation. For more details see IUdpReceiver
+    * interface.
+    */
+   virtual int GetPort() const;
+
+   /**
+    * IUdpReceiver interface method implementation. For more details see IUdpReceiver
+    * interface.
+    */
+   virtual bool IsGroEnabled() const;
+
+   /**
+    * IUdpReceiver interface method implementation. For more details see IUdpReceiver
+    * interface.
+    */
+   virtual UdpReceiverStatistics GetStatistics() const;
+
+private:
+
+   /**
+    * Receive thread routine. Waits for the socket to become readable and drains it
+    * until stopped
+    */
+   void ReceiveDatagrams();
+
+   /**
+    * Takes the next batch of datagrams from the socket without waiting and passes them
+    * to JB
+    * @returns - number of buffers filled, less than batch size if the socket is drained
+    */
+   int ReceiveBatch();
+
+   /**
+    * Passes the buffer to JB, splitting it into datagrams if it is coalesced
+    * @param buffer - received data
+    * @param length - data length
+    * @param segmentSize - size of a coalesced datagram, zero if not coalesced
+    */
+   void ProcessBuffer(const char* buffer, int length, int segmentSize);
+
+   /**
+    * Parses the fragment header and passes the payload to JB
+    * @param datagram - datagram start
+    * @param length - datagram length
+    */
+   void ProcessDatagram(const char* datagram, int length);
+
+   /// JB receiving the fragments
+   IJitterBuffer*          m_jitterBuffer;
+   /// the socket
+   UdpSocket               m_socket;
+   /// flag, indicates the socket coalesces datagrams
+   const bool              m_groEnabled;
+   /// maximum number of datagrams taken by a single system call
+   const int               m_batchSize;
+   /// size of a single pool buffer
+   const int               m_bufferSize;
+   /// pool of receive buffers, m_batchSize buffers of m_bufferSize bytes
+   boost::scoped_array<char> m_buffers;
+#ifdef __linux__
+   /// recvmmsg message headers, one per pool buffer
+   std::vector<mmsghdr>    m_messages;
+   /// recvmmsg data vectors, one per pool buffer
+   std::vector<iovec>      m_vectors;
+   /// recvmmsg control buffers carrying the GRO segment size, one per pool buffer
+   boost::scoped_array<char> m_control;
+#endif
+
+   /// datagrams received
+   boost::atomic<boost::uint64_t> m_datagrams;
+   /// system calls which returned data
+   boost::atomic<boost::uint64_t> m_batches;
+   /// datagrams which arrived coalesced
+   boost::atomic<boost::uint64_t> m_coalescedDatagrams;
+   /// truncated or too short datagrams
+   boost::atomic<boost::uint64_t> m_malformedDatagrams;
+   /// datagrams rejected by JB
+   boost::atomic<boost::uint64_t> m_rejectedDatagrams;
+
+   /// flag to stop the receive thread
+   boost::atomic<bool>     m_stopRequested;
+   /// the receive thread, started last
+   boost::thread           m_thread;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_UDP_RECEIVER_IMPL_H
@@ -0,0 +1,87 @@
+/**
+ *  @file
+ *  \brief     UdpSocket class implementation
+ *  \details   Holds implementation of the UdpSocket class based on BSD sockets
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#include "udp_socket.h"
+#include <common/exception_dispatcher.h>
+// third-party
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace video_coding
+{
+
+UdpSocket::UdpSocket(const std::string& address, const int port, const int receiveBufferSize)
+   : m_descriptor(-1)
+   , m_port(0)
+{
+   CHECK_ARGUMENT(port >= 0 && port <= 0xFFFF, "Invalid port " << port);
+   CHECK_ARGUMENT(receiveBufferSize >= 0, "Invalid receive buffer size " << receiveBufferSize);
+
+   sockaddr_in local;
+   ::memset(&local, 0, sizeof(local));
+   local.sin_family = AF_INET;
+   local.sin_port = htons((unsigned short)port);
+   CHECK_ARGUMENT(::inet_pton(AF_INET, address.c_str(), &local.sin_addr) == 1,
+         "Invalid IPv4 address " << address);
+
+   m_descriptor = ::socket(AF_INET, SOCK_DGRAM, 0);
+   if (m_descriptor < 0)
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to create socket, error " << errno;
+
+   int error = 0;
+   if (receiveBufferSize > 0 && ::setsockopt(m_descriptor, SOL_SOCKET, SO_RCVBUF,
+         &receiveBufferSize, sizeof(receiveBufferSize)) != 0)
+      error = errno;
+   else if (::bind(m_descriptor, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0)
+      error = errno;
+   else
+   {
+      socklen_t length = sizeof(local);
+      if (::getsockname(m_descriptor, reinterpret_cast<sockaddr*>(&local), &length) != 0)
+         error = errno;
+      m_port = ntohs(local.sin_port);
+   }
+
+   if (error)
+   {
+      ::close(m_descriptor);
+      THROW_BASIC_EXCEPTION(result_code::eFail) << "Unable to bind socket to " << address
+            << ":" << port << ", error " << error;
+   }
+}
+
+UdpSocket::~UdpSocket()
+{
+   ::close(m_descriptor);
+}
+
+int UdpSocket::GetDescriptor() const
+{
+   return m_descriptor;
+}
+
+int UdpSocket::GetPort() const
+{
+   return m_port;
+}
+
+bool UdpSocket::EnableGro()
+{
+#ifdef __linux__
+   int enable = 1;
+   return ::setsockopt(m_descriptor, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0;
+#else
+   return false;
+#endif
+}
+
+} // namespace video_coding
@@ -0,0 +1,73 @@
+/**
+ *  @file
+ *  \brief     UdpSocket class declaration
+ *  \details   Holds declaration of the UdpSocket class
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_CODING_UDP_SOCKET_H
+#define VIDEO_CODING_UDP_SOCKET_H
+
+// third-party
+#include <string>
+#include <boost/noncopyable.hpp>
+#ifdef __linux__
+#include <netinet/udp.h>
+#ifndef UDP_GRO
+#define UDP_GRO 104  // older system headers lack it, the kernel may still support it
+#endif
+#endif
+
+namespace video_coding
+{
+
+/**
+ * UdpSocket class owns a bound IPv4 UDP socket descriptor
+ */
+class UdpSocket : boost::noncopyable
+{
+public:
+
+   /**
+    * Constructor. Creates and binds the socket. Throws std::exception on invalid address
+    * or system error
+    * @param address - IPv4 address in dotted notation
+    * @param port - port, zero means any free port
+    * @param receiveBufferSize - receive buffer size (bytes), zero keeps the default
+    */
+   UdpSocket(const std::string& address, int port, int receiveBufferSize);
+
+   /**
+    * Destructor. Closes the socket
+    */
+   ~UdpSocket();
+
+   /**
+    * Accessor to get the socket descriptor
+    * @returns - descriptor
+    */
+   int GetDescriptor() const;
+
+   /**
+    * Accessor to get the port the socket is bound to
+    * @returns - local port
+    */
+   int GetPort() const;
+
+   /**
+    * Asks the kernel to coalesce datagrams of the same flow (UDP GRO). Does not throw
+    * @returns - true if GRO is supported and enabled
+    */
+   bool EnableGro();
+
+private:
+   /// socket descriptor
+   int         m_descriptor;
+   /// local port
+   int         m_port;
+};
+
+} // namespace video_coding
+
+#endif // VIDEO_CODING_UDP_SOCKET_H
@@ -0,0 +1,182 @@
+#include <video_coding/interface/udp_receiver.h>
+#include <video_coding/interface/jitter_buffer.h>
+#include <video_coding/jitter_buffer/tests/stubs/stub_decoder.h>
+#include <video_coding/jitter_buffer/tests/stubs/stub_renderer.h>
+#include <logger/logger.h>
+// third-party
+#include <string>
+#include <vector>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace
+{
+
+/**
+ * Sending side of the loopback tests
+ */
+class LoopbackSender
+{
+public:
+   explicit LoopbackSender(int port)
+      : m_descriptor(::socket(AF_INET, SOCK_DGRAM, 0))
+   {
+      sockaddr_in remote;
+      ::memset(&remote, 0, sizeof(remote));
+      remote.sin_family = AF_INET;
+      remote.sin_port = htons((unsigned short)port);
+      remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      ::connect(m_descriptor, reinterpret_cast<sockaddr*>(&remote), sizeof(remote));
+   }
+
+   ~LoopbackSender()
+   {
+      ::close(m_descriptor);
+   }
+
+   /**
+    * Sends the fragment as a single datagram
+    */
+   void Send(int frameNumber, int fragmentNumber, int numFragments, const std::string& payload)
+   {
+      std::string datagram = MakeDatagram(frameNumber, fragmentNumber, numFragments, payload);
+      SendRaw(datagram);
+   }
+
+   void SendRaw(const std::string& datagram)
+   {
+      ::send(m_descriptor, datagram.data(), datagram.size(), 0);
+   }
+
+   /**
+    * Sends equally sized datagrams by a single segmentation offload call
+    * @returns - false if the system does not support it
+    */
+   bool SendSegmented(const std::vector<std::string>& datagrams)
+   {
+      int segmentSize = (int)datagrams[0].size();
+      if (::setsockopt(m_descriptor, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize)) != 0)
+         return false;
+      std::string buffer;
+      for (size_t i = 0; i < datagrams.size(); ++i)
+         buffer += datagrams[i];
+      return ::send(m_descriptor, buffer.data(), buffer.size(), 0) == (ssize_t)buffer.size();
+   }
+
+   static std::string MakeDatagram(
+      int frameNumber,
+      int fragmentNumber,
+      int numFragments,
+      const std::string& payload)
+   {
+      char header[video_coding::UdpFragmentHeaderSize];
+      video_coding::WriteUdpFragmentHeader(header, frameNumber, fragmentNumber, numFragments);
+      return std::string(header, sizeof(header)) + payload;
+   }
+
+private:
+   int m_descriptor;
+};
+
+/**
+ * Helper routine to wait until the receiver takes given number of datagrams
+ * @returns - true if datagrams are received in time
+ */
+bool WaitForDatagrams(video_coding::IUdpReceiver& receiver, const boost::uint64_t count)
+{
+   for (int i = 0; i < 5000; ++i)
+   {
+      if (receiver.GetStatistics().datagrams >= count)
+         return true;
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+   }
+   return false;
+}
+
+} // unnamed namespace
+
+namespace video_coding
+{
+namespace test
+{
+
+/*
+ @about Check fragments sent over loopback are passed to JitterBuffer, and malformed or
+ invalid datagrams are counted and dropped
+ */
+TEST(UdpReceiver, Loopback_PassesFragmentsToJitterBuffer)
+{
+   logger::Log::SetLogLevel(logger::Warning);
+   StubDecoder decoder;
+   StubRenderer renderer;
+   boost::shared_ptr<IJitterBuffer> jitterBuffer = CreateJitterBuffer(&decoder, &renderer);
+   UdpReceiverOptions options;
+   options.address = "127.0.0.1";
+   boost::shared_ptr<IUdpReceiver> receiver = CreateUdpReceiver(jitterBuffer.get(), options);
+   ASSERT_NE(0, receiver->GetPort());
+
+   LoopbackSender sender(receiver->GetPort());
+   sender.Send(0, 1, 2, "me0");
+   sender.Send(1, 0, 1, "frame1");
+   sender.SendRaw("short");
+   sender.Send(2, 0, 0, "bad");
+   sender.Send(0, 0, 2, "fra");
+   ASSERT_TRUE(WaitForDatagrams(*receiver, 5));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("frame0frame1"), renderer.GetRenderedData());
+
+   UdpReceiverStatistics statistics = receiver->GetStatistics();
+   ASSERT_EQ(5u, statistics.datagrams);
+   ASSERT_LE(1u, statistics.batches);
+   ASSERT_EQ(1u, statistics.malformedDatagrams);
+   ASSERT_EQ(1u, statistics.rejectedDatagrams);
+
+   ASSERT_THROW(CreateUdpReceiver(0), std::exception);
+   options.port = receiver->GetPort();
+   ASSERT_THROW(CreateUdpReceiver(jitterBuffer.get(), options), std::exception);
+   options.port = 0;
+   options.batchSize = 0;
+   ASSERT_THROW(CreateUdpReceiver(jitterBuffer.get(), options), std::exception);
+}
+
+/*
+ @about Check datagrams coalesced by GRO are split back into fragments
+ */
+TEST(UdpReceiver, Gro_SplitsCoalescedDatagrams)
+{
+   StubDecoder decoder;
+   StubRenderer renderer;
+   boost::shared_ptr<IJitterBuffer> jitterBuffer = CreateJitterBuffer(&decoder, &renderer);
+   UdpReceiverOptions options;
+   options.address = "127.0.0.1";
+   boost::shared_ptr<IUdpReceiver> receiver = CreateUdpReceiver(jitterBuffer.get(), options);
+   if (!receiver->IsGroEnabled())
+      return;
+
+   std::vector<std::string> datagrams;
+   datagrams.push_back(LoopbackSender::MakeDatagram(0, 0, 3, "ab"));
+   datagrams.push_back(LoopbackSender::MakeDatagram(0, 1, 3, "cd"));
+   datagrams.push_back(LoopbackSender::MakeDatagram(0, 2, 3, "e"));
+   LoopbackSender sender(receiver->GetPort());
+   if (!sender.SendSegmented(datagrams))
+      return;
+
+   ASSERT_TRUE(WaitForDatagrams(*receiver, 3));
+   jitterBuffer->Flush();
+   ASSERT_EQ(std::string("abcde"), renderer.GetRenderedData());
+   ASSERT_EQ(3u, receiver->GetStatistics().coalescedDatagrams);
+   ASSERT_EQ(1u, receiver->GetStatistics().batches);
+}
+
+} // namespace test
+} // namespace video_coding
@@ -0,0 +1,39 @@
+/**
+ *  @file
+ *  \brief     video_engine::IBufferedRenderer interface
+ *  \details   Declares IBufferedRenderer interface - extension of IRenderer which provides
+ *             the buffer for decoder output, so that decoded frame is not copied on render
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_ENGINE_BUFFERED_RENDERER_H
+#define VIDEO_ENGINE_BUFFERED_RENDERER_H
+
+#include "renderer.h"
+
+namespace video_engine
+{
+
+class IBufferedRenderer : public IRenderer
+{
+public:
+
+   /**
+    * Provides the buffer for the next decoded frame. Decoder writes its output right
+    * there and RenderFrame is called with the same buffer, then the renderer takes
+    * the frame over without copying. Buffer stays valid until the next RenderFrame or
+    * GetFrameBuffer call, it may be abandoned (frame dropped) without notice.
+    * @param size - minimum size of the buffer
+    * @returns pointer to the buffer, zero if it can't be provided now (the frame is
+    *          then passed to RenderFrame in a buffer of the caller)
+    */
+   virtual char* GetFrameBuffer(int size) = 0;
+
+   ~IBufferedRenderer() {}
+};
+
+
+} // namespace video_engine
+
+#endif // VIDEO_ENGINE_BUFFERED_RENDERER_H
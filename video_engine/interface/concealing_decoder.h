@@ -0,0 +1,46 @@
+/**
+ *  @file
+ *  \brief     video_engine::IConcealingDecoder interface
+ *  \details   Declares IConcealingDecoder interface - extension of IDecoder which is able
+ *             to decode frames with missing fragments and conceal the damage
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_ENGINE_CONCEALING_DECODER_H
+#define VIDEO_ENGINE_CONCEALING_DECODER_H
+
+#include "decoder.h"
+
+namespace video_engine
+{
+
+class IConcealingDecoder : public IDecoder
+{
+public:
+
+   /**
+    * Decodes frame which misses some of its fragments. Returns the size of the data
+    * written to the outputBuffer, will be no more than 1mb.
+    * @param buffer - input frame data, missing fragments are zero-filled
+    * @param length - length of the data to be passed
+    * @param fragmentPresence - one byte per fragment, non-zero if fragment is received
+    * @param fragmentOffsets - offset of every fragment within the buffer
+    * @param numFragments - number of fragments in the frame
+    * @param outputBuffer - pointer to the output data
+    * @returns size of the decoded data
+    */
+   virtual int DecodeIncompleteFrame(const char* buffer,
+      int length,
+      const unsigned char* fragmentPresence,
+      const int* fragmentOffsets,
+      int numFragments,
+      char* outputBuffer) = 0;
+
+   ~IConcealingDecoder() {}
+};
+
+
+} // namespace video_engine
+
+#endif // VIDEO_ENGINE_CONCEALING_DECODER_H
@@ -0,0 +1,49 @@
+/**
+ *  @file
+ *  \brief     video_engine::IStreamingDecoder interface
+ *  \details   Declares IStreamingDecoder interface - extension of IDecoder which accepts
+ *             frame data incrementally, as it arrives from the network
+ *  \author    Dmitry Sinelnikov
+ *  \date      2012
+ */
+
+#ifndef VIDEO_ENGINE_STREAMING_DECODER_H
+#define VIDEO_ENGINE_STREAMING_DECODER_H
+
+#include "decoder.h"
+
+namespace video_engine
+{
+
+class IStreamingDecoder : public IDecoder
+{
+public:
+
+   /**
+    * Passes the next portion of the current frame data. The first call after
+    * FinishFrame or AbortFrame starts a new frame. Portions are contiguous and
+    * come in order, so their concatenation is the whole frame.
+    * @param buffer - frame data portion
+    * @param length - length of the portion
+    */
+   virtual void DecodeFramePart(const char* buffer, int length) = 0;
+
+   /**
+    * Ends the current frame: all its data has been passed by DecodeFramePart.
+    * @param outputBuffer - pointer to the output data
+    * @returns size of the decoded data, will be no more than 1mb
+    */
+   virtual int FinishFrame(char* outputBuffer) = 0;
+
+   /**
+    * Discards the current frame: it will not be completed (dropped by jitter buffer).
+    */
+   virtual void AbortFrame() = 0;
+
+   ~IStreamingDecoder() {}
+};
+
+
+} // namespace video_engine
+
+#endif // VIDEO_ENGINE_STREAMING_DECODER_H